@@ -0,0 +1,88 @@
+#include <PixelConvert.h>
+
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+
+using namespace rdk;
+
+// 8K x 4K RGBA8 texture, same order of magnitude as the ones we load
+static const size_t PIXEL_COUNT = 8192 * 4096;
+static const int ITERATIONS = 5;
+
+static double measure(const std::function<void()>& kernel) {
+    double best = 1e30;
+    for (int i = 0 ; i < ITERATIONS ; i++) {
+        auto begin = std::chrono::steady_clock::now();
+        kernel();
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - begin).count();
+        best = seconds < best ? seconds : best;
+    }
+    return best;
+}
+
+static void report(const char* name, SimdLevel level, size_t pixelCount, double seconds) {
+    printf("%-20s %-8s %10.1f MPix/s\n", name, PixelConvert::getName(level), double(pixelCount) / seconds / 1e6);
+}
+
+int main() {
+    std::vector<u8> rgb(PIXEL_COUNT * 3);
+    std::vector<u8> rgba(PIXEL_COUNT * 4);
+    std::vector<u8> output(PIXEL_COUNT * 4);
+    for (size_t i = 0 ; i < rgba.size() ; i++) {
+        rgba[i] = static_cast<u8>(i * 7 + (i >> 5));
+    }
+    for (size_t i = 0 ; i < rgb.size() ; i++) {
+        rgb[i] = static_cast<u8>(i * 13 + (i >> 3));
+    }
+
+    // float kernels work on a slice, full texture in RGBA32F would not fit caches nor most RAM budgets
+    const size_t floatPixels = PIXEL_COUNT / 8;
+    std::vector<float> linear(floatPixels * 4);
+    std::vector<u16> half(floatPixels * 4);
+
+    const u8 bgra[4] = { 2, 1, 0, 3 };
+
+    std::vector<SimdLevel> levels = { SimdLevel::SCALAR };
+    SimdLevel supported = PixelConvert::getSupportedLevel();
+    if (supported == SimdLevel::AVX2) {
+        levels.push_back(SimdLevel::SSE2);
+    }
+    if (supported != SimdLevel::SCALAR) {
+        levels.push_back(supported);
+    }
+
+    for (SimdLevel level : levels) {
+        PixelConvert::setSimdLevel(level);
+
+        report("expandRGBToRGBA", level, PIXEL_COUNT, measure([&]() {
+            PixelConvert::expandRGBToRGBA(rgb.data(), output.data(), PIXEL_COUNT);
+        }));
+        report("packRGBAToRGB", level, PIXEL_COUNT, measure([&]() {
+            PixelConvert::packRGBAToRGB(rgba.data(), output.data(), PIXEL_COUNT);
+        }));
+        report("swizzleRGBA", level, PIXEL_COUNT, measure([&]() {
+            PixelConvert::swizzleRGBA(rgba.data(), output.data(), PIXEL_COUNT, bgra);
+        }));
+        report("premultiplyAlpha", level, PIXEL_COUNT, measure([&]() {
+            PixelConvert::premultiplyAlpha(rgba.data(), output.data(), PIXEL_COUNT);
+        }));
+        report("srgbToLinear", level, floatPixels, measure([&]() {
+            PixelConvert::srgbToLinear(rgba.data(), linear.data(), floatPixels);
+        }));
+        report("floatToHalf", level, floatPixels, measure([&]() {
+            PixelConvert::floatToHalf(linear.data(), half.data(), floatPixels * 4);
+        }));
+        report("halfToFloat", level, floatPixels, measure([&]() {
+            PixelConvert::halfToFloat(half.data(), linear.data(), floatPixels * 4);
+        }));
+        report("srgbToLinearHalf", level, floatPixels, measure([&]() {
+            PixelConvert::srgbToLinearHalf(rgba.data(), half.data(), floatPixels);
+        }));
+        printf("\n");
+    }
+
+    return 0;
+}
@@ -1,3 +1,7 @@
 %~dp0/vendor/vulkan/Bin/glslc.exe shaders/shader.vert -o spirv/shader_vert.spv
 %~dp0/vendor/vulkan/Bin/glslc.exe shaders/shader.frag -o spirv/shader_frag.spv
+%~dp0/vendor/vulkan/Bin/glslc.exe shaders/downsample.comp -o spirv/downsample_comp.spv
+%~dp0/vendor/vulkan/Bin/glslc.exe shaders/hiz.comp -o spirv/hiz_comp.spv
+%~dp0/vendor/vulkan/Bin/glslc.exe shaders/cull.comp -o spirv/cull_comp.spv
+%~dp0/vendor/vulkan/Bin/glslc.exe shaders/cluster.comp -o spirv/cluster_comp.spv
 pause
\ No newline at end of file
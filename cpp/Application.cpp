@@ -23,11 +23,15 @@ namespace rdk {
         appInfo.appVersion = VK_MAKE_VERSION(1, 0, 0);
         appInfo.engineName = "RectEngine";
         appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-        appInfo.apiVersion = VK_API_VERSION_1_0;
+        // timeline semaphores are core since 1.2
+        appInfo.apiVersion = VK_API_VERSION_1_2;
         m_Renderer = new Renderer(appInfo, m_Window);
         m_Renderer->listener = this;
+#ifdef ASSET_PACK
+        m_Renderer->mountAssetPack("assets.pack");
+#endif
 
-        m_Renderer->addShader("shaders/shader.vert", "shaders/shader.frag");
+        m_Renderer->addShader("shaders/shader.vert", "shaders/shader.frag", { { "UNLIT" } });
 
         // todo initialize render client only after adding all shaders and objects, otherwise it's not working
         m_Renderer->initialize();
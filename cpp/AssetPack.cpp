@@ -0,0 +1,566 @@
+#include <AssetPack.h>
+#include <Lz4.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rdk {
+
+    static const u8 PACK_MAGIC[4] = { 'R', 'D', 'K', 'P' };
+    static const u32 EMPTY_SLOT = UINT32_MAX;
+
+    static std::vector<u8> readFile(const char* filepath) {
+        std::ifstream file(filepath, std::ios::ate | std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error(std::string("AssetPack::readFile: failed to open file ") + filepath);
+        }
+
+        size_t fileSize = (size_t) file.tellg();
+        std::vector<u8> buffer(fileSize);
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(buffer.data()), fileSize);
+
+        file.close();
+
+        return buffer;
+    }
+
+    static std::string normalizeName(const char* filepath) {
+        std::string name(filepath);
+        std::replace(name.begin(), name.end(), '\\', '/');
+        while (name.compare(0, 2, "./") == 0) {
+            name.erase(0, 2);
+        }
+        return name;
+    }
+
+    static u64 alignUp(u64 value, u64 alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    static double secondsSince(std::chrono::steady_clock::time_point begin) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    static void addStats(std::vector<AssetTypeStats>& stats, const std::string& type, u64 storedBytes, u64 rawBytes, double seconds) {
+        auto it = std::lower_bound(stats.begin(), stats.end(), type, [](const AssetTypeStats& typeStats, const std::string& key) {
+            return typeStats.type < key;
+        });
+        if (it == stats.end() || it->type != type) {
+            AssetTypeStats typeStats;
+            typeStats.type = type;
+            it = stats.insert(it, typeStats);
+        }
+        it->count++;
+        it->storedBytes += storedBytes;
+        it->rawBytes += rawBytes;
+        it->seconds += seconds;
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    bool MappedFile::open(const char* filepath) {
+        close();
+#ifdef _WIN32
+        HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            CloseHandle(file);
+            return false;
+        }
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        m_File = file;
+        m_Mapping = mapping;
+        m_Data = static_cast<const u8*>(data);
+        m_Size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fd = ::open(filepath, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat fileStat {};
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        // mapping keeps its own reference to the file
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+        m_Data = static_cast<const u8*>(data);
+        m_Size = static_cast<size_t>(fileStat.st_size);
+#endif
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (m_Data == nullptr) {
+            return;
+        }
+#ifdef _WIN32
+        UnmapViewOfFile(m_Data);
+        CloseHandle(m_Mapping);
+        CloseHandle(m_File);
+        m_Mapping = nullptr;
+        m_File = nullptr;
+#else
+        munmap(const_cast<u8*>(m_Data), m_Size);
+#endif
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+
+    u64 AssetPack::hashName(const char* name, size_t size) {
+        // FNV-1a
+        u64 hash = 14695981039346656037ull;
+        for (size_t i = 0 ; i < size ; i++) {
+            hash ^= static_cast<u8>(name[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    void AssetPack::open(const char* filepath) {
+        close();
+
+        if (!m_File.open(filepath)) {
+            throw std::runtime_error(std::string("AssetPack::open: failed to map file ") + filepath);
+        }
+
+        const u8* data = m_File.getData();
+        const u64 size = m_File.getSize();
+        const auto* header = reinterpret_cast<const PackHeader*>(data);
+
+        // validate everything once, lookups and loads trust the mapping afterwards
+        bool valid = size >= sizeof(PackHeader)
+                && memcmp(header->magic, PACK_MAGIC, sizeof(PACK_MAGIC)) == 0
+                && header->version == VERSION
+                && header->slotCount != 0
+                && (header->slotCount & (header->slotCount - 1)) == 0
+                && header->slotCount > header->entryCount
+                && header->chunkSize != 0
+                && header->entriesOffset % alignof(PackEntry) == 0
+                && header->chunksOffset % alignof(PackChunk) == 0
+                && header->slotsOffset % alignof(u32) == 0
+                && header->entriesOffset <= size
+                && header->entryCount <= (size - header->entriesOffset) / sizeof(PackEntry)
+                && header->chunksOffset <= size
+                && header->chunkCount <= (size - header->chunksOffset) / sizeof(PackChunk)
+                && header->slotsOffset <= size
+                && header->slotCount <= (size - header->slotsOffset) / sizeof(u32)
+                && header->namesOffset <= size
+                && header->namesSize <= size - header->namesOffset;
+        if (!valid) {
+            m_File.close();
+            throw std::runtime_error(std::string("AssetPack::open: invalid pack header in ") + filepath);
+        }
+
+        const auto* entries = reinterpret_cast<const PackEntry*>(data + header->entriesOffset);
+        const auto* chunks = reinterpret_cast<const PackChunk*>(data + header->chunksOffset);
+        const u64 chunkSize = header->chunkSize;
+        for (u32 i = 0 ; i < header->entryCount ; i++) {
+            const PackEntry& entry = entries[i];
+            bool entryValid = entry.offset <= size
+                    && entry.size <= size - entry.offset
+                    && u64(entry.nameOffset) + entry.nameSize <= header->namesSize;
+            if (entry.compression == u32(PackCompression::NONE)) {
+                entryValid = entryValid && entry.size == entry.rawSize && entry.chunkCount == 0;
+            } else {
+                entryValid = entryValid
+                        && entry.compression == u32(PackCompression::LZ4)
+                        && entry.firstChunk <= header->chunkCount
+                        && entry.chunkCount <= header->chunkCount - entry.firstChunk
+                        && entry.chunkCount == (entry.rawSize + chunkSize - 1) / chunkSize;
+                for (u32 j = 0 ; entryValid && j < entry.chunkCount ; j++) {
+                    const PackChunk& chunk = chunks[entry.firstChunk + j];
+                    u64 rawChunkSize = std::min(chunkSize, entry.rawSize - j * chunkSize);
+                    entryValid = chunk.offset <= entry.size
+                            && chunk.size <= entry.size - chunk.offset
+                            && (chunk.compression == u32(PackCompression::NONE) ? chunk.size == rawChunkSize
+                                                                                 : chunk.compression == u32(PackCompression::LZ4));
+                }
+            }
+            if (!entryValid) {
+                m_File.close();
+                throw std::runtime_error(std::string("AssetPack::open: invalid pack entry in ") + filepath);
+            }
+        }
+        const auto* slots = reinterpret_cast<const u32*>(data + header->slotsOffset);
+        for (u32 i = 0 ; i < header->slotCount ; i++) {
+            if (slots[i] != EMPTY_SLOT && slots[i] >= header->entryCount) {
+                m_File.close();
+                throw std::runtime_error(std::string("AssetPack::open: invalid pack slot in ") + filepath);
+            }
+        }
+
+        m_Header = header;
+        m_Entries = entries;
+        m_Chunks = chunks;
+        m_Slots = slots;
+        m_Names = reinterpret_cast<const char*>(data + header->namesOffset);
+    }
+
+    void AssetPack::close() {
+        m_File.close();
+        m_Header = nullptr;
+        m_Entries = nullptr;
+        m_Chunks = nullptr;
+        m_Slots = nullptr;
+        m_Names = nullptr;
+
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        m_Stats.clear();
+    }
+
+    const PackEntry* AssetPack::find(const char* name) const {
+        if (!isOpen()) {
+            return nullptr;
+        }
+
+        const std::string key = normalizeName(name);
+        const u64 hash = hashName(key.data(), key.size());
+        const u32 mask = m_Header->slotCount - 1;
+        // load factor is kept below 1, so probing always reaches an empty slot
+        for (u32 slot = u32(hash) & mask ; m_Slots[slot] != EMPTY_SLOT ; slot = (slot + 1) & mask) {
+            const PackEntry& entry = m_Entries[m_Slots[slot]];
+            if (entry.hash == hash && entry.nameSize == key.size()
+                && memcmp(m_Names + entry.nameOffset, key.data(), key.size()) == 0) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    std::string AssetPack::getName(const PackEntry& entry) const {
+        return { m_Names + entry.nameOffset, entry.nameSize };
+    }
+
+    const u8* AssetPack::getStored(const PackEntry& entry) const {
+        return m_File.getData() + entry.offset;
+    }
+
+    AssetBlob AssetPack::load(const PackEntry& entry, ThreadPool* threadPool) const {
+        if (entry.compression == u32(PackCompression::NONE)) {
+            record(entry, 0);
+            return { getStored(entry), static_cast<size_t>(entry.size) };
+        }
+        std::vector<u8> data(static_cast<size_t>(entry.rawSize));
+        read(entry, data.data(), threadPool);
+        return AssetBlob(std::move(data));
+    }
+
+    static bool decodeChunk(const u8* stored, const PackChunk& chunk, u8* dst, size_t dstSize) {
+        if (chunk.compression == u32(PackCompression::NONE)) {
+            memcpy(dst, stored + chunk.offset, dstSize);
+            return true;
+        }
+        return Lz4::decompress(stored + chunk.offset, chunk.size, dst, dstSize);
+    }
+
+    void AssetPack::read(const PackEntry& entry, void* dst, ThreadPool* threadPool) const {
+        auto begin = std::chrono::steady_clock::now();
+        const u8* stored = getStored(entry);
+
+        if (entry.compression == u32(PackCompression::NONE)) {
+            memcpy(dst, stored, static_cast<size_t>(entry.size));
+            record(entry, secondsSince(begin));
+            return;
+        }
+
+        const PackChunk* chunks = m_Chunks + entry.firstChunk;
+        const u64 chunkSize = m_Header->chunkSize;
+        u8* bytes = static_cast<u8*>(dst);
+        std::atomic<bool> corrupted(false);
+        auto decodeChunks = [&](size_t first, size_t last) {
+            for (size_t i = first ; i < last ; i++) {
+                size_t rawChunkSize = static_cast<size_t>(std::min(chunkSize, entry.rawSize - i * chunkSize));
+                if (!decodeChunk(stored, chunks[i], bytes + i * chunkSize, rawChunkSize)) {
+                    corrupted = true;
+                }
+            }
+        };
+
+        if (threadPool != nullptr && entry.chunkCount > 1) {
+            threadPool->parallelFor(entry.chunkCount, 1, decodeChunks);
+        } else {
+            decodeChunks(0, entry.chunkCount);
+        }
+
+        if (corrupted) {
+            throw std::runtime_error("AssetPack::read: corrupted LZ4 entry " + getName(entry));
+        }
+        record(entry, secondsSince(begin));
+    }
+
+    std::vector<u8> AssetPack::readHead(const PackEntry& entry, size_t size) const {
+        size = static_cast<size_t>(std::min<u64>(size, entry.rawSize));
+        const u8* stored = getStored(entry);
+
+        if (entry.compression == u32(PackCompression::NONE)) {
+            return { stored, stored + size };
+        }
+
+        const u64 chunkSize = m_Header->chunkSize;
+        u32 chunkCount = static_cast<u32>((size + chunkSize - 1) / chunkSize);
+        std::vector<u8> head(static_cast<size_t>(std::min(u64(chunkCount) * chunkSize, entry.rawSize)));
+        for (u32 i = 0 ; i < chunkCount ; i++) {
+            size_t rawChunkSize = static_cast<size_t>(std::min(chunkSize, entry.rawSize - i * chunkSize));
+            if (!decodeChunk(stored, m_Chunks[entry.firstChunk + i], head.data() + i * chunkSize, rawChunkSize)) {
+                throw std::runtime_error("AssetPack::readHead: corrupted LZ4 entry " + getName(entry));
+            }
+        }
+        head.resize(size);
+        return head;
+    }
+
+    AssetBlob AssetPack::loadAsset(const char* filepath, const AssetPack* assetPack, ThreadPool* threadPool) {
+        if (assetPack != nullptr) {
+            const PackEntry* entry = assetPack->find(filepath);
+            if (entry != nullptr) {
+                return assetPack->load(*entry, threadPool);
+            }
+        }
+        return AssetBlob(readFile(filepath));
+    }
+
+    std::string AssetPack::getType(const std::string& name) {
+        size_t dot = name.find_last_of('.');
+        size_t slash = name.find_last_of('/');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+            return "<none>";
+        }
+        return name.substr(dot);
+    }
+
+    void AssetPack::record(const PackEntry& entry, double seconds) const {
+        std::string type = getType(getName(entry));
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        addStats(m_Stats, type, entry.size, entry.rawSize, seconds);
+    }
+
+    std::vector<AssetTypeStats> AssetPack::getStats() const {
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        return m_Stats;
+    }
+
+    void AssetPack::logStats(const char* title, const std::vector<AssetTypeStats>& stats) {
+        printf("%s\n", title);
+        printf("%-10s %8s %14s %14s %8s %12s\n", "type", "count", "stored bytes", "raw bytes", "ratio", "MB/s");
+        for (const auto& typeStats : stats) {
+            double ratio = typeStats.storedBytes > 0 ? double(typeStats.rawBytes) / double(typeStats.storedBytes) : 1.0;
+            // zero copy loads take no time, their throughput is only bounded by page faults
+            if (typeStats.seconds > 0) {
+                double throughput = double(typeStats.rawBytes) / typeStats.seconds / (1024.0 * 1024.0);
+                printf("%-10s %8u %14llu %14llu %8.2f %12.1f\n", typeStats.type.c_str(), typeStats.count,
+                       (unsigned long long) typeStats.storedBytes, (unsigned long long) typeStats.rawBytes, ratio, throughput);
+            } else {
+                printf("%-10s %8u %14llu %14llu %8.2f %12s\n", typeStats.type.c_str(), typeStats.count,
+                       (unsigned long long) typeStats.storedBytes, (unsigned long long) typeStats.rawBytes, ratio, "-");
+            }
+        }
+    }
+
+    void AssetPackWriter::add(const std::string& name, const void* data, size_t size, PackCompression compression) {
+        auto begin = std::chrono::steady_clock::now();
+
+        PendingEntry entry;
+        entry.name = normalizeName(name.c_str());
+        entry.rawSize = size;
+        entry.compression = PackCompression::NONE;
+
+        const u8* bytes = static_cast<const u8*>(data);
+        if (compression == PackCompression::LZ4 && size > 0) {
+            std::vector<u8> block(Lz4::compressBound(m_ChunkSize));
+            for (size_t chunkBegin = 0 ; chunkBegin < size ; chunkBegin += m_ChunkSize) {
+                size_t rawChunkSize = std::min<size_t>(m_ChunkSize, size - chunkBegin);
+                size_t compressedSize = Lz4::compress(bytes + chunkBegin, rawChunkSize, block.data(), block.size());
+
+                PackChunk chunk{};
+                chunk.offset = entry.data.size();
+                if (compressedSize > 0 && compressedSize < rawChunkSize) {
+                    chunk.size = static_cast<u32>(compressedSize);
+                    chunk.compression = static_cast<u32>(PackCompression::LZ4);
+                    entry.data.insert(entry.data.end(), block.data(), block.data() + compressedSize);
+                } else {
+                    chunk.size = static_cast<u32>(rawChunkSize);
+                    chunk.compression = static_cast<u32>(PackCompression::NONE);
+                    entry.data.insert(entry.data.end(), bytes + chunkBegin, bytes + chunkBegin + rawChunkSize);
+                }
+                entry.chunks.push_back(chunk);
+            }
+            // keep entry raw when compression does not pay off, it stays zero copy then
+            if (entry.data.size() < size) {
+                entry.compression = PackCompression::LZ4;
+            } else {
+                entry.data.clear();
+                entry.chunks.clear();
+            }
+        }
+        if (entry.compression == PackCompression::NONE) {
+            entry.data.assign(bytes, bytes + size);
+        }
+        entry.seconds = secondsSince(begin);
+
+        auto it = std::find_if(m_Entries.begin(), m_Entries.end(), [&entry](const PendingEntry& pending) {
+            return pending.name == entry.name;
+        });
+        if (it != m_Entries.end()) {
+            *it = std::move(entry);
+        } else {
+            m_Entries.emplace_back(std::move(entry));
+        }
+    }
+
+    void AssetPackWriter::addFile(const std::string& name, const char* filepath, PackCompression compression) {
+        std::vector<u8> data = readFile(filepath);
+        add(name, data.data(), data.size(), compression);
+    }
+
+    void AssetPackWriter::save(const char* filepath, u32 alignment) const {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            throw std::runtime_error("AssetPackWriter::save: alignment must be power of two!");
+        }
+
+        // sorted by name, so packs are reproducible and entries of same directory sit close to each other
+        std::vector<const PendingEntry*> sorted;
+        sorted.reserve(m_Entries.size());
+        for (const auto& entry : m_Entries) {
+            sorted.push_back(&entry);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const PendingEntry* a, const PendingEntry* b) {
+            return a->name < b->name;
+        });
+
+        const u32 entryCount = static_cast<u32>(sorted.size());
+        u32 slotCount = 16;
+        // load factor at most 1/2 keeps probe sequences short
+        while (slotCount < entryCount * 2) {
+            slotCount *= 2;
+        }
+
+        PackHeader header{};
+        memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+        header.version = AssetPack::VERSION;
+        header.entryCount = entryCount;
+        header.slotCount = slotCount;
+        header.alignment = alignment;
+        header.chunkSize = m_ChunkSize;
+        header.entriesOffset = alignUp(sizeof(PackHeader), alignof(PackEntry));
+        header.chunksOffset = header.entriesOffset + u64(entryCount) * sizeof(PackEntry);
+
+        std::vector<PackEntry> entries(entryCount);
+        std::vector<PackChunk> chunks;
+        std::vector<u32> slots(slotCount, EMPTY_SLOT);
+        std::string names;
+        for (u32 i = 0 ; i < entryCount ; i++) {
+            const PendingEntry& pending = *sorted[i];
+            PackEntry& entry = entries[i];
+            entry.hash = AssetPack::hashName(pending.name.data(), pending.name.size());
+            entry.size = pending.data.size();
+            entry.rawSize = pending.rawSize;
+            entry.nameOffset = static_cast<u32>(names.size());
+            entry.nameSize = static_cast<u32>(pending.name.size());
+            entry.compression = static_cast<u32>(pending.compression);
+            entry.firstChunk = static_cast<u32>(chunks.size());
+            entry.chunkCount = static_cast<u32>(pending.chunks.size());
+            chunks.insert(chunks.end(), pending.chunks.begin(), pending.chunks.end());
+            names += pending.name;
+
+            u32 slot = u32(entry.hash) & (slotCount - 1);
+            while (slots[slot] != EMPTY_SLOT) {
+                slot = (slot + 1) & (slotCount - 1);
+            }
+            slots[slot] = i;
+        }
+
+        header.chunkCount = static_cast<u32>(chunks.size());
+        header.slotsOffset = header.chunksOffset + u64(chunks.size()) * sizeof(PackChunk);
+        header.namesOffset = header.slotsOffset + u64(slotCount) * sizeof(u32);
+        header.namesSize = names.size();
+        header.dataOffset = alignUp(header.namesOffset + header.namesSize, alignment);
+
+        u64 offset = header.dataOffset;
+        for (u32 i = 0 ; i < entryCount ; i++) {
+            entries[i].offset = offset;
+            offset = alignUp(offset + entries[i].size, alignment);
+        }
+
+        std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error(std::string("AssetPackWriter::save: failed to open file ") + filepath);
+        }
+
+        static const char padding[4096] = {};
+        u64 written = 0;
+        auto pad = [&file, &written](u64 target) {
+            while (written < target) {
+                u64 count = std::min<u64>(target - written, sizeof(padding));
+                file.write(padding, static_cast<std::streamsize>(count));
+                written += count;
+            }
+        };
+        auto write = [&file, &written](const void* data, u64 size) {
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            written += size;
+        };
+
+        write(&header, sizeof(header));
+        pad(header.entriesOffset);
+        write(entries.data(), entries.size() * sizeof(PackEntry));
+        write(chunks.data(), chunks.size() * sizeof(PackChunk));
+        write(slots.data(), slots.size() * sizeof(u32));
+        write(names.data(), names.size());
+        for (u32 i = 0 ; i < entryCount ; i++) {
+            pad(entries[i].offset);
+            write(sorted[i]->data.data(), sorted[i]->data.size());
+        }
+        pad(offset);
+
+        if (!file) {
+            throw std::runtime_error(std::string("AssetPackWriter::save: failed to write file ") + filepath);
+        }
+    }
+
+    std::vector<AssetTypeStats> AssetPackWriter::getStats() const {
+        std::vector<AssetTypeStats> stats;
+        for (const auto& entry : m_Entries) {
+            addStats(stats, AssetPack::getType(entry.name), entry.data.size(), entry.rawSize, entry.seconds);
+        }
+        return stats;
+    }
+
+}
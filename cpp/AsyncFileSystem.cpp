@@ -0,0 +1,500 @@
+#include <AsyncFileSystem.h>
+
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define IO_URING
+#endif
+#endif
+
+#ifdef IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace rdk {
+
+    struct PendingRead final {
+        ReadRequest request;
+        ReadCallback callback;
+        ReadResult result;
+        int fd = -1;
+        u8* dst = nullptr;
+        u64 size = 0;
+        u64 done = 0;
+#ifdef IO_URING
+        iovec vector {};
+#endif
+    };
+
+#ifdef IO_URING
+
+    // user data of the eventfd poll which wakes I/O thread for newly queued reads
+    static const u64 WAKE_USER_DATA = 0;
+    // single READV is capped, larger reads are continued like short reads
+    static const u64 MAX_READ_SIZE = 1u << 30;
+
+    // minimal io_uring over raw syscalls, we don't want liburing as dependency for a few dozen lines
+    struct IoUring final {
+        int fd = -1;
+        int wakeFd = -1;
+        u32 entries = 0;
+        // SQEs handed to kernel whose CQEs are not reaped yet, kept <= entries so CQ never overflows
+        u32 inFlight = 0;
+        u32 toSubmit = 0;
+
+        u32* sqHead = nullptr;
+        u32* sqTail = nullptr;
+        u32 sqMask = 0;
+        u32* sqArray = nullptr;
+        io_uring_sqe* sqes = nullptr;
+
+        u32* cqHead = nullptr;
+        u32* cqTail = nullptr;
+        u32 cqMask = 0;
+        io_uring_cqe* cqes = nullptr;
+
+        void* sqRing = MAP_FAILED;
+        size_t sqRingSize = 0;
+        void* cqRing = MAP_FAILED;
+        size_t cqRingSize = 0;
+        size_t sqesSize = 0;
+
+        bool create(u32 queueDepth) {
+            io_uring_params params {};
+            fd = static_cast<int>(syscall(__NR_io_uring_setup, queueDepth, &params));
+            // ENOSYS on old kernels, EPERM when blocked by seccomp or sysctl, caller falls back to workers
+            if (fd < 0)
+                return false;
+
+            entries = params.sq_entries;
+            sqRingSize = params.sq_off.array + params.sq_entries * sizeof(u32);
+            cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (singleMap) {
+                sqRingSize = std::max(sqRingSize, cqRingSize);
+                cqRingSize = sqRingSize;
+            }
+
+            sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            if (sqRing == MAP_FAILED) {
+                destroy();
+                return false;
+            }
+            if (singleMap) {
+                cqRing = sqRing;
+            } else {
+                cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+                if (cqRing == MAP_FAILED) {
+                    destroy();
+                    return false;
+                }
+            }
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqesMap = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+            if (sqesMap == MAP_FAILED) {
+                destroy();
+                return false;
+            }
+            sqes = static_cast<io_uring_sqe*>(sqesMap);
+
+            u8* sq = static_cast<u8*>(sqRing);
+            sqHead = reinterpret_cast<u32*>(sq + params.sq_off.head);
+            sqTail = reinterpret_cast<u32*>(sq + params.sq_off.tail);
+            sqMask = *reinterpret_cast<u32*>(sq + params.sq_off.ring_mask);
+            sqArray = reinterpret_cast<u32*>(sq + params.sq_off.array);
+
+            u8* cq = static_cast<u8*>(cqRing);
+            cqHead = reinterpret_cast<u32*>(cq + params.cq_off.head);
+            cqTail = reinterpret_cast<u32*>(cq + params.cq_off.tail);
+            cqMask = *reinterpret_cast<u32*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+            wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            if (wakeFd < 0) {
+                destroy();
+                return false;
+            }
+            return true;
+        }
+
+        void destroy() {
+            if (sqes != nullptr)
+                munmap(sqes, sqesSize);
+            if (cqRing != MAP_FAILED && cqRing != sqRing)
+                munmap(cqRing, cqRingSize);
+            if (sqRing != MAP_FAILED)
+                munmap(sqRing, sqRingSize);
+            if (wakeFd >= 0)
+                close(wakeFd);
+            if (fd >= 0)
+                close(fd);
+            sqes = nullptr;
+            sqRing = MAP_FAILED;
+            cqRing = MAP_FAILED;
+            wakeFd = -1;
+            fd = -1;
+        }
+
+        // null when every entry is in flight
+        io_uring_sqe* getSqe() {
+            if (inFlight >= entries)
+                return nullptr;
+
+            u32 tail = *sqTail;
+            u32 index = tail & sqMask;
+            io_uring_sqe* sqe = &sqes[index];
+            memset(sqe, 0, sizeof(*sqe));
+            sqArray[index] = index;
+            // kernel sees the entry once tail is published
+            __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+            inFlight++;
+            toSubmit++;
+            return sqe;
+        }
+
+        // submits everything prepared since last call and waits for at least one completion
+        void submitAndWait() {
+            while (true) {
+                int status = static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+                if (status >= 0) {
+                    toSubmit -= std::min(toSubmit, static_cast<u32>(status));
+                    return;
+                }
+                // on EAGAIN or EBUSY completions must be reaped first, unsubmitted entries go with next call
+                if (errno != EINTR)
+                    return;
+            }
+        }
+
+        void armWake() {
+            io_uring_sqe* sqe = getSqe();
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->fd = wakeFd;
+            sqe->poll_events = POLLIN;
+            sqe->user_data = WAKE_USER_DATA;
+        }
+
+        void wake() const {
+            u64 value = 1;
+            ssize_t written = write(wakeFd, &value, sizeof(value));
+            (void) written;
+        }
+    };
+
+#else
+
+    struct IoUring final {};
+
+#endif
+
+    AsyncFileSystem::AsyncFileSystem() = default;
+
+    AsyncFileSystem::~AsyncFileSystem() {
+        destroy();
+    }
+
+    void AsyncFileSystem::create(ThreadPool* threadPool, u32 queueDepth) {
+        m_ThreadPool = threadPool;
+        m_Running = true;
+#ifdef IO_URING
+        std::unique_ptr<IoUring> uring(new IoUring());
+        if (uring->create(std::max(queueDepth, 2u))) {
+            m_Uring = std::move(uring);
+            m_Thread = std::thread(&AsyncFileSystem::run, this);
+        }
+#endif
+    }
+
+    void AsyncFileSystem::destroy() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (!m_Running)
+                return;
+            m_Running = false;
+        }
+
+        if (m_Uring) {
+#ifdef IO_URING
+            m_Uring->wake();
+#endif
+            m_Thread.join();
+#ifdef IO_URING
+            m_Uring->destroy();
+#endif
+            m_Uring.reset();
+        } else {
+            // fallback reads run on workers, wait until their callbacks are done
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [this]() { return m_Queue.empty(); });
+        }
+    }
+
+    void AsyncFileSystem::read(const ReadRequest& request, ReadCallback callback) {
+        std::vector<std::unique_ptr<PendingRead>> reads;
+        reads.emplace_back(new PendingRead());
+        reads.back()->request = request;
+        reads.back()->callback = std::move(callback);
+        enqueue(std::move(reads));
+    }
+
+    std::future<ReadResult> AsyncFileSystem::read(const ReadRequest& request) {
+        auto promise = std::make_shared<std::promise<ReadResult>>();
+        std::future<ReadResult> future = promise->get_future();
+        read(request, [promise](ReadResult&& result) {
+            promise->set_value(std::move(result));
+        });
+        return future;
+    }
+
+    std::vector<std::future<ReadResult>> AsyncFileSystem::readBatch(const std::vector<ReadRequest>& requests) {
+        std::vector<std::future<ReadResult>> futures;
+        std::vector<std::unique_ptr<PendingRead>> reads;
+        futures.reserve(requests.size());
+        reads.reserve(requests.size());
+
+        for (const auto& request : requests) {
+            auto promise = std::make_shared<std::promise<ReadResult>>();
+            futures.emplace_back(promise->get_future());
+            reads.emplace_back(new PendingRead());
+            reads.back()->request = request;
+            reads.back()->callback = [promise](ReadResult&& result) {
+                promise->set_value(std::move(result));
+            };
+        }
+
+        enqueue(std::move(reads));
+        return futures;
+    }
+
+    void AsyncFileSystem::enqueue(std::vector<std::unique_ptr<PendingRead>>&& reads) {
+        if (m_Uring) {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                for (auto& pending : reads) {
+                    m_Queue.emplace_back(std::move(pending));
+                }
+            }
+#ifdef IO_URING
+            m_Uring->wake();
+#endif
+            return;
+        }
+
+        if (m_ThreadPool == nullptr) {
+            for (auto& pending : reads) {
+                pending->callback(readNow(pending->request));
+            }
+            return;
+        }
+
+        for (auto& pending : reads) {
+            PendingRead* read = pending.get();
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Queue.emplace_back(std::move(pending));
+            }
+            m_ThreadPool->submit([this, read]() {
+                read->callback(readNow(read->request));
+
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                auto it = std::find_if(m_Queue.begin(), m_Queue.end(), [read](const std::unique_ptr<PendingRead>& queued) {
+                    return queued.get() == read;
+                });
+                m_Queue.erase(it);
+                if (m_Queue.empty())
+                    m_Condition.notify_all();
+            });
+        }
+    }
+
+    ReadResult AsyncFileSystem::readNow(const ReadRequest& request) {
+        ReadResult result;
+        result.filepath = request.filepath;
+
+        std::ifstream file(request.filepath, std::ios::ate | std::ios::binary);
+        if (!file.is_open()) {
+            result.error = "failed to open file";
+            return result;
+        }
+
+        u64 fileSize = static_cast<u64>(file.tellg());
+        if (request.offset > fileSize) {
+            result.error = "offset is out of file bounds";
+            return result;
+        }
+        u64 size = request.size == 0 ? fileSize - request.offset : request.size;
+        if (size > fileSize - request.offset) {
+            result.error = "unexpected end of file";
+            return result;
+        }
+
+        char* dst = static_cast<char*>(request.dst);
+        if (dst == nullptr) {
+            result.data.resize(static_cast<size_t>(size));
+            dst = reinterpret_cast<char*>(result.data.data());
+        }
+        file.seekg(static_cast<std::streamoff>(request.offset));
+        file.read(dst, static_cast<std::streamsize>(size));
+        if (!file) {
+            result.error = "failed to read file";
+            return result;
+        }
+
+        result.size = size;
+        result.success = true;
+        return result;
+    }
+
+#ifdef IO_URING
+
+    static bool openRead(PendingRead& pending) {
+        const ReadRequest& request = pending.request;
+        pending.result.filepath = request.filepath;
+
+        // open is done synchronously on I/O thread, IORING_OP_OPENAT would need 5.6+ kernels
+        pending.fd = open(request.filepath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (pending.fd < 0) {
+            pending.result.error = "failed to open file";
+            return false;
+        }
+
+        pending.size = request.size;
+        if (pending.size == 0) {
+            struct stat fileStat {};
+            if (fstat(pending.fd, &fileStat) != 0 || u64(fileStat.st_size) < request.offset) {
+                pending.result.error = "offset is out of file bounds";
+                return false;
+            }
+            pending.size = u64(fileStat.st_size) - request.offset;
+        }
+
+        pending.dst = static_cast<u8*>(request.dst);
+        if (pending.dst == nullptr) {
+            pending.result.data.resize(static_cast<size_t>(pending.size));
+            pending.dst = pending.result.data.data();
+        }
+        return true;
+    }
+
+    static void completeRead(std::unique_ptr<PendingRead> pending) {
+        if (pending->fd >= 0)
+            close(pending->fd);
+        pending->result.size = pending->done;
+        pending->result.success = pending->result.error.empty();
+        if (!pending->result.success)
+            pending->result.data.clear();
+        pending->callback(std::move(pending->result));
+    }
+
+    void AsyncFileSystem::run() {
+        IoUring& uring = *m_Uring;
+        // opened reads waiting for a free submission entry, partial reads are continued from the front
+        std::deque<std::unique_ptr<PendingRead>> backlog;
+        u32 readsInFlight = 0;
+
+        uring.armWake();
+
+        while (true) {
+            bool running;
+            std::deque<std::unique_ptr<PendingRead>> queued;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                running = m_Running;
+                queued.swap(m_Queue);
+            }
+            // callbacks may queue more reads, so they never run under the lock
+            for (auto& pending : queued) {
+                if (openRead(*pending)) {
+                    backlog.emplace_back(std::move(pending));
+                } else {
+                    completeRead(std::move(pending));
+                }
+            }
+
+            if (!running && backlog.empty() && readsInFlight == 0)
+                break;
+
+            // everything queued since last wakeup goes to kernel with one io_uring_enter
+            while (!backlog.empty()) {
+                PendingRead& pending = *backlog.front();
+                if (pending.done == pending.size) {
+                    completeRead(std::move(backlog.front()));
+                    backlog.pop_front();
+                    continue;
+                }
+
+                io_uring_sqe* sqe = uring.getSqe();
+                if (sqe == nullptr)
+                    break;
+
+                pending.vector.iov_base = pending.dst + pending.done;
+                pending.vector.iov_len = static_cast<size_t>(std::min(pending.size - pending.done, MAX_READ_SIZE));
+                sqe->opcode = IORING_OP_READV;
+                sqe->fd = pending.fd;
+                sqe->off = pending.request.offset + pending.done;
+                sqe->addr = reinterpret_cast<u64>(&pending.vector);
+                sqe->len = 1;
+                sqe->user_data = reinterpret_cast<u64>(backlog.front().release());
+                backlog.pop_front();
+                readsInFlight++;
+            }
+
+            uring.submitAndWait();
+
+            u32 head = *uring.cqHead;
+            u32 tail = __atomic_load_n(uring.cqTail, __ATOMIC_ACQUIRE);
+            for ( ; head != tail ; head++) {
+                const io_uring_cqe& cqe = uring.cqes[head & uring.cqMask];
+                uring.inFlight--;
+
+                if (cqe.user_data == WAKE_USER_DATA) {
+                    u64 value;
+                    ssize_t drained = ::read(uring.wakeFd, &value, sizeof(value));
+                    (void) drained;
+                    uring.armWake();
+                    continue;
+                }
+
+                std::unique_ptr<PendingRead> pending(reinterpret_cast<PendingRead*>(cqe.user_data));
+                readsInFlight--;
+                if (cqe.res == -EAGAIN || cqe.res == -EINTR) {
+                    backlog.emplace_front(std::move(pending));
+                } else if (cqe.res < 0) {
+                    pending->result.error = strerror(-cqe.res);
+                    completeRead(std::move(pending));
+                } else if (cqe.res == 0) {
+                    pending->result.error = "unexpected end of file";
+                    completeRead(std::move(pending));
+                } else {
+                    pending->done += static_cast<u64>(cqe.res);
+                    if (pending->done < pending->size) {
+                        // short read, continue with the rest on next submission
+                        backlog.emplace_front(std::move(pending));
+                    } else {
+                        completeRead(std::move(pending));
+                    }
+                }
+            }
+            __atomic_store_n(uring.cqHead, head, __ATOMIC_RELEASE);
+        }
+    }
+
+#else
+
+    void AsyncFileSystem::run() {}
+
+#endif
+
+}
@@ -0,0 +1,330 @@
+#include <BlockCompression.h>
+
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+namespace rdk {
+
+    u32 BlockCompressor::blockSize(BlockFormat format) {
+        switch (format) {
+            case BlockFormat::BC1:
+            case BlockFormat::BC4:
+                return 8;
+            default:
+                return 16;
+        }
+    }
+
+    size_t BlockCompressor::compressedSize(u32 width, u32 height, BlockFormat format) {
+        size_t blocksX = (width + 3) / 4;
+        size_t blocksY = (height + 3) / 4;
+        return blocksX * blocksY * blockSize(format);
+    }
+
+    VkFormat BlockCompressor::toVkFormat(BlockFormat format, bool srgb) {
+        switch (format) {
+            case BlockFormat::BC1:
+                return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+            case BlockFormat::BC3:
+                return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+            case BlockFormat::BC4:
+                return VK_FORMAT_BC4_UNORM_BLOCK;
+            case BlockFormat::BC5:
+                return VK_FORMAT_BC5_UNORM_BLOCK;
+            case BlockFormat::BC7:
+                return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+        }
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    static inline u16 packRGB565(const u8* color) {
+        return static_cast<u16>(((color[0] >> 3) << 11) | ((color[1] >> 2) << 5) | (color[2] >> 3));
+    }
+
+    static inline void unpackRGB565(u16 packed, int* color) {
+        int r = (packed >> 11) & 31;
+        int g = (packed >> 5) & 63;
+        int b = packed & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    static inline void writeU16(u8* dst, u16 value) {
+        dst[0] = static_cast<u8>(value);
+        dst[1] = static_cast<u8>(value >> 8);
+    }
+
+    static inline void writeU32(u8* dst, u32 value) {
+        for (int i = 0 ; i < 4 ; i++) {
+            dst[i] = static_cast<u8>(value >> (i * 8));
+        }
+    }
+
+    void BlockCompressor::compressBlockBC1(const u8* block, u8* dst) {
+        u8 minColor[3] = { 255, 255, 255 };
+        u8 maxColor[3] = { 0, 0, 0 };
+        for (int i = 0 ; i < 16 ; i++) {
+            for (int c = 0 ; c < 3 ; c++) {
+                minColor[c] = std::min(minColor[c], block[i * 4 + c]);
+                maxColor[c] = std::max(maxColor[c], block[i * 4 + c]);
+            }
+        }
+        // inset bounding box to reduce error from extreme outliers
+        for (int c = 0 ; c < 3 ; c++) {
+            int inset = (maxColor[c] - minColor[c]) >> 4;
+            minColor[c] = static_cast<u8>(std::min(255, minColor[c] + inset));
+            maxColor[c] = static_cast<u8>(std::max(0, maxColor[c] - inset));
+        }
+
+        u16 color0 = packRGB565(maxColor);
+        u16 color1 = packRGB565(minColor);
+        if (color0 < color1)
+            std::swap(color0, color1);
+
+        u32 indices = 0;
+        if (color0 != color1) {
+            int palette[4][3];
+            unpackRGB565(color0, palette[0]);
+            unpackRGB565(color1, palette[1]);
+            for (int c = 0 ; c < 3 ; c++) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+
+            for (int i = 0 ; i < 16 ; i++) {
+                int bestIndex = 0;
+                int bestError = INT32_MAX;
+                for (int p = 0 ; p < 4 ; p++) {
+                    int error = 0;
+                    for (int c = 0 ; c < 3 ; c++) {
+                        int d = block[i * 4 + c] - palette[p][c];
+                        error += d * d;
+                    }
+                    if (error < bestError) {
+                        bestError = error;
+                        bestIndex = p;
+                    }
+                }
+                indices |= static_cast<u32>(bestIndex) << (i * 2);
+            }
+        }
+
+        writeU16(dst, color0);
+        writeU16(dst + 2, color1);
+        writeU32(dst + 4, indices);
+    }
+
+    void BlockCompressor::compressBlockBC4(const u8* block, u32 channel, u8* dst) {
+        u8 minValue = 255;
+        u8 maxValue = 0;
+        for (int i = 0 ; i < 16 ; i++) {
+            minValue = std::min(minValue, block[i * 4 + channel]);
+            maxValue = std::max(maxValue, block[i * 4 + channel]);
+        }
+
+        dst[0] = maxValue;
+        dst[1] = minValue;
+
+        u64 indices = 0;
+        if (maxValue != minValue) {
+            // 8 value mode: palette[0] = max, palette[1] = min, 6 interpolated values in between
+            int palette[8];
+            palette[0] = maxValue;
+            palette[1] = minValue;
+            for (int i = 1 ; i < 7 ; i++) {
+                palette[i + 1] = ((7 - i) * maxValue + i * minValue) / 7;
+            }
+
+            for (int i = 0 ; i < 16 ; i++) {
+                int value = block[i * 4 + channel];
+                int bestIndex = 0;
+                int bestError = INT32_MAX;
+                for (int p = 0 ; p < 8 ; p++) {
+                    int error = std::abs(value - palette[p]);
+                    if (error < bestError) {
+                        bestError = error;
+                        bestIndex = p;
+                    }
+                }
+                indices |= static_cast<u64>(bestIndex) << (i * 3);
+            }
+        }
+
+        for (int i = 0 ; i < 6 ; i++) {
+            dst[2 + i] = static_cast<u8>(indices >> (i * 8));
+        }
+    }
+
+    void BlockCompressor::compressBlockBC3(const u8* block, u8* dst) {
+        compressBlockBC4(block, 3, dst);
+        compressBlockBC1(block, dst + 8);
+    }
+
+    void BlockCompressor::compressBlockBC5(const u8* block, u8* dst) {
+        compressBlockBC4(block, 0, dst);
+        compressBlockBC4(block, 1, dst + 8);
+    }
+
+    class BitWriter final {
+
+    public:
+        explicit BitWriter(u8* dst) : m_Dst(dst) {
+            memset(m_Dst, 0, 16);
+        }
+
+        void write(u32 value, u32 bitCount) {
+            for (u32 i = 0 ; i < bitCount ; i++) {
+                if (value & (1u << i)) {
+                    m_Dst[m_Position >> 3] |= static_cast<u8>(1u << (m_Position & 7));
+                }
+                m_Position++;
+            }
+        }
+
+    private:
+        u8* m_Dst;
+        u32 m_Position = 0;
+    };
+
+    static const int BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // mode 6: one subset, RGBA 7 bit endpoints with unique p-bit per endpoint, 4 bit indices
+    void BlockCompressor::compressBlockBC7(const u8* block, u8* dst) {
+        int minColor[4] = { 255, 255, 255, 255 };
+        int maxColor[4] = { 0, 0, 0, 0 };
+        for (int i = 0 ; i < 16 ; i++) {
+            for (int c = 0 ; c < 4 ; c++) {
+                minColor[c] = std::min(minColor[c], int(block[i * 4 + c]));
+                maxColor[c] = std::max(maxColor[c], int(block[i * 4 + c]));
+            }
+        }
+
+        // quantize endpoint into 7 bits + shared p-bit, choosing p-bit with lower error
+        auto quantize = [](const int* color, int* quantized, int* pBit) {
+            int bestError = INT32_MAX;
+            for (int p = 0 ; p < 2 ; p++) {
+                int error = 0;
+                int candidate[4];
+                for (int c = 0 ; c < 4 ; c++) {
+                    int value = std::min(127, std::max(0, (color[c] - p + 1) >> 1));
+                    candidate[c] = value;
+                    int d = color[c] - ((value << 1) | p);
+                    error += d * d;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    *pBit = p;
+                    memcpy(quantized, candidate, sizeof(candidate));
+                }
+            }
+        };
+
+        int endpoint[2][4];
+        int pBits[2];
+        quantize(minColor, endpoint[0], &pBits[0]);
+        quantize(maxColor, endpoint[1], &pBits[1]);
+
+        int palette[16][4];
+        for (int c = 0 ; c < 4 ; c++) {
+            int e0 = (endpoint[0][c] << 1) | pBits[0];
+            int e1 = (endpoint[1][c] << 1) | pBits[1];
+            for (int i = 0 ; i < 16 ; i++) {
+                palette[i][c] = ((64 - BC7_WEIGHTS4[i]) * e0 + BC7_WEIGHTS4[i] * e1 + 32) >> 6;
+            }
+        }
+
+        int indices[16];
+        for (int i = 0 ; i < 16 ; i++) {
+            int bestError = INT32_MAX;
+            for (int p = 0 ; p < 16 ; p++) {
+                int error = 0;
+                for (int c = 0 ; c < 4 ; c++) {
+                    int d = block[i * 4 + c] - palette[p][c];
+                    error += d * d;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    indices[i] = p;
+                }
+            }
+        }
+
+        // anchor index is stored with implicit zero MSB, flip endpoints to satisfy it
+        if (indices[0] & 8) {
+            for (int c = 0 ; c < 4 ; c++) {
+                std::swap(endpoint[0][c], endpoint[1][c]);
+            }
+            std::swap(pBits[0], pBits[1]);
+            for (int i = 0 ; i < 16 ; i++) {
+                indices[i] = 15 - indices[i];
+            }
+        }
+
+        BitWriter writer(dst);
+        writer.write(1u << 6, 7);
+        for (int c = 0 ; c < 4 ; c++) {
+            writer.write(endpoint[0][c], 7);
+            writer.write(endpoint[1][c], 7);
+        }
+        writer.write(pBits[0], 1);
+        writer.write(pBits[1], 1);
+        writer.write(indices[0], 3);
+        for (int i = 1 ; i < 16 ; i++) {
+            writer.write(indices[i], 4);
+        }
+    }
+
+    void BlockCompressor::compress(
+            const u8* rgba, u32 width, u32 height,
+            BlockFormat format, u8* dst,
+            ThreadPool* threadPool
+    ) {
+        u32 blocksX = (width + 3) / 4;
+        u32 blocksY = (height + 3) / 4;
+        u32 size = blockSize(format);
+
+        auto compressRows = [=](size_t begin, size_t end) {
+            u8 block[16 * 4];
+            for (size_t by = begin ; by < end ; by++) {
+                for (u32 bx = 0 ; bx < blocksX ; bx++) {
+                    // fetch 4x4 texels, clamping at right and bottom edges
+                    for (u32 y = 0 ; y < 4 ; y++) {
+                        u32 py = std::min(u32(by) * 4 + y, height - 1);
+                        for (u32 x = 0 ; x < 4 ; x++) {
+                            u32 px = std::min(bx * 4 + x, width - 1);
+                            memcpy(&block[(y * 4 + x) * 4], &rgba[(size_t(py) * width + px) * 4], 4);
+                        }
+                    }
+
+                    u8* out = dst + (by * blocksX + bx) * size;
+                    switch (format) {
+                        case BlockFormat::BC1:
+                            compressBlockBC1(block, out);
+                            break;
+                        case BlockFormat::BC3:
+                            compressBlockBC3(block, out);
+                            break;
+                        case BlockFormat::BC4:
+                            compressBlockBC4(block, 0, out);
+                            break;
+                        case BlockFormat::BC5:
+                            compressBlockBC5(block, out);
+                            break;
+                        case BlockFormat::BC7:
+                            compressBlockBC7(block, out);
+                            break;
+                    }
+                }
+            }
+        };
+
+        if (threadPool) {
+            threadPool->parallelFor(blocksY, 8, compressRows);
+        } else {
+            compressRows(0, blocksY);
+        }
+    }
+
+}
@@ -7,7 +7,8 @@ namespace rdk {
             VkDevice device,
             VkPhysicalDevice physicalDevice,
             VkBufferUsageFlags usage,
-            VkMemoryPropertyFlags props
+            VkMemoryPropertyFlags props,
+            const std::vector<u32>& queueFamilies
     ) {
         m_LogicalDevice = device;
 
@@ -15,7 +16,13 @@ namespace rdk {
         info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         info.size = size;
         info.usage = usage;
-        info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (queueFamilies.size() > 1) {
+            info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            info.queueFamilyIndexCount = static_cast<u32>(queueFamilies.size());
+            info.pQueueFamilyIndices = queueFamilies.data();
+        } else {
+            info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        }
 
         auto state = vkCreateBuffer(m_LogicalDevice, &info, nullptr, &m_Handle);
         rect_assert(state == VK_SUCCESS, "Failed to create Vulkan buffer object")
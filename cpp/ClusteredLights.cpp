@@ -0,0 +1,208 @@
+#include <ClusteredLights.h>
+#include <CommandPool.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace rdk {
+
+    static const VkDeviceSize CLUSTERS_SIZE =
+            sizeof(u32) * ClusteredLights::CLUSTER_COUNT * (1 + ClusteredLights::MAX_CLUSTER_LIGHTS);
+
+    void ClusteredLights::create(Device* device, const AssetPack* assetPack, u32 framesInFlight, const char* shaderFilepath) {
+        m_Device = device;
+        m_ShaderFilepath = shaderFilepath;
+        VkDevice logicalDevice = device->getLogicalHandle();
+        VkPhysicalDevice physicalDevice = device->getPhysicalHandle();
+
+        // every frame slot has its own copy, so clustering never waits for fragments of previous frame
+        m_Frames.resize(framesInFlight);
+        for (auto& frame : m_Frames) {
+            frame.params.create(
+                    sizeof(ClusterParams),
+                    logicalDevice,
+                    physicalDevice,
+                    VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+            );
+            frame.paramsBlock = frame.params.mapMemory(sizeof(ClusterParams));
+            ClusterParams params{};
+            params.ambient = m_Ambient;
+            params.zNear = m_ZNear;
+            params.zFar = m_ZFar;
+            memcpy(frame.paramsBlock, &params, sizeof(params));
+
+            frame.lights.create(
+                    sizeof(PointLight) * MAX_LIGHTS,
+                    logicalDevice,
+                    physicalDevice,
+                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+            );
+            frame.lightsBlock = frame.lights.mapMemory(sizeof(PointLight) * MAX_LIGHTS);
+
+            frame.clusters.create(
+                    CLUSTERS_SIZE,
+                    logicalDevice,
+                    physicalDevice,
+                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+            );
+        }
+        m_Created = true;
+
+        ComputeShader shader;
+        try {
+            shader = ComputeShader(logicalDevice, shaderFilepath, assetPack);
+        } catch (const std::exception& e) {
+            std::cerr << "ClusteredLights::create: " << e.what() << ", lights are disabled" << std::endl;
+            return;
+        }
+
+        std::vector<VkDescriptorSetLayoutBinding> bindings = {
+                Pipeline::createBinding(0, COMPUTE_UNIFORM_BUFFER),
+                Pipeline::createBinding(1, COMPUTE_UNIFORM_BUFFER),
+                Pipeline::createBinding(2, COMPUTE_STORAGE_BUFFER),
+                Pipeline::createBinding(3, COMPUTE_STORAGE_BUFFER)
+        };
+        m_Pipeline.create(logicalDevice, std::move(shader), bindings);
+
+        VkDescriptorPoolSize poolSizes[] = {
+                { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, framesInFlight * 2 },
+                { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, framesInFlight * 2 }
+        };
+        m_DescriptorPool.create(logicalDevice, poolSizes, 2, framesInFlight);
+        m_DescriptorPool.createSets(framesInFlight, m_Pipeline.getDescriptorLayout());
+
+        for (u32 i = 0 ; i < framesInFlight ; i++) {
+            FrameResources& frame = m_Frames[i];
+            frame.descriptorSet = m_DescriptorPool[i];
+            DescriptorPool::writeBuffer(
+                    logicalDevice, frame.descriptorSet, 1,
+                    VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                    frame.params.getHandle(), 0, sizeof(ClusterParams)
+            );
+            DescriptorPool::writeBuffer(
+                    logicalDevice, frame.descriptorSet, 2,
+                    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    frame.lights.getHandle(), 0, sizeof(PointLight) * MAX_LIGHTS
+            );
+            DescriptorPool::writeBuffer(
+                    logicalDevice, frame.descriptorSet, 3,
+                    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    frame.clusters.getHandle(), 0, CLUSTERS_SIZE
+            );
+        }
+
+        m_Active = true;
+    }
+
+    void ClusteredLights::destroy() {
+        if (m_Active) {
+            m_DescriptorPool.destroy();
+            m_Pipeline.destroy();
+            m_Active = false;
+        }
+        if (m_Created) {
+            for (auto& frame : m_Frames) {
+                frame.params.unmapMemory();
+                frame.params.destroy();
+                frame.lights.unmapMemory();
+                frame.lights.destroy();
+                frame.clusters.destroy();
+            }
+            m_Frames.clear();
+            m_Created = false;
+        }
+    }
+
+    void ClusteredLights::setLights(const PointLight* lights, size_t count) {
+        if (count > MAX_LIGHTS) {
+            std::cerr << "ClusteredLights::setLights: " << count << " lights exceed limit of " << MAX_LIGHTS << ", the rest is dropped" << std::endl;
+            count = MAX_LIGHTS;
+        }
+        m_Lights.assign(lights, lights + count);
+    }
+
+    void ClusteredLights::writeCameraBuffer(u32 frame, VkBuffer uniformBuffer, VkDeviceSize size) {
+        if (!m_Active)
+            return;
+
+        DescriptorPool::writeBuffer(
+                m_Device->getLogicalHandle(), m_Frames[frame].descriptorSet, 0,
+                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                uniformBuffer, 0, size
+        );
+    }
+
+    void ClusteredLights::writeDescriptors(VkDescriptorSet descriptorSet, u32 frame, u32 firstBinding) {
+        VkDevice device = m_Device->getLogicalHandle();
+        FrameResources& resources = m_Frames[frame];
+        DescriptorPool::writeBuffer(
+                device, descriptorSet, firstBinding,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                resources.lights.getHandle(), 0, sizeof(PointLight) * MAX_LIGHTS
+        );
+        DescriptorPool::writeBuffer(
+                device, descriptorSet, firstBinding + 1,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                resources.clusters.getHandle(), 0, CLUSTERS_SIZE
+        );
+        DescriptorPool::writeBuffer(
+                device, descriptorSet, firstBinding + 2,
+                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                resources.params.getHandle(), 0, sizeof(ClusterParams)
+        );
+    }
+
+    void ClusteredLights::cmdBuild(VkCommandBuffer commandBuffer, u32 frame, const VkExtent2D& extent) {
+        if (!m_Created)
+            return;
+
+        FrameResources& resources = m_Frames[frame];
+        // without clustering fragment shader must not read cluster buffer, so it sees no lights at all
+        u32 lightCount = m_Active ? static_cast<u32>(m_Lights.size()) : 0;
+
+        ClusterParams params;
+        params.gridX = GRID_X;
+        params.gridY = GRID_Y;
+        params.gridZ = GRID_Z;
+        params.lightCount = lightCount;
+        params.screenWidth = static_cast<float>(extent.width);
+        params.screenHeight = static_cast<float>(extent.height);
+        params.ambient = m_Ambient;
+        params.padding = 0;
+        params.zNear = m_ZNear;
+        params.zFar = m_ZFar;
+        params.depthPadding[0] = 0;
+        params.depthPadding[1] = 0;
+        memcpy(resources.paramsBlock, &params, sizeof(params));
+
+        if (lightCount == 0)
+            return;
+
+        memcpy(resources.lightsBlock, m_Lights.data(), sizeof(PointLight) * lightCount);
+
+        m_Pipeline.bind(commandBuffer, resources.descriptorSet);
+        m_Pipeline.dispatch(commandBuffer, ComputePipeline::groupCount(CLUSTER_COUNT, 64));
+
+        CommandPool::cmdMemoryBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT
+        );
+    }
+
+    void ClusteredLights::reload(DeletionQueue& deletionQueue) {
+        if (!m_Active || !m_Pipeline.getShader().reload())
+            return;
+
+        try {
+            deletionQueue.release(m_Pipeline.recreate());
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+
+}
@@ -6,6 +6,8 @@
 
 namespace rdk {
 
+    constexpr std::chrono::milliseconds CommandPool::RESIZE_DEBOUNCE;
+
     void CommandPool::create() {
         VkCommandPoolCreateInfo info{};
         info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -13,37 +15,71 @@ namespace rdk {
         info.queueFamilyIndex = m_Queue->getFamilyIndices().graphicsFamily;
         auto status = vkCreateCommandPool(m_Device->getLogicalHandle(), &info, nullptr, &m_Handle);
         rect_assert(status == VK_SUCCESS, "Failed to create Vulkan command pool")
-        createBuffers();
+        info.queueFamilyIndex = m_Queue->getFamilyIndices().computeFamily;
+        auto computeStatus = vkCreateCommandPool(m_Device->getLogicalHandle(), &info, nullptr, &m_ComputeHandle);
+        rect_assert(computeStatus == VK_SUCCESS, "Failed to create Vulkan compute command pool")
+        createBuffers(m_Handle, m_Buffers);
+        createBuffers(m_ComputeHandle, m_ComputeBuffers);
         createSyncObjects();
+        m_DeletionQueue.create(m_Device->getLogicalHandle());
+        m_DynamicResolution.create(
+                m_Device,
+                &m_Pipeline->getSwapChain(),
+                m_Queue->getFamilyIndices().graphicsFamily,
+                m_MaxFramesInFlight,
+                m_DynamicResolutionSettings
+        );
     }
 
     void CommandPool::destroy() {
+        m_DynamicResolution.destroy();
+        m_DeletionQueue.destroy();
         destroySyncObjects();
-        destroyBuffers();
+        destroyBuffers(m_ComputeHandle, m_ComputeBuffers);
+        destroyBuffers(m_Handle, m_Buffers);
+        vkDestroyCommandPool(m_Device->getLogicalHandle(), m_ComputeHandle, nullptr);
         vkDestroyCommandPool(m_Device->getLogicalHandle(), m_Handle, nullptr);
     }
 
+    void CommandPool::setDynamicResolution(const DynamicResolutionSettings& settings) {
+        m_Device->waitIdle();
+        m_DynamicResolutionSettings = settings;
+        m_DynamicResolution.destroy();
+        m_DynamicResolution.create(
+                m_Device,
+                &m_Pipeline->getSwapChain(),
+                m_Queue->getFamilyIndices().graphicsFamily,
+                m_MaxFramesInFlight,
+                m_DynamicResolutionSettings
+        );
+    }
+
+    void CommandPool::setSceneDepthStored(bool stored) {
+        m_Device->waitIdle();
+        m_Pipeline->getSwapChain().setDepthStored(stored);
+        m_DynamicResolution.setDepthStored(stored);
+        setDynamicResolution(m_DynamicResolutionSettings);
+    }
+
     void CommandPool::createSyncObjects() {
         m_ImageAvailableSemaphore.resize(m_MaxFramesInFlight);
         m_RenderFinishedSemaphore.resize(m_MaxFramesInFlight);
-        m_FlightFence.resize(m_MaxFramesInFlight);
+        m_ComputeFinishedSemaphore.resize(m_MaxFramesInFlight);
+        m_FrameValues.assign(m_MaxFramesInFlight, 0);
         // setup semaphore info
         VkSemaphoreCreateInfo semaphoreInfo{};
         semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-        // setup fence info
-        VkFenceCreateInfo fenceInfo{};
-        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
         VkDevice device = m_Device->getLogicalHandle();
+        m_Timeline.create(device);
         for (int i = 0 ; i < m_MaxFramesInFlight ; i++) {
             auto imageAvailableStatus = vkCreateSemaphore(device, &semaphoreInfo, nullptr, &m_ImageAvailableSemaphore[i]);
             auto renderFinishedStatus = vkCreateSemaphore(device, &semaphoreInfo, nullptr, &m_RenderFinishedSemaphore[i]);
-            auto flightFenceStatus = vkCreateFence(device, &fenceInfo, nullptr, &m_FlightFence[i]);
+            auto computeFinishedStatus = vkCreateSemaphore(device, &semaphoreInfo, nullptr, &m_ComputeFinishedSemaphore[i]);
 
             rect_assert(imageAvailableStatus == VK_SUCCESS, "Failed to create Vulkan image available semaphore")
             rect_assert(renderFinishedStatus == VK_SUCCESS, "Failed to create Vulkan render finished semaphore")
-            rect_assert(flightFenceStatus == VK_SUCCESS, "Failed to create Vulkan in flight fence")
+            rect_assert(computeFinishedStatus == VK_SUCCESS, "Failed to create Vulkan compute finished semaphore")
         }
     }
 
@@ -52,54 +88,67 @@ namespace rdk {
         for (int i = 0 ; i < m_MaxFramesInFlight ; i++) {
             vkDestroySemaphore(device, m_ImageAvailableSemaphore[i], nullptr);
             vkDestroySemaphore(device,  m_RenderFinishedSemaphore[i], nullptr);
-            vkDestroyFence(device,  m_FlightFence[i], nullptr);
+            vkDestroySemaphore(device,  m_ComputeFinishedSemaphore[i], nullptr);
         }
+        m_Timeline.destroy();
     }
 
-    void CommandPool::createBuffers() {
+    void CommandPool::createBuffers(VkCommandPool commandPool, std::vector<CommandBuffer>& commandBuffers) {
         VkDevice logicalDevice = m_Device->getLogicalHandle();
 
-        m_Buffers.resize(m_MaxFramesInFlight);
+        commandBuffers.resize(m_MaxFramesInFlight);
         std::vector<VkCommandBuffer> buffers(m_MaxFramesInFlight);
 
         VkCommandBufferAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.commandPool = m_Handle;
+        allocInfo.commandPool = commandPool;
         allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
         allocInfo.commandBufferCount = static_cast<u32>(buffers.size());
         auto status = vkAllocateCommandBuffers(logicalDevice, &allocInfo, buffers.data());
         rect_assert(status == VK_SUCCESS, "Failed to create Vulkan command buffers")
 
         for (int i = 0 ; i < buffers.size() ; i++) {
-            auto& buffer = m_Buffers[i];
+            auto& buffer = commandBuffers[i];
             buffer.setHandle(buffers[i]);
             buffer.setLogicalDevice(logicalDevice);
         }
     }
 
-    void CommandPool::destroyBuffers() {
-        VkCommandPool commandPool = m_Handle;
-        for (auto& buffer : m_Buffers) {
+    void CommandPool::destroyBuffers(VkCommandPool commandPool, std::vector<CommandBuffer>& buffers) {
+        for (auto& buffer : buffers) {
             buffer.destroy(commandPool);
         }
-        m_Buffers.clear();
+        buffers.clear();
+    }
+
+    void CommandPool::waitFrame() {
+        m_Timeline.wait(m_FrameValues[m_CurrentFrame]);
+        m_DeletionQueue.collect(m_Timeline.poll());
     }
 
-    void CommandPool::beginFrame() {
+    bool CommandPool::beginFrame() {
 #ifdef IMGUI
         ImGui::Render();
 #endif
         SwapChain& swapChain = m_Pipeline->getSwapChain();
         VkSwapchainKHR swapChainHandle = swapChain.getHandle();
         VkDevice logicalDevice = m_Device->getLogicalHandle();
-        VkFence& currentFence = m_FlightFence[m_CurrentFrame];
         VkSemaphore& currentImageAvailableSemaphore = m_ImageAvailableSemaphore[m_CurrentFrame];
         VkSemaphore& currentRenderFinishedSemaphore = m_RenderFinishedSemaphore[m_CurrentFrame];
         VkSurfaceKHR& surface = m_Surface;
         void* window = m_Window;
         QueueFamilyIndices& familyIndices = m_Queue->getFamilyIndices();
 
-        vkWaitForFences(logicalDevice, 1, &currentFence, VK_TRUE, UINT64_MAX);
+        m_Timeline.wait(m_FrameValues[m_CurrentFrame]);
+        m_DeletionQueue.collect(m_Timeline.poll());
+        m_DynamicResolution.update(m_CurrentFrame);
+        // suboptimal swap chain still presents, so it's kept until window size settles
+        bool resizeSettled = m_FrameBufferResized && std::chrono::steady_clock::now() - m_ResizeTime >= RESIZE_DEBOUNCE;
+        if (m_SwapChainOutOfDate || resizeSettled) {
+            if (!recreateSwapChain())
+                return false;
+            swapChainHandle = swapChain.getHandle();
+        }
         // fetch swap chain image
         auto fetchResult = vkAcquireNextImageKHR(
                 logicalDevice,
@@ -111,35 +160,98 @@ namespace rdk {
         );
         // validate fetch result
         if (fetchResult == VK_ERROR_OUT_OF_DATE_KHR) {
+            m_SwapChainOutOfDate = true;
             recreateSwapChain();
-            return;
+            return false;
         }
         rect_assert(fetchResult == VK_SUCCESS || fetchResult == VK_SUBOPTIMAL_KHR, "Failed to acquire Vulkan swap chain image")
-        // Only reset the fence if we are submitting work
-        vkResetFences(logicalDevice, 1, &currentFence);
         // record command into buffer
         // begin command buffer
         auto& commandBuffer = m_Buffers[m_CurrentFrame];
         commandBuffer.reset();
         commandBuffer.begin();
+        return true;
+    }
+
+    void CommandPool::beginAsyncCompute() {
+        auto& commandBuffer = m_ComputeBuffers[m_CurrentFrame];
+        // previous use of this buffer is covered by frame timeline value, graphics submission waited for it
+        commandBuffer.reset();
+        commandBuffer.begin();
+        m_AsyncRecording = true;
+    }
+
+    void CommandPool::submitAsyncCompute() {
+        auto& commandBuffer = m_ComputeBuffers[m_CurrentFrame];
+        commandBuffer.end();
+        m_AsyncRecording = false;
+
         VkCommandBuffer commandBufferHandle = commandBuffer.getHandle();
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBufferHandle;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &m_ComputeFinishedSemaphore[m_CurrentFrame];
+        // submitted before graphics is recorded, so it overlaps with frames still rendering
+        auto computeSubmitStatus = vkQueueSubmit(m_Queue->getComputeHandle(), 1, &submitInfo, VK_NULL_HANDLE);
+        rect_assert(computeSubmitStatus == VK_SUCCESS, "Failed to submit Vulkan compute queue")
+        m_AsyncSubmitted = true;
+    }
 
+    void CommandPool::beginRenderPass() {
+        VkCommandBuffer commandBufferHandle = m_Buffers[m_CurrentFrame].getHandle();
         auto& pipeline = *m_Pipeline;
+        VkExtent2D extent = pipeline.getSwapChain().getExtent();
 
         // begin render pass
-        pipeline.beginRenderPass(commandBufferHandle, currentImageIndex);
-        // prepare pipeline
+        if (m_DynamicResolution.isActive()) {
+            m_DynamicResolution.cmdBeginScene(commandBufferHandle, m_CurrentFrame);
+            extent = m_DynamicResolution.getRenderExtent();
+        } else {
+            pipeline.beginRenderPass(commandBufferHandle, currentImageIndex);
+        }
+        bindSceneState(commandBufferHandle, extent);
+    }
+
+    void CommandPool::suspendRenderPass() {
+        VkCommandBuffer commandBufferHandle = m_Buffers[m_CurrentFrame].getHandle();
+        // ends scene target pass as well, suspension doesn't transition any attachment
+        m_Pipeline->suspendRenderPass(commandBufferHandle);
+        // color written before suspension is loaded by resumed pass
+        cmdMemoryBarrier(
+                commandBufferHandle,
+                VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+        );
+    }
+
+    void CommandPool::resumeRenderPass() {
+        VkCommandBuffer commandBufferHandle = m_Buffers[m_CurrentFrame].getHandle();
+        auto& pipeline = *m_Pipeline;
+        VkExtent2D extent = pipeline.getSwapChain().getExtent();
+
+        if (m_DynamicResolution.isActive()) {
+            m_DynamicResolution.cmdResumeScene(commandBufferHandle);
+            extent = m_DynamicResolution.getRenderExtent();
+        } else {
+            pipeline.resumeRenderPass(commandBufferHandle, currentImageIndex);
+        }
+        bindSceneState(commandBufferHandle, extent);
+    }
+
+    void CommandPool::bindSceneState(VkCommandBuffer commandBuffer, const VkExtent2D& extent) {
+        auto& pipeline = *m_Pipeline;
         VkDescriptorSet& descriptorSet = m_DescriptorPool->operator[](m_CurrentFrame);
-        pipeline.bind(commandBufferHandle, &descriptorSet);
-        pipeline.setViewPort(commandBufferHandle);
-        pipeline.setScissor(commandBufferHandle);
+        pipeline.bind(commandBuffer, &descriptorSet);
+        pipeline.setViewPort(commandBuffer, extent);
+        pipeline.setScissor(commandBuffer, extent);
     }
 
     void CommandPool::endFrame() {
         auto& pipeline = *m_Pipeline;
         auto& commandBuffer = m_Buffers[m_CurrentFrame];
         VkCommandBuffer commandBufferHandle = commandBuffer.getHandle();
-        VkFence& currentFence = m_FlightFence[m_CurrentFrame];
         VkSemaphore& currentImageAvailableSemaphore = m_ImageAvailableSemaphore[m_CurrentFrame];
         VkSemaphore& currentRenderFinishedSemaphore = m_RenderFinishedSemaphore[m_CurrentFrame];
         SwapChain& swapChain = pipeline.getSwapChain();
@@ -147,12 +259,25 @@ namespace rdk {
         VkSurfaceKHR& surface = m_Surface;
         QueueFamilyIndices& familyIndices = m_Queue->getFamilyIndices();
 
+        // UI is composed at native resolution on top of upscaled scene
+        if (m_DynamicResolution.isActive()) {
+            m_DynamicResolution.cmdEndScene(commandBufferHandle, m_CurrentFrame);
+            m_DynamicResolution.cmdUpscale(commandBufferHandle, swapChain.getImage(currentImageIndex));
+            m_DynamicResolution.cmdBeginComposition(commandBufferHandle, currentImageIndex);
+        }
+
 #ifdef IMGUI
+        // UI pipeline is built against color format only, so with dynamic rendering
+        // it's drawn in color only continuation of swap chain pass
+        if (!m_DynamicResolution.isActive() && swapChain.isDynamicRendering()) {
+            suspendRenderPass();
+            pipeline.beginOverlayPass(commandBufferHandle, currentImageIndex);
+        }
         renderUIDrawData();
 #endif
 
         // end render pass
-        pipeline.endRenderPass(commandBufferHandle);
+        pipeline.endRenderPass(commandBufferHandle, currentImageIndex);
         // end command buffer
         commandBuffer.end();
         // setup submit info
@@ -163,18 +288,24 @@ namespace rdk {
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = commandBuffers;
 
-        VkSemaphore waitSemaphores[] = { currentImageAvailableSemaphore };
-        VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-        submitInfo.waitSemaphoreCount = 1;
+        // async compute results may feed indirect draws, vertex input and any shader of the frame
+        VkSemaphore waitSemaphores[] = { currentImageAvailableSemaphore, m_ComputeFinishedSemaphore[m_CurrentFrame] };
+        VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT };
+        // offscreen scene doesn't touch swap chain image, so it may render before image is acquired
+        if (m_DynamicResolution.isActive()) {
+            waitStages[0] = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        }
+        submitInfo.waitSemaphoreCount = m_AsyncSubmitted ? 2 : 1;
         submitInfo.pWaitSemaphores = waitSemaphores;
         submitInfo.pWaitDstStageMask = waitStages;
 
         VkSemaphore signalSemaphores[] = { currentRenderFinishedSemaphore };
         submitInfo.signalSemaphoreCount = 1;
         submitInfo.pSignalSemaphores = signalSemaphores;
-        // submit graphics queue
-        auto graphicsSubmitStatus = vkQueueSubmit(m_Queue->getGraphicsHandle(), 1, &submitInfo, currentFence);
-        rect_assert(graphicsSubmitStatus == VK_SUCCESS, "Failed to submit Vulkan graphics queue")
+        // submit graphics queue, binary semaphores stay for swap chain, presentation can't wait on timeline
+        m_FrameValues[m_CurrentFrame] = m_Timeline.submit(m_Queue->getGraphicsHandle(), submitInfo);
+        m_DeletionQueue.submit(m_FrameValues[m_CurrentFrame]);
+        m_AsyncSubmitted = false;
         // presentation info
         VkPresentInfoKHR presentInfo{};
         presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -191,9 +322,14 @@ namespace rdk {
         // submit presentation queue
         auto presentResult = vkQueuePresentKHR(m_Queue->getPresentationHandle(), &presentInfo);
 
-        if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR || m_FrameBufferResized) {
-            m_FrameBufferResized = true;
-            recreateSwapChain();
+        // recreated by the next beginFrame(), which waits for nothing but its own frame slot
+        if (presentResult == VK_ERROR_OUT_OF_DATE_KHR) {
+            m_SwapChainOutOfDate = true;
+        } else if (presentResult == VK_SUBOPTIMAL_KHR) {
+            // surface keeps reporting it every frame, so it doesn't restart debounce timer
+            if (!m_FrameBufferResized) {
+                setFrameBufferResized(true);
+            }
         } else if (presentResult != VK_SUCCESS) {
             rect_assert(false, "Failed to present Vulkan swap chain image")
         }
@@ -205,8 +341,20 @@ namespace rdk {
         m_Pipeline->drawVertices(m_Buffers[m_CurrentFrame].getHandle(), vertexCount, instanceCount);
     }
 
-    void CommandPool::drawIndices(u32 indexCount, u32 instanceCount) {
-        m_Pipeline->drawIndices(m_Buffers[m_CurrentFrame].getHandle(), indexCount, instanceCount);
+    void CommandPool::drawIndices(u32 indexCount, u32 instanceCount, u32 firstIndex) {
+        m_Pipeline->drawIndices(m_Buffers[m_CurrentFrame].getHandle(), indexCount, instanceCount, firstIndex);
+    }
+
+    void CommandPool::dispatch(const ComputePipeline& pipeline, VkDescriptorSet descriptorSet, u32 groupCountX, u32 groupCountY, u32 groupCountZ) {
+        VkCommandBuffer commandBuffer = getRecordingBuffer();
+        pipeline.bind(commandBuffer, descriptorSet);
+        pipeline.dispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
+    }
+
+    void CommandPool::dispatchIndirect(const ComputePipeline& pipeline, VkDescriptorSet descriptorSet, VkBuffer buffer, VkDeviceSize offset) {
+        VkCommandBuffer commandBuffer = getRecordingBuffer();
+        pipeline.bind(commandBuffer, descriptorSet);
+        pipeline.dispatchIndirect(commandBuffer, buffer, offset);
     }
 
     void CommandPool::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
@@ -228,7 +376,16 @@ namespace rdk {
             u32 mipLevels
     ) {
         beginTempCommand();
+        cmdTransitionImageLayout(m_TempCommand, image, format, oldLayout, newLayout, mipLevels);
+        endTempCommand();
+    }
 
+    void CommandPool::cmdTransitionImageLayout(
+            VkCommandBuffer commandBuffer,
+            VkImage image, VkFormat format,
+            VkImageLayout oldLayout, VkImageLayout newLayout,
+            u32 mipLevels
+    ) {
         VkImageMemoryBarrier barrier{};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
         barrier.oldLayout = oldLayout;
@@ -275,20 +432,101 @@ namespace rdk {
         }
 
         vkCmdPipelineBarrier(
-                m_TempCommand,
+                commandBuffer,
                 sourceStage, destinationStage,
                 0,
                 0, nullptr,
                 0, nullptr,
                 1, &barrier
         );
+    }
 
-        endTempCommand();
+    void CommandPool::cmdImageBarrier(
+            VkCommandBuffer commandBuffer, VkImage image,
+            u32 baseMipLevel, u32 mipLevels,
+            VkImageLayout oldLayout, VkImageLayout newLayout,
+            VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+            VkPipelineStageFlags dstStage, VkAccessFlags dstAccess,
+            VkImageAspectFlags aspectMask
+    ) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = aspectMask;
+        barrier.subresourceRange.baseMipLevel = baseMipLevel;
+        barrier.subresourceRange.levelCount = mipLevels;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+
+        vkCmdPipelineBarrier(
+                commandBuffer,
+                srcStage, dstStage,
+                0,
+                0, nullptr,
+                0, nullptr,
+                1, &barrier
+        );
+    }
+
+    void CommandPool::cmdMemoryBarrier(
+            VkCommandBuffer commandBuffer,
+            VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+            VkPipelineStageFlags dstStage, VkAccessFlags dstAccess
+    ) {
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+
+        vkCmdPipelineBarrier(
+                commandBuffer,
+                srcStage, dstStage,
+                0,
+                1, &barrier,
+                0, nullptr,
+                0, nullptr
+        );
+    }
+
+    void CommandPool::cmdBufferBarrier(
+            VkCommandBuffer commandBuffer,
+            VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+            VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+            VkPipelineStageFlags dstStage, VkAccessFlags dstAccess
+    ) {
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = buffer;
+        barrier.offset = offset;
+        barrier.size = size;
+
+        vkCmdPipelineBarrier(
+                commandBuffer,
+                srcStage, dstStage,
+                0,
+                0, nullptr,
+                1, &barrier,
+                0, nullptr
+        );
     }
 
     void CommandPool::generateMipmaps(VkImage image, int width, int height, u32 mipLevels) {
         beginTempCommand();
+        cmdGenerateMipmaps(m_TempCommand, image, width, height, mipLevels);
+        endTempCommand();
+    }
 
+    void CommandPool::cmdGenerateMipmaps(VkCommandBuffer commandBuffer, VkImage image, int width, int height, u32 mipLevels) {
         VkImageMemoryBarrier barrier{};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
         barrier.image = image;
@@ -301,7 +539,6 @@ namespace rdk {
         barrier.subresourceRange.layerCount = 1;
         barrier.subresourceRange.levelCount = 1;
 
-        VkCommandBuffer commandBuffer = m_TempCommand;
         int mipW = width;
         int mipH = height;
 
@@ -314,7 +551,7 @@ namespace rdk {
             barrier.subresourceRange.baseMipLevel = i - 1;
 
             vkCmdPipelineBarrier(
-                    m_TempCommand,
+                    commandBuffer,
                     VK_PIPELINE_STAGE_TRANSFER_BIT,
                     VK_PIPELINE_STAGE_TRANSFER_BIT,
                     0,
@@ -354,7 +591,7 @@ namespace rdk {
             barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
             vkCmdPipelineBarrier(
-                    m_TempCommand,
+                    commandBuffer,
                     VK_PIPELINE_STAGE_TRANSFER_BIT,
                     VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
                     0,
@@ -385,8 +622,6 @@ namespace rdk {
                 0, nullptr,
                 1, &barrier
         );
-
-        endTempCommand();
     }
 
     void CommandBuffer::create(VkCommandPool commandPool, u32 count) {
@@ -448,15 +683,13 @@ namespace rdk {
 
         VkQueue graphicsQueue = m_Queue->getGraphicsHandle();
 
-        vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(graphicsQueue);
+        // waits only for this upload, frames in flight and streaming submissions keep running
+        m_Timeline.wait(m_Timeline.submit(graphicsQueue, submitInfo));
 
         vkFreeCommandBuffers(m_Device->getLogicalHandle(), m_Handle, 1, &m_TempCommand);
     }
 
     void CommandPool::copyBufferImage(VkBuffer srcBuffer, VkImage dstImage, u32 width, u32 height) {
-        beginTempCommand();
-
         VkBufferImageCopy region{};
         region.bufferOffset = 0;
         region.bufferRowLength = 0;
@@ -470,16 +703,28 @@ namespace rdk {
         region.imageOffset = { 0, 0, 0 };
         region.imageExtent = { width, height, 1 };
 
+        copyBufferImage(srcBuffer, dstImage, std::vector<VkBufferImageCopy> { region });
+    }
+
+    void CommandPool::copyBufferImage(VkBuffer srcBuffer, VkImage dstImage, const std::vector<VkBufferImageCopy>& regions) {
+        beginTempCommand();
+        cmdCopyBufferImage(m_TempCommand, srcBuffer, dstImage, regions);
+        endTempCommand();
+    }
+
+    void CommandPool::cmdCopyBufferImage(
+            VkCommandBuffer commandBuffer,
+            VkBuffer srcBuffer, VkImage dstImage,
+            const std::vector<VkBufferImageCopy>& regions
+    ) {
         vkCmdCopyBufferToImage(
-                m_TempCommand,
+                commandBuffer,
                 srcBuffer,
                 dstImage,
                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                1,
-                &region
+                static_cast<u32>(regions.size()),
+                regions.data()
         );
-
-        endTempCommand();
     }
 
     void CommandPool::renderUIDrawData(ImDrawData* drawData) {
@@ -499,36 +744,22 @@ namespace rdk {
         ImGui::NewFrame();
     }
 
-    void CommandPool::recreateSwapChain() {
+    bool CommandPool::recreateSwapChain() {
         GLFWwindow* window = (GLFWwindow*) m_Window->getHandle();
-        // handling minimization
+        // minimized window has no extent to create swap chain with, frames are skipped until it's restored
         int width = 0, height = 0;
         glfwGetFramebufferSize(window, &width, &height);
-        while (width == 0 || height == 0) {
-            glfwGetFramebufferSize(window, &width, &height);
-            glfwWaitEvents();
-        }
+        if (width == 0 || height == 0)
+            return false;
 
-        m_Device->waitIdle();
-
-#ifdef IMGUI
-
-        ImGui_ImplVulkanH_CreateOrResizeWindow(
-                m_Instance,
-                m_Device->getPhysicalHandle(),
-                m_Device->getLogicalHandle(),
-                &m_ImGuiData,
-                m_Queue->getFamilyIndices().graphicsFamily,
-                nullptr,
-                width,
-                height,
-                1
-        );
-        m_ImGuiData.FrameIndex = 0;
-
-#endif
+        // retired images are still used by frames in flight, deletion queue destroys them
+        // once timeline passes the next submission, which follows all of them
+        m_Pipeline->getSwapChain().recreate(window, m_Surface, m_DeletionQueue);
+        m_DynamicResolution.resize(m_DeletionQueue);
 
-        m_Pipeline->getSwapChain().recreate(window, m_Surface, m_Queue->getFamilyIndices());
+        m_SwapChainOutOfDate = false;
+        m_FrameBufferResized = false;
+        return true;
     }
 
 }
\ No newline at end of file
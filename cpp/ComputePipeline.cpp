@@ -0,0 +1,107 @@
+#include <ComputePipeline.h>
+
+#include <stdexcept>
+
+namespace rdk {
+
+    void ComputePipeline::create(
+            VkDevice device,
+            ComputeShader&& shader,
+            const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+            u32 pushConstantSize
+    ) {
+        m_LogicalDevice = device;
+        m_Shader = std::move(shader);
+
+        // setup descriptor set layout
+        VkDescriptorSetLayoutCreateInfo descriptorLayoutInfo{};
+        descriptorLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        descriptorLayoutInfo.bindingCount = static_cast<u32>(bindings.size());
+        descriptorLayoutInfo.pBindings = bindings.data();
+        auto descriptorLayoutStatus = vkCreateDescriptorSetLayout(device, &descriptorLayoutInfo, nullptr, &m_DescriptorSetLayout);
+        rect_assert(descriptorLayoutStatus == VK_SUCCESS, "Failed to create Vulkan compute descriptor set layout")
+
+        // setup pipeline layout
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = pushConstantSize;
+
+        VkPipelineLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutInfo.setLayoutCount = 1;
+        layoutInfo.pSetLayouts = &m_DescriptorSetLayout;
+        layoutInfo.pushConstantRangeCount = pushConstantSize > 0 ? 1 : 0;
+        layoutInfo.pPushConstantRanges = pushConstantSize > 0 ? &pushConstantRange : nullptr;
+        auto layoutStatus = vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_Layout);
+        rect_assert(layoutStatus == VK_SUCCESS, "Failed to create Vulkan compute pipeline layout")
+
+        auto pipelineStatus = build(&m_Handle);
+        rect_assert(pipelineStatus == VK_SUCCESS, "Failed to create Vulkan compute pipeline")
+    }
+
+    void ComputePipeline::destroy() {
+        vkDestroyPipeline(m_LogicalDevice, m_Handle, nullptr);
+        vkDestroyPipelineLayout(m_LogicalDevice, m_Layout, nullptr);
+        vkDestroyDescriptorSetLayout(m_LogicalDevice, m_DescriptorSetLayout, nullptr);
+        m_Handle = VK_NULL_HANDLE;
+        m_Layout = VK_NULL_HANDLE;
+        m_DescriptorSetLayout = VK_NULL_HANDLE;
+    }
+
+    VkResult ComputePipeline::build(VkPipeline* handle) {
+        VkComputePipelineCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        info.stage = m_Shader.getStage();
+        info.layout = m_Layout;
+        info.basePipelineHandle = VK_NULL_HANDLE; // Optional
+        info.basePipelineIndex = -1; // Optional
+
+        return vkCreateComputePipelines(
+                m_LogicalDevice,
+                VK_NULL_HANDLE,
+                1, &info,
+                nullptr, handle
+        );
+    }
+
+    VkPipeline ComputePipeline::recreate() {
+        VkPipeline handle;
+        // old pipeline stays in use when rebuild fails
+        if (build(&handle) != VK_SUCCESS) {
+            throw std::runtime_error("ComputePipeline::recreate: Failed to create Vulkan compute pipeline!");
+        }
+        VkPipeline oldHandle = m_Handle;
+        m_Handle = handle;
+        return oldHandle;
+    }
+
+    void ComputePipeline::bind(VkCommandBuffer commandBuffer, VkDescriptorSet descriptorSet) const {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Handle);
+        vkCmdBindDescriptorSets(
+                commandBuffer,
+                VK_PIPELINE_BIND_POINT_COMPUTE,
+                m_Layout,
+                0, 1,
+                &descriptorSet,
+                0, nullptr
+        );
+    }
+
+    void ComputePipeline::pushConstants(VkCommandBuffer commandBuffer, const void* data, u32 size) const {
+        vkCmdPushConstants(commandBuffer, m_Layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, size, data);
+    }
+
+    void ComputePipeline::dispatch(VkCommandBuffer commandBuffer, u32 groupCountX, u32 groupCountY, u32 groupCountZ) const {
+        vkCmdDispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
+    }
+
+    void ComputePipeline::dispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset) const {
+        vkCmdDispatchIndirect(commandBuffer, buffer, offset);
+    }
+
+    u32 ComputePipeline::groupCount(u32 threads, u32 groupSize) {
+        return (threads + groupSize - 1) / groupSize;
+    }
+
+}
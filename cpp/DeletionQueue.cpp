@@ -0,0 +1,107 @@
+#include <DeletionQueue.h>
+
+namespace rdk {
+
+    void DeletionQueue::create(VkDevice device) {
+        m_Device = device;
+    }
+
+    void DeletionQueue::destroy() {
+        for (auto& submitted : m_Submitted) {
+            clear(submitted.second);
+        }
+        clear(m_Pending);
+        m_Submitted.clear();
+    }
+
+    void DeletionQueue::release(VkPipeline pipeline) {
+        m_Pending.pipelines.emplace_back(pipeline);
+    }
+
+    void DeletionQueue::release(VkPipelineLayout layout) {
+        m_Pending.pipelineLayouts.emplace_back(layout);
+    }
+
+    void DeletionQueue::release(VkDescriptorSetLayout layout) {
+        m_Pending.descriptorSetLayouts.emplace_back(layout);
+    }
+
+    void DeletionQueue::release(VkDescriptorPool pool, VkDescriptorSet descriptorSet) {
+        m_Pending.descriptorSets.emplace_back(pool, descriptorSet);
+    }
+
+    void DeletionQueue::release(VkSwapchainKHR swapChain) {
+        m_Pending.swapChains.emplace_back(swapChain);
+    }
+
+    void DeletionQueue::release(FrameBuffer&& frameBuffer) {
+        m_Pending.frameBuffers.emplace_back(std::move(frameBuffer));
+    }
+
+    void DeletionQueue::release(ImageSampler&& sampler) {
+        m_Pending.samplers.emplace_back(std::move(sampler));
+    }
+
+    void DeletionQueue::release(ImageView&& view) {
+        m_Pending.views.emplace_back(std::move(view));
+    }
+
+    void DeletionQueue::release(Image&& image) {
+        m_Pending.images.emplace_back(std::move(image));
+    }
+
+    void DeletionQueue::release(const Buffer& buffer) {
+        m_Pending.buffers.emplace_back(buffer);
+    }
+
+    void DeletionQueue::submit(u64 value) {
+        m_Submitted.emplace_back(value, std::move(m_Pending));
+        m_Pending = DeletionFrame();
+    }
+
+    void DeletionQueue::collect(u64 completedValue) {
+        while (!m_Submitted.empty() && m_Submitted.front().first <= completedValue) {
+            clear(m_Submitted.front().second);
+            m_Submitted.pop_front();
+        }
+    }
+
+    void DeletionQueue::clear(DeletionFrame& frame) {
+        // dependents first: sets and pipelines, then views before their images
+        for (const auto& descriptorSet : frame.descriptorSets) {
+            vkFreeDescriptorSets(m_Device, descriptorSet.first, 1, &descriptorSet.second);
+        }
+        frame.descriptorSets.clear();
+
+        for (VkPipeline pipeline : frame.pipelines) {
+            vkDestroyPipeline(m_Device, pipeline, nullptr);
+        }
+        frame.pipelines.clear();
+
+        for (VkPipelineLayout layout : frame.pipelineLayouts) {
+            vkDestroyPipelineLayout(m_Device, layout, nullptr);
+        }
+        frame.pipelineLayouts.clear();
+
+        for (VkDescriptorSetLayout layout : frame.descriptorSetLayouts) {
+            vkDestroyDescriptorSetLayout(m_Device, layout, nullptr);
+        }
+        frame.descriptorSetLayouts.clear();
+
+        // frame buffers reference views, swap chain owns images of its views
+        frame.frameBuffers.clear();
+        frame.samplers.clear();
+        frame.views.clear();
+        for (VkSwapchainKHR swapChain : frame.swapChains) {
+            vkDestroySwapchainKHR(m_Device, swapChain, nullptr);
+        }
+        frame.swapChains.clear();
+        frame.images.clear();
+
+        for (auto& buffer : frame.buffers) {
+            buffer.destroy();
+        }
+        frame.buffers.clear();
+    }
+
+}
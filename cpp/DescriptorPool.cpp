@@ -1,8 +1,15 @@
 #include <DescriptorPool.h>
 
+#include <stdexcept>
+
 namespace rdk {
 
-    void DescriptorPool::create(VkDevice device, VkDescriptorPoolSize* poolSizes, u32 poolSizeCount, u32 maxSets) {
+    void DescriptorPool::create(
+            VkDevice device,
+            VkDescriptorPoolSize* poolSizes, u32 poolSizeCount,
+            u32 maxSets,
+            VkDescriptorPoolCreateFlags flags
+    ) {
         m_Device = device;
 
         VkDescriptorPoolCreateInfo poolInfo{};
@@ -10,6 +17,7 @@ namespace rdk {
         poolInfo.poolSizeCount = poolSizeCount;
         poolInfo.pPoolSizes = poolSizes;
         poolInfo.maxSets = maxSets;
+        poolInfo.flags = flags;
 
         auto status = vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_Handle);
         rect_assert(status == VK_SUCCESS, "Failed to create Vulkan descriptor pool")
@@ -32,4 +40,65 @@ namespace rdk {
         rect_assert(status == VK_SUCCESS, "Failed to create Vulkan descriptor sets")
     }
 
+    VkDescriptorSet DescriptorPool::allocateSet(VkDescriptorSetLayout layout) {
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_Handle;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &layout;
+
+        VkDescriptorSet descriptorSet;
+        auto status = vkAllocateDescriptorSets(m_Device, &allocInfo, &descriptorSet);
+        if (status != VK_SUCCESS) {
+            throw std::runtime_error("DescriptorPool::allocateSet: Failed to allocate Vulkan descriptor set!");
+        }
+        return descriptorSet;
+    }
+
+    void DescriptorPool::writeBuffer(
+            VkDevice device,
+            VkDescriptorSet descriptorSet, u32 binding,
+            VkDescriptorType type,
+            VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range
+    ) {
+        VkDescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = buffer;
+        bufferInfo.offset = offset;
+        bufferInfo.range = range;
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = descriptorSet;
+        write.dstBinding = binding;
+        write.dstArrayElement = 0;
+        write.descriptorType = type;
+        write.descriptorCount = 1;
+        write.pBufferInfo = &bufferInfo;
+
+        vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+    }
+
+    void DescriptorPool::writeImage(
+            VkDevice device,
+            VkDescriptorSet descriptorSet, u32 binding,
+            VkDescriptorType type,
+            VkImageView view, VkSampler sampler, VkImageLayout layout
+    ) {
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageView = view;
+        imageInfo.sampler = sampler;
+        imageInfo.imageLayout = layout;
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = descriptorSet;
+        write.dstBinding = binding;
+        write.dstArrayElement = 0;
+        write.descriptorType = type;
+        write.descriptorCount = 1;
+        write.pImageInfo = &imageInfo;
+
+        vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+    }
+
 }
\ No newline at end of file
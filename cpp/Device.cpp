@@ -31,7 +31,8 @@ namespace rdk {
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
         std::set<int> uniqueQueueFamilies = {
                 indices.graphicsFamily,
-                indices.presentationFamily
+                indices.presentationFamily,
+                indices.computeFamily
         };
         float queuePriority = 1.0f;
         for (int queueFamily : uniqueQueueFamilies) {
@@ -43,10 +44,39 @@ namespace rdk {
             queueCreateInfos.push_back(queueCreateInfo);
         }
         // setup device features
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(m_PhysicalHandle, &supportedFeatures);
         VkPhysicalDeviceFeatures deviceFeatures{};
+        deviceFeatures.samplerAnisotropy = supportedFeatures.samplerAnisotropy;
+        // required to sample BC1-BC7 block compressed textures
+        deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+        // occlusion culled draws are issued in batches, single indirect draws are recorded without it
+        deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+        // frame and upload synchronization is built on timeline semaphores
+        VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+        timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+        timelineFeatures.timelineSemaphore = VK_TRUE;
+        // dynamic rendering is optional, drivers of Vulkan 1.3 still expose it as extension,
+        // so it's enabled the same way regardless of instance version
+        std::vector<const char*> extensions = m_Extensions;
+        VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+        dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+        m_DynamicRendering = false;
+        if (m_DynamicRenderingEnabled && isExtensionSupported(m_PhysicalHandle, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)) {
+            VkPhysicalDeviceFeatures2 features2{};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &dynamicRenderingFeatures;
+            vkGetPhysicalDeviceFeatures2(m_PhysicalHandle, &features2);
+            m_DynamicRendering = dynamicRenderingFeatures.dynamicRendering;
+        }
+        if (m_DynamicRendering) {
+            extensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+            timelineFeatures.pNext = &dynamicRenderingFeatures;
+        }
         // setup logical device
         VkDeviceCreateInfo deviceCreateInfo{};
         deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        deviceCreateInfo.pNext = &timelineFeatures;
         deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
         deviceCreateInfo.queueCreateInfoCount = queueCreateInfos.size();
         deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
@@ -56,8 +86,8 @@ namespace rdk {
 #else
         deviceCreateInfo.enabledLayerCount = 0;
 #endif
-        deviceCreateInfo.enabledExtensionCount = static_cast<u32>(m_Extensions.size());
-        deviceCreateInfo.ppEnabledExtensionNames = m_Extensions.data();
+        deviceCreateInfo.enabledExtensionCount = static_cast<u32>(extensions.size());
+        deviceCreateInfo.ppEnabledExtensionNames = extensions.data();
         // create and assert logical device
         auto logicalDeviceStatus = vkCreateDevice(
                 m_PhysicalHandle,
@@ -67,8 +97,22 @@ namespace rdk {
         );
         rect_assert(logicalDeviceStatus == VK_SUCCESS, "Failed to create Vulkan logical device")
 
+        if (m_DynamicRendering) {
+            m_CmdBeginRendering = (PFN_vkCmdBeginRenderingKHR) vkGetDeviceProcAddr(m_LogicalHandle, "vkCmdBeginRenderingKHR");
+            m_CmdEndRendering = (PFN_vkCmdEndRenderingKHR) vkGetDeviceProcAddr(m_LogicalHandle, "vkCmdEndRenderingKHR");
+            m_DynamicRendering = m_CmdBeginRendering != nullptr && m_CmdEndRendering != nullptr;
+        }
+        if (!m_DynamicRendering) {
+            std::cerr << "Device::create: dynamic rendering is not used, passes are built from render pass objects" << std::endl;
+        }
+
         vkGetPhysicalDeviceProperties(m_PhysicalHandle, &m_Props);
         vkGetPhysicalDeviceFeatures(m_PhysicalHandle, &m_Features);
+
+        VkPipelineCacheCreateInfo pipelineCacheInfo{};
+        pipelineCacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        auto pipelineCacheStatus = vkCreatePipelineCache(m_LogicalHandle, &pipelineCacheInfo, nullptr, &m_PipelineCache);
+        rect_assert(pipelineCacheStatus == VK_SUCCESS, "Failed to create Vulkan pipeline cache")
     }
 
     VkFormat Device::findSupportedFormat(
@@ -77,12 +121,7 @@ namespace rdk {
             VkFormatFeatureFlags features
     ) {
         for (VkFormat format : candidates) {
-            VkFormatProperties props;
-            vkGetPhysicalDeviceFormatProperties(m_PhysicalHandle, format, &props);
-
-            if (tiling == VK_IMAGE_TILING_LINEAR && (props.linearTilingFeatures & features) == features) {
-                return format;
-            } else if (tiling == VK_IMAGE_TILING_OPTIMAL && (props.optimalTilingFeatures & features) == features) {
+            if (isFormatSupported(format, tiling, features)) {
                 return format;
             }
         }
@@ -91,7 +130,21 @@ namespace rdk {
         throw std::runtime_error("Failed to find supported image format");
     }
 
+    bool Device::isFormatSupported(VkFormat format, VkImageTiling tiling, VkFormatFeatureFlags features) {
+        VkFormatProperties props;
+        vkGetPhysicalDeviceFormatProperties(m_PhysicalHandle, format, &props);
+
+        if (tiling == VK_IMAGE_TILING_LINEAR) {
+            return (props.linearTilingFeatures & features) == features;
+        } else if (tiling == VK_IMAGE_TILING_OPTIMAL) {
+            return (props.optimalTilingFeatures & features) == features;
+        }
+        return false;
+    }
+
     void Device::destroy() {
+        vkDestroyPipelineCache(m_LogicalHandle, m_PipelineCache, nullptr);
+        m_PipelineCache = VK_NULL_HANDLE;
         vkDestroyDevice(m_LogicalHandle, nullptr);
     }
 
@@ -117,6 +170,20 @@ namespace rdk {
 
         suitable = suitable && supportedFeatures.samplerAnisotropy;
 
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(physicalDevice, &props);
+        if (props.apiVersion < VK_API_VERSION_1_2)
+            return false;
+
+        VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+        timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &timelineFeatures;
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+
+        suitable = suitable && timelineFeatures.timelineSemaphore;
+
         return suitable;
     }
 
@@ -135,6 +202,27 @@ namespace rdk {
         return requiredExtensions.empty();
     }
 
+    bool Device::isExtensionSupported(VkPhysicalDevice physicalDevice, const char* extension) {
+        u32 extensionCount;
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+        for (const auto& availableExtension : availableExtensions) {
+            if (strcmp(availableExtension.extensionName, extension) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    void Device::cmdBeginRendering(VkCommandBuffer commandBuffer, const VkRenderingInfoKHR& renderingInfo) const {
+        m_CmdBeginRendering(commandBuffer, &renderingInfo);
+    }
+
+    void Device::cmdEndRendering(VkCommandBuffer commandBuffer) const {
+        m_CmdEndRendering(commandBuffer);
+    }
+
     QueueFamilyIndices Device::findQueueFamily(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface) {
         QueueFamilyIndices indices;
 
@@ -145,21 +233,29 @@ namespace rdk {
 
         int i = 0;
         for (const auto& queueFamily : queueFamilies) {
-            // check for graphics support
-            if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
-                indices.graphicsFamily = i;
-            // check for presentation support
-            VkBool32 presentationSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentationSupport);
-            if (presentationSupport)
-                indices.presentationFamily = i;
-
-            if (indices.completed())
-                break;
+            // dedicated compute family runs concurrently with graphics on hardware that has it
+            if (indices.computeFamily == QueueFamilyIndices::NONE_FAMILY &&
+                (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) && !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT))
+                indices.computeFamily = i;
+
+            if (!indices.completed()) {
+                // check for graphics support
+                if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+                    indices.graphicsFamily = i;
+                // check for presentation support
+                VkBool32 presentationSupport = false;
+                vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentationSupport);
+                if (presentationSupport)
+                    indices.presentationFamily = i;
+            }
 
             i++;
         }
 
+        // graphics family always supports compute
+        if (indices.computeFamily == QueueFamilyIndices::NONE_FAMILY)
+            indices.computeFamily = indices.graphicsFamily;
+
         return indices;
     }
 
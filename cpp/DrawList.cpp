@@ -0,0 +1,151 @@
+#include <DrawList.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace rdk {
+
+    u64 DrawKey::make(u32 pass, u32 pipeline, u32 material, float depth, bool backToFront) {
+        // bits of non negative float grow with its value, so they sort as unsigned integer
+        if (!(depth > 0.0f))
+            depth = 0.0f;
+        u32 depthBits;
+        memcpy(&depthBits, &depth, sizeof(depthBits));
+        if (backToFront)
+            depthBits = ~depthBits;
+
+        u64 key = u64(pass & ((1u << PASS_BITS) - 1));
+        key = (key << PIPELINE_BITS) | (pipeline & ((1u << PIPELINE_BITS) - 1));
+        key = (key << MATERIAL_BITS) | (material & ((1u << MATERIAL_BITS) - 1));
+        key = (key << 32) | depthBits;
+        return key;
+    }
+
+    void DrawList::clear() {
+        m_Draws.clear();
+        m_Entries.clear();
+    }
+
+    void DrawList::sort(ThreadPool* threadPool) {
+        size_t count = m_Draws.size();
+        m_Entries.resize(count);
+        m_Scratch.resize(count);
+        for (size_t i = 0 ; i < count ; i++) {
+            m_Entries[i] = { m_Draws[i].key, static_cast<u32>(i) };
+        }
+
+        size_t chunkCount = 1;
+        if (threadPool != nullptr && count >= PARALLEL_THRESHOLD) {
+            chunkCount = std::min<size_t>(threadPool->getThreadCount() + 1, count / (PARALLEL_THRESHOLD / 2));
+        }
+        size_t chunkSize = (count + chunkCount - 1) / std::max<size_t>(chunkCount, 1);
+        m_Histograms.resize(chunkCount * RADIX);
+
+        auto forChunks = [&](const std::function<void(size_t)>& body) {
+            if (chunkCount == 1) {
+                body(0);
+                return;
+            }
+            threadPool->parallelFor(chunkCount, 1, [&body](size_t begin, size_t end) {
+                for (size_t chunk = begin ; chunk < end ; chunk++) {
+                    body(chunk);
+                }
+            });
+        };
+
+        SortEntry* src = m_Entries.data();
+        SortEntry* dst = m_Scratch.data();
+        for (u32 shift = 0 ; shift < 64 && count > 1 ; shift += RADIX_BITS) {
+            forChunks([&](size_t chunk) {
+                u32* histogram = &m_Histograms[chunk * RADIX];
+                std::fill(histogram, histogram + RADIX, 0);
+                size_t end = std::min(count, (chunk + 1) * chunkSize);
+                for (size_t i = chunk * chunkSize ; i < end ; i++) {
+                    histogram[(src[i].key >> shift) & (RADIX - 1)]++;
+                }
+            });
+
+            // keys of a frame usually share pass and pipeline fields, so most high digits need no scatter
+            bool uniform = false;
+            for (u32 digit = 0 ; digit < RADIX && !uniform ; digit++) {
+                size_t total = 0;
+                for (size_t chunk = 0 ; chunk < chunkCount ; chunk++) {
+                    total += m_Histograms[chunk * RADIX + digit];
+                }
+                uniform = total == count;
+            }
+            if (uniform)
+                continue;
+
+            // digit-major prefix, so every chunk scatters into its own range and sort stays stable
+            u32 offset = 0;
+            for (u32 digit = 0 ; digit < RADIX ; digit++) {
+                for (size_t chunk = 0 ; chunk < chunkCount ; chunk++) {
+                    u32& counter = m_Histograms[chunk * RADIX + digit];
+                    u32 digitCount = counter;
+                    counter = offset;
+                    offset += digitCount;
+                }
+            }
+
+            forChunks([&](size_t chunk) {
+                u32* offsets = &m_Histograms[chunk * RADIX];
+                size_t end = std::min(count, (chunk + 1) * chunkSize);
+                for (size_t i = chunk * chunkSize ; i < end ; i++) {
+                    dst[offsets[(src[i].key >> shift) & (RADIX - 1)]++] = src[i];
+                }
+            });
+            std::swap(src, dst);
+        }
+
+        if (src != m_Entries.data()) {
+            m_Entries.swap(m_Scratch);
+        }
+    }
+
+    void DrawList::submit(VkCommandBuffer commandBuffer, const DrawState& bound) {
+        m_Stats = {};
+        DrawState current = bound;
+
+        for (const auto& entry : m_Entries) {
+            const DrawItem& draw = m_Draws[entry.draw];
+            DrawState state = draw.state;
+            if (state.pipeline == VK_NULL_HANDLE) state.pipeline = bound.pipeline;
+            if (state.layout == VK_NULL_HANDLE) state.layout = bound.layout;
+            if (state.descriptorSet == VK_NULL_HANDLE) state.descriptorSet = bound.descriptorSet;
+            if (state.vertexBuffer == VK_NULL_HANDLE) state.vertexBuffer = bound.vertexBuffer;
+            if (state.indexBuffer == VK_NULL_HANDLE) state.indexBuffer = bound.indexBuffer;
+
+            if (state.pipeline != current.pipeline) {
+                vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, state.pipeline);
+                m_Stats.pipelineBinds++;
+            }
+            // set bound with other layout may be disturbed by pipeline change, so layout change rebinds it
+            if (state.descriptorSet != current.descriptorSet || state.layout != current.layout) {
+                vkCmdBindDescriptorSets(
+                        commandBuffer,
+                        VK_PIPELINE_BIND_POINT_GRAPHICS,
+                        state.layout,
+                        0, 1,
+                        &state.descriptorSet,
+                        0, nullptr
+                );
+                m_Stats.descriptorBinds++;
+            }
+            if (state.vertexBuffer != current.vertexBuffer) {
+                VkDeviceSize offset = 0;
+                vkCmdBindVertexBuffers(commandBuffer, 0, 1, &state.vertexBuffer, &offset);
+                m_Stats.vertexBinds++;
+            }
+            if (state.indexBuffer != current.indexBuffer) {
+                vkCmdBindIndexBuffer(commandBuffer, state.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+                m_Stats.indexBinds++;
+            }
+
+            vkCmdDrawIndexed(commandBuffer, draw.indexCount, draw.instanceCount, draw.firstIndex, draw.vertexOffset, 0);
+            m_Stats.draws++;
+            current = state;
+        }
+    }
+
+}
@@ -0,0 +1,408 @@
+#include <DynamicResolution.h>
+#include <CommandPool.h>
+#include <math/math.h>
+
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+namespace rdk {
+
+    static RenderPassInfo sceneInfo(bool depthStored) {
+        RenderPassInfo info;
+        info.colorFinalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        info.depthStoreOp = depthStored ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        return info;
+    }
+
+    static RenderPassInfo resumeInfo() {
+        RenderPassInfo info;
+        info.colorLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+        info.colorInitialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        info.colorFinalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        info.depthLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+        info.depthInitialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        return info;
+    }
+
+    static RenderPassInfo compositionInfo() {
+        RenderPassInfo info;
+        info.colorLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+        info.colorInitialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        info.depthStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        return info;
+    }
+
+    void DynamicResolution::create(
+            Device* device,
+            SwapChain* swapChain,
+            u32 graphicsFamily,
+            u32 framesInFlight,
+            const DynamicResolutionSettings& settings
+    ) {
+        m_Device = device;
+        m_SwapChain = swapChain;
+        m_Settings = settings;
+        m_Settings.maxScale = clamp(m_Settings.maxScale, 0.1f, 1.0f);
+        m_Settings.minScale = clamp(m_Settings.minScale, 0.1f, m_Settings.maxScale);
+        m_Scale = m_Settings.maxScale;
+        m_Active = false;
+
+        if (!m_Settings.enabled)
+            return;
+
+        if (!isSupported()) {
+            std::cerr << "DynamicResolution::create: swap chain image can't be blitted into, rendering at native resolution" << std::endl;
+            return;
+        }
+
+        VkDevice logicalDevice = device->getLogicalHandle();
+        VkFormat colorFormat = swapChain->getColorFormat();
+        VkFormat depthFormat = swapChain->getDepthFormat();
+        // same formats as swap chain pass, so scene pipelines and UI are compatible with both passes.
+        // Dynamic rendering begins them on target views with the same infos.
+        if (!swapChain->isDynamicRendering()) {
+            m_SceneRenderPass = std::make_unique<RenderPass>(logicalDevice, colorFormat, depthFormat, sceneInfo(m_DepthStored));
+            m_ResumeRenderPass = std::make_unique<RenderPass>(logicalDevice, colorFormat, depthFormat, resumeInfo());
+            m_CompositionRenderPass = std::make_unique<RenderPass>(logicalDevice, colorFormat, depthFormat, compositionInfo());
+        }
+
+        u32 familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(device->getPhysicalHandle(), &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(device->getPhysicalHandle(), &familyCount, families.data());
+        u32 validBits = families[graphicsFamily].timestampValidBits;
+
+        m_FrameScales.assign(framesInFlight, m_Scale);
+        m_FrameQueried.assign(framesInFlight, false);
+        if (validBits > 0) {
+            m_TimestampPeriod = device->getProperties().limits.timestampPeriod;
+            m_TimestampMask = validBits >= 64 ? UINT64_MAX : (u64(1) << validBits) - 1;
+
+            VkQueryPoolCreateInfo queryInfo{};
+            queryInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            queryInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            queryInfo.queryCount = framesInFlight * 2;
+            auto queryStatus = vkCreateQueryPool(logicalDevice, &queryInfo, nullptr, &m_QueryPool);
+            rect_assert(queryStatus == VK_SUCCESS, "Failed to create Vulkan timestamp query pool")
+        } else {
+            std::cerr << "DynamicResolution::create: graphics queue has no timestamps, render scale stays fixed" << std::endl;
+        }
+
+        createTarget();
+        m_Active = true;
+    }
+
+    void DynamicResolution::destroy() {
+        destroyTarget();
+        m_SceneRenderPass.reset();
+        m_ResumeRenderPass.reset();
+        m_CompositionRenderPass.reset();
+        if (m_QueryPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(m_Device->getLogicalHandle(), m_QueryPool, nullptr);
+            m_QueryPool = VK_NULL_HANDLE;
+        }
+        m_FrameScales.clear();
+        m_FrameQueried.clear();
+        m_Active = false;
+    }
+
+    void DynamicResolution::resize(DeletionQueue& deletionQueue) {
+        if (!m_Active)
+            return;
+
+        releaseTarget(deletionQueue);
+
+        // surface may have lost transfer support with the new swap chain.
+        // Passes and queries may still be used by frames in flight, so they stay until destroy().
+        if (!isSupported()) {
+            std::cerr << "DynamicResolution::resize: swap chain image can't be blitted into, rendering at native resolution" << std::endl;
+            m_Active = false;
+            return;
+        }
+
+        createTarget();
+    }
+
+    bool DynamicResolution::isSupported() const {
+        VkFormat colorFormat = m_SwapChain->getColorFormat();
+        return (m_SwapChain->getImageUsage() & VK_IMAGE_USAGE_TRANSFER_DST_BIT) && m_Device->isFormatSupported(
+                colorFormat,
+                VK_IMAGE_TILING_OPTIMAL,
+                VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT |
+                VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+                VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT
+        );
+    }
+
+    void DynamicResolution::createTarget() {
+        VkDevice logicalDevice = m_Device->getLogicalHandle();
+        VkPhysicalDevice physicalDevice = m_Device->getPhysicalHandle();
+        const VkExtent2D& extent = m_SwapChain->getExtent();
+
+        m_TargetExtent.width = std::max(1u, static_cast<u32>(std::ceil(extent.width * m_Settings.maxScale)));
+        m_TargetExtent.height = std::max(1u, static_cast<u32>(std::ceil(extent.height * m_Settings.maxScale)));
+
+        ImageInfo colorInfo;
+        colorInfo.width = m_TargetExtent.width;
+        colorInfo.height = m_TargetExtent.height;
+        colorInfo.format = m_SwapChain->getColorFormat();
+        colorInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        colorInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        colorInfo.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        m_ColorImage = std::make_unique<Image>(logicalDevice, physicalDevice, colorInfo);
+
+        ImageViewInfo colorViewInfo;
+        colorViewInfo.format = colorInfo.format;
+        m_ColorView = std::make_unique<ImageView>(logicalDevice, m_ColorImage->getHandle(), colorViewInfo);
+
+        ImageInfo depthInfo;
+        depthInfo.width = m_TargetExtent.width;
+        depthInfo.height = m_TargetExtent.height;
+        depthInfo.format = m_SwapChain->getDepthFormat();
+        depthInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        depthInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        // sampled by Hi-Z pyramid build of occlusion culling, otherwise it's discarded after scene pass
+        if (!m_DepthStored) {
+            depthInfo.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        } else if (m_Device->isFormatSupported(depthInfo.format, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT)) {
+            depthInfo.usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+        }
+        depthInfo.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        m_DepthImage = std::make_unique<Image>(logicalDevice, physicalDevice, depthInfo);
+
+        ImageViewInfo depthViewInfo;
+        depthViewInfo.format = depthInfo.format;
+        depthViewInfo.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        m_DepthView = std::make_unique<ImageView>(logicalDevice, m_DepthImage->getHandle(), depthViewInfo);
+
+        if (!m_SwapChain->isDynamicRendering()) {
+            VkImageView attachments[] = { m_ColorView->getHandle(), m_DepthView->getHandle() };
+            m_FrameBuffer = std::make_unique<FrameBuffer>(
+                    logicalDevice,
+                    attachments,
+                    sizeof(attachments) / sizeof(attachments[0]),
+                    m_SceneRenderPass->getHandle(),
+                    m_TargetExtent
+            );
+        }
+
+        updateRenderExtent();
+    }
+
+    void DynamicResolution::destroyTarget() {
+        m_FrameBuffer.reset();
+        m_DepthView.reset();
+        m_DepthImage.reset();
+        m_ColorView.reset();
+        m_ColorImage.reset();
+    }
+
+    void DynamicResolution::releaseTarget(DeletionQueue& deletionQueue) {
+        if (m_FrameBuffer) {
+            deletionQueue.release(std::move(*m_FrameBuffer));
+        }
+        deletionQueue.release(std::move(*m_DepthView));
+        deletionQueue.release(std::move(*m_DepthImage));
+        deletionQueue.release(std::move(*m_ColorView));
+        deletionQueue.release(std::move(*m_ColorImage));
+        destroyTarget();
+    }
+
+    void DynamicResolution::updateRenderExtent() {
+        const VkExtent2D& extent = m_SwapChain->getExtent();
+        u32 width = static_cast<u32>(extent.width * m_Scale + 0.5f);
+        u32 height = static_cast<u32>(extent.height * m_Scale + 0.5f);
+        m_RenderExtent.width = clamp(width, 1u, m_TargetExtent.width);
+        m_RenderExtent.height = clamp(height, 1u, m_TargetExtent.height);
+    }
+
+    void DynamicResolution::update(u32 frame) {
+        if (!m_Active || m_QueryPool == VK_NULL_HANDLE || !m_FrameQueried[frame])
+            return;
+
+        m_FrameQueried[frame] = false;
+
+        u64 timestamps[2];
+        auto status = vkGetQueryPoolResults(
+                m_Device->getLogicalHandle(), m_QueryPool,
+                frame * 2, 2,
+                sizeof(timestamps), timestamps, sizeof(u64),
+                VK_QUERY_RESULT_64_BIT
+        );
+        if (status != VK_SUCCESS)
+            return;
+
+        u64 ticks = (timestamps[1] - timestamps[0]) & m_TimestampMask;
+        m_GpuTime = static_cast<float>(ticks) * m_TimestampPeriod * 1e-6f;
+
+        // GPU time grows with pixel count, normalizing it to full scale keeps
+        // frames in flight, which were rendered at different scales, comparable
+        float frameScale = m_FrameScales[frame];
+        float cost = m_GpuTime / (frameScale * frameScale);
+        if (cost <= 0.0f)
+            return;
+
+        float targetScale = clamp(std::sqrt(m_Settings.frameBudget / cost), m_Settings.minScale, m_Settings.maxScale);
+        // sharpness is dropped at once on load spikes, but comes back gradually, so scale doesn't oscillate
+        if (targetScale < m_Scale) {
+            m_Scale = targetScale;
+        } else {
+            m_Scale += (targetScale - m_Scale) * m_Settings.recovery;
+        }
+
+        updateRenderExtent();
+    }
+
+    void DynamicResolution::cmdBeginScene(VkCommandBuffer commandBuffer, u32 frame) {
+        if (m_QueryPool != VK_NULL_HANDLE) {
+            vkCmdResetQueryPool(commandBuffer, m_QueryPool, frame * 2, 2);
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_QueryPool, frame * 2);
+        }
+        m_FrameScales[frame] = m_Scale;
+
+        if (m_SwapChain->isDynamicRendering()) {
+            cmdBeginRendering(m_SwapChain->getDevice(), commandBuffer, getRenderingTarget(), m_RenderExtent, sceneInfo(m_DepthStored));
+            return;
+        }
+
+        // setup info
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = m_SceneRenderPass->getHandle();
+        renderPassInfo.framebuffer = m_FrameBuffer->getHandle();
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = m_RenderExtent;
+        // setup clear color
+        VkClearValue clearValues[2];
+        clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        clearValues[1].depthStencil = {1.0f, 0};
+        renderPassInfo.clearValueCount = 2;
+        renderPassInfo.pClearValues = clearValues;
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    }
+
+    void DynamicResolution::cmdResumeScene(VkCommandBuffer commandBuffer) {
+        if (m_SwapChain->isDynamicRendering()) {
+            cmdBeginRendering(m_SwapChain->getDevice(), commandBuffer, getRenderingTarget(), m_RenderExtent, resumeInfo());
+            return;
+        }
+
+        // setup info
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = m_ResumeRenderPass->getHandle();
+        renderPassInfo.framebuffer = m_FrameBuffer->getHandle();
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = m_RenderExtent;
+        // both attachments are loaded
+        renderPassInfo.clearValueCount = 0;
+        renderPassInfo.pClearValues = nullptr;
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    }
+
+    void DynamicResolution::cmdEndScene(VkCommandBuffer commandBuffer, u32 frame) {
+        if (m_SwapChain->isDynamicRendering()) {
+            cmdEndRendering(m_SwapChain->getDevice(), commandBuffer, getRenderingTarget(), sceneInfo(m_DepthStored));
+        } else {
+            vkCmdEndRenderPass(commandBuffer);
+        }
+
+        if (m_QueryPool != VK_NULL_HANDLE) {
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_QueryPool, frame * 2 + 1);
+            m_FrameQueried[frame] = true;
+        }
+    }
+
+    void DynamicResolution::cmdUpscale(VkCommandBuffer commandBuffer, VkImage swapChainImage) {
+        VkImage sceneImage = m_ColorImage->getHandle();
+        const VkExtent2D& extent = m_SwapChain->getExtent();
+
+        CommandPool::cmdImageBarrier(
+                commandBuffer, sceneImage, 0, 1,
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT
+        );
+        // chained with image available semaphore wait at transfer stage
+        CommandPool::cmdImageBarrier(
+                commandBuffer, swapChainImage, 0, 1,
+                VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT
+        );
+
+        VkImageBlit blit{};
+        blit.srcOffsets[0] = { 0, 0, 0 };
+        blit.srcOffsets[1] = { static_cast<int>(m_RenderExtent.width), static_cast<int>(m_RenderExtent.height), 1 };
+        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.srcSubresource.mipLevel = 0;
+        blit.srcSubresource.baseArrayLayer = 0;
+        blit.srcSubresource.layerCount = 1;
+        blit.dstOffsets[0] = { 0, 0, 0 };
+        blit.dstOffsets[1] = { static_cast<int>(extent.width), static_cast<int>(extent.height), 1 };
+        blit.dstSubresource = blit.srcSubresource;
+
+        vkCmdBlitImage(
+                commandBuffer,
+                sceneImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                swapChainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1, &blit,
+                VK_FILTER_LINEAR
+        );
+
+        CommandPool::cmdImageBarrier(
+                commandBuffer, swapChainImage, 0, 1,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+        );
+        // scene target is shared by frames in flight, next scene pass must not overwrite it before blit has read it
+        CommandPool::cmdMemoryBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0
+        );
+    }
+
+    RenderingTarget DynamicResolution::getRenderingTarget() const {
+        RenderingTarget target;
+        target.colorImage = m_ColorImage->getHandle();
+        target.colorView = m_ColorView->getHandle();
+        target.depthImage = m_DepthImage->getHandle();
+        target.depthView = m_DepthView->getHandle();
+        target.depthFormat = m_SwapChain->getDepthFormat();
+        return target;
+    }
+
+    void DynamicResolution::cmdBeginComposition(VkCommandBuffer commandBuffer, u32 imageIndex) {
+        // only UI is drawn on top of upscaled scene, so it needs no depth
+        if (m_SwapChain->isDynamicRendering()) {
+            RenderingTarget target = m_SwapChain->getRenderingTarget(imageIndex);
+            target.depthImage = VK_NULL_HANDLE;
+            target.depthView = VK_NULL_HANDLE;
+            cmdBeginRendering(m_SwapChain->getDevice(), commandBuffer, target, m_SwapChain->getExtent(), compositionInfo());
+            return;
+        }
+
+        // setup info
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = m_CompositionRenderPass->getHandle();
+        renderPassInfo.framebuffer = m_SwapChain->getFrameBuffer(imageIndex);
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = m_SwapChain->getExtent();
+        // color is loaded, only depth is cleared
+        VkClearValue clearValues[2];
+        clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        clearValues[1].depthStencil = {1.0f, 0};
+        renderPassInfo.clearValueCount = 2;
+        renderPassInfo.pClearValues = clearValues;
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    }
+
+}
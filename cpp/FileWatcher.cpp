@@ -0,0 +1,147 @@
+#include <FileWatcher.h>
+
+#include <sys/stat.h>
+#include <algorithm>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace rdk {
+
+    FileWatcher::~FileWatcher() {
+        destroy();
+    }
+
+    void FileWatcher::create(u32 pollIntervalMs) {
+        m_PollInterval = std::chrono::milliseconds(pollIntervalMs);
+        m_LastPoll = std::chrono::steady_clock::now();
+        m_Active = true;
+#ifdef __linux__
+        m_Fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_Fd < 0) {
+            std::cerr << "FileWatcher::create: inotify is not available, polling file stamps" << std::endl;
+        }
+#endif
+    }
+
+    void FileWatcher::destroy() {
+#ifdef __linux__
+        if (m_Fd >= 0) {
+            close(m_Fd);
+        }
+#endif
+        m_Fd = -1;
+        m_Active = false;
+        m_Files.clear();
+        m_Directories.clear();
+    }
+
+    FileWatcher::FileStamp FileWatcher::stamp(const std::string& filepath) {
+        FileStamp fileStamp;
+        struct stat info {};
+        if (stat(filepath.c_str(), &info) == 0) {
+            fileStamp.exists = true;
+            fileStamp.modifiedTime = static_cast<u64>(info.st_mtime);
+            fileStamp.size = static_cast<u64>(info.st_size);
+        }
+        return fileStamp;
+    }
+
+    void FileWatcher::watch(const std::string& filepath) {
+        if (!m_Active || m_Files.find(filepath) != m_Files.end()) {
+            return;
+        }
+
+        m_Files[filepath] = stamp(filepath);
+
+#ifdef __linux__
+        if (m_Fd < 0) {
+            return;
+        }
+
+        // watch directory instead of file, so file replaced by rename keeps being watched
+        size_t slash = filepath.find_last_of("/\\");
+        std::string prefix = slash == std::string::npos ? "" : filepath.substr(0, slash + 1);
+        std::string directory = prefix.empty() ? "." : prefix;
+
+        int wd = inotify_add_watch(m_Fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0) {
+            std::cerr << "FileWatcher::watch: failed to watch " << directory << ": " << strerror(errno) << std::endl;
+            return;
+        }
+        m_Directories[wd] = prefix;
+#endif
+    }
+
+    std::vector<std::string> FileWatcher::poll() {
+        if (!m_Active) {
+            return {};
+        }
+        return m_Fd >= 0 ? pollNotify() : pollStamps();
+    }
+
+    std::vector<std::string> FileWatcher::pollStamps() {
+        std::vector<std::string> changed;
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - m_LastPoll < m_PollInterval) {
+            return changed;
+        }
+        m_LastPoll = now;
+
+        for (auto& file : m_Files) {
+            FileStamp current = stamp(file.first);
+            // file may be missing for a moment while editor rewrites it
+            if (!current.exists) {
+                continue;
+            }
+            if (!file.second.exists || current.modifiedTime != file.second.modifiedTime || current.size != file.second.size) {
+                file.second = current;
+                changed.emplace_back(file.first);
+            }
+        }
+
+        return changed;
+    }
+
+    std::vector<std::string> FileWatcher::pollNotify() {
+        std::vector<std::string> changed;
+
+#ifdef __linux__
+        alignas(inotify_event) char buffer[4096];
+        while (true) {
+            ssize_t length = read(m_Fd, buffer, sizeof(buffer));
+            if (length <= 0) {
+                break;
+            }
+
+            for (ssize_t offset = 0 ; offset < length ; ) {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                auto directory = m_Directories.find(event->wd);
+                if (directory == m_Directories.end() || event->len == 0) {
+                    continue;
+                }
+
+                std::string filepath = directory->second + event->name;
+                if (m_Files.find(filepath) == m_Files.end()) {
+                    continue;
+                }
+                // editors often write file several times in a row
+                if (std::find(changed.begin(), changed.end(), filepath) == changed.end()) {
+                    changed.emplace_back(std::move(filepath));
+                }
+            }
+        }
+#endif
+
+        return changed;
+    }
+
+}
@@ -1,5 +1,7 @@
 #include <FrameBuffer.h>
 
+#include <utility>
+
 namespace rdk {
 
     FrameBuffer::FrameBuffer(
@@ -23,7 +25,29 @@ namespace rdk {
     }
 
     FrameBuffer::~FrameBuffer() {
+        release();
+    }
+
+    FrameBuffer::FrameBuffer(FrameBuffer&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    FrameBuffer& FrameBuffer::operator=(FrameBuffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            m_Handle = other.m_Handle;
+            m_Device = other.m_Device;
+            other.m_Handle = VK_NULL_HANDLE;
+        }
+        return *this;
+    }
+
+    void FrameBuffer::release() {
+        if (m_Handle == VK_NULL_HANDLE)
+            return;
+
         vkDestroyFramebuffer(m_Device, m_Handle, nullptr);
+        m_Handle = VK_NULL_HANDLE;
     }
 
 }
@@ -1,13 +1,25 @@
 #include <Image.h>
+#include <PixelConvert.h>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
 #include <stdexcept>
 #include <cmath>
+#include <utility>
 
 namespace rdk {
 
+    static bool hasMemoryType(VkPhysicalDevice physicalDevice, u32 typeFilter, VkMemoryPropertyFlags props) {
+        VkPhysicalDeviceMemoryProperties memProperties;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+        for (u32 i = 0 ; i < memProperties.memoryTypeCount ; i++) {
+            if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & props) == props)
+                return true;
+        }
+        return false;
+    }
+
     Image::Image(
             VkDevice device,
             VkPhysicalDevice physicalDevice,
@@ -28,20 +40,27 @@ namespace rdk {
         imageInfo.usage = info.usage;
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-        imageInfo.flags = 0; // Optional
+        imageInfo.flags = info.flags;
         auto status = vkCreateImage(device, &imageInfo, nullptr, &m_Handle);
         rect_assert(status == VK_SUCCESS, "Failed to create a Vulkan image")
 
         // allocate memory
         VkMemoryRequirements memRequirements;
         vkGetImageMemoryRequirements(device, m_Handle, &memRequirements);
+        // contents of transient attachment never leave tile memory on tiled GPUs,
+        // so lazily allocated memory may never be committed at all. Desktop GPUs have no such memory.
+        VkMemoryPropertyFlags properties = info.properties;
+        VkMemoryPropertyFlags lazyProperties = properties | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+        if ((info.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) && hasMemoryType(physicalDevice, memRequirements.memoryTypeBits, lazyProperties)) {
+            properties = lazyProperties;
+        }
         VkMemoryAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
         allocInfo.allocationSize = memRequirements.size;
         allocInfo.memoryTypeIndex = Buffer::findMemoryType(
                 physicalDevice,
                 memRequirements.memoryTypeBits,
-                info.properties
+                properties
         );
 
         auto memoryStatus = vkAllocateMemory(device, &allocInfo, nullptr, &m_Memory);
@@ -57,20 +76,70 @@ namespace rdk {
     }
 
     Image::~Image() {
+        release();
+    }
+
+    Image::Image(Image&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    Image& Image::operator=(Image&& other) noexcept {
+        if (this != &other) {
+            release();
+            m_Handle = other.m_Handle;
+            m_Memory = other.m_Memory;
+            m_Device = other.m_Device;
+            other.m_Handle = VK_NULL_HANDLE;
+            other.m_Memory = VK_NULL_HANDLE;
+        }
+        return *this;
+    }
+
+    void Image::release() {
+        if (m_Handle == VK_NULL_HANDLE)
+            return;
+
         vkDestroyImage(m_Device, m_Handle, nullptr);
         freeMemory();
+        m_Handle = VK_NULL_HANDLE;
+        m_Memory = VK_NULL_HANDLE;
     }
 
-    ImageData ImageLoader::load(const char *filepath, VkDevice device, VkPhysicalDevice physicalDevice) {
-        int texWidth, texHeight, texChannels;
-        stbi_uc* pixels = stbi_load(filepath, &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-        VkDeviceSize imageSize = texWidth * texHeight * 4;
-        u32 mipLevels = std::floor(std::log2(std::max(texWidth, texHeight))) + 1;
+    // stb expands RGB -> RGBA with scalar code, so 3 channel images are decoded as is and expanded with SIMD
+    static stbi_uc* loadPixels(const char* filepath, int* width, int* height, int* channels) {
+        int fileChannels = 0;
+        if (stbi_info(filepath, width, height, &fileChannels) && fileChannels == 3) {
+            return stbi_load(filepath, width, height, channels, STBI_rgb);
+        }
+        return stbi_load(filepath, width, height, channels, STBI_rgb_alpha);
+    }
 
+    static void copyRGBA(const stbi_uc* pixels, int channels, void* dst, size_t pixelCount) {
+        if (channels == 3) {
+            PixelConvert::expandRGBToRGBA(pixels, static_cast<u8*>(dst), pixelCount);
+        } else {
+            memcpy(dst, pixels, pixelCount * 4);
+        }
+    }
+
+    static stbi_uc* loadPixels(const u8* data, size_t size, int* width, int* height, int* channels) {
+        int fileChannels = 0;
+        int length = static_cast<int>(size);
+        if (stbi_info_from_memory(data, length, width, height, &fileChannels) && fileChannels == 3) {
+            return stbi_load_from_memory(data, length, width, height, channels, STBI_rgb);
+        }
+        return stbi_load_from_memory(data, length, width, height, channels, STBI_rgb_alpha);
+    }
+
+    static ImageData stagePixels(stbi_uc* pixels, int texWidth, int texHeight, int texChannels,
+                                 VkDevice device, VkPhysicalDevice physicalDevice) {
         if (!pixels) {
             throw std::runtime_error("failed to load texture image!");
         }
 
+        VkDeviceSize imageSize = VkDeviceSize(texWidth) * texHeight * 4;
+        u32 mipLevels = ImageLoader::mipLevels(texWidth, texHeight);
+
         // create stage buffer
         Buffer stageBuffer{};
         stageBuffer.create(
@@ -81,7 +150,7 @@ namespace rdk {
         );
         // copy data into stage buffer
         void* block = stageBuffer.mapMemory(imageSize);
-        memcpy(block, pixels, imageSize);
+        copyRGBA(pixels, texChannels, block, size_t(texWidth) * texHeight);
         stageBuffer.unmapMemory();
 
         // free image pixels
@@ -96,6 +165,67 @@ namespace rdk {
         };
     }
 
+    static bool decodePixels(stbi_uc* pixels, int texWidth, int texHeight, int texChannels, void* dst, VkDeviceSize size) {
+        if (!pixels)
+            return false;
+
+        VkDeviceSize imageSize = VkDeviceSize(texWidth) * texHeight * 4;
+        bool fits = imageSize <= size;
+        if (fits)
+            copyRGBA(pixels, texChannels, dst, size_t(texWidth) * texHeight);
+
+        stbi_image_free(pixels);
+        return fits;
+    }
+
+    ImageData ImageLoader::load(const char *filepath, VkDevice device, VkPhysicalDevice physicalDevice) {
+        int texWidth, texHeight, texChannels;
+        stbi_uc* pixels = loadPixels(filepath, &texWidth, &texHeight, &texChannels);
+        return stagePixels(pixels, texWidth, texHeight, texChannels, device, physicalDevice);
+    }
+
+    ImageData ImageLoader::load(const u8* data, size_t size, VkDevice device, VkPhysicalDevice physicalDevice) {
+        int texWidth, texHeight, texChannels;
+        stbi_uc* pixels = loadPixels(data, size, &texWidth, &texHeight, &texChannels);
+        return stagePixels(pixels, texWidth, texHeight, texChannels, device, physicalDevice);
+    }
+
+    bool ImageLoader::info(const char* filepath, u32* width, u32* height) {
+        int texWidth, texHeight, texChannels;
+        if (!stbi_info(filepath, &texWidth, &texHeight, &texChannels))
+            return false;
+
+        *width = static_cast<u32>(texWidth);
+        *height = static_cast<u32>(texHeight);
+        return true;
+    }
+
+    bool ImageLoader::info(const u8* data, size_t size, u32* width, u32* height) {
+        int texWidth, texHeight, texChannels;
+        if (!stbi_info_from_memory(data, static_cast<int>(size), &texWidth, &texHeight, &texChannels))
+            return false;
+
+        *width = static_cast<u32>(texWidth);
+        *height = static_cast<u32>(texHeight);
+        return true;
+    }
+
+    bool ImageLoader::decode(const char* filepath, void* dst, VkDeviceSize size) {
+        int texWidth, texHeight, texChannels;
+        stbi_uc* pixels = loadPixels(filepath, &texWidth, &texHeight, &texChannels);
+        return decodePixels(pixels, texWidth, texHeight, texChannels, dst, size);
+    }
+
+    bool ImageLoader::decode(const u8* data, size_t size, void* dst, VkDeviceSize dstSize) {
+        int texWidth, texHeight, texChannels;
+        stbi_uc* pixels = loadPixels(data, size, &texWidth, &texHeight, &texChannels);
+        return decodePixels(pixels, texWidth, texHeight, texChannels, dst, dstSize);
+    }
+
+    u32 ImageLoader::mipLevels(u32 width, u32 height) {
+        return static_cast<u32>(std::floor(std::log2(std::max(width, height)))) + 1;
+    }
+
     ImageView::ImageView(VkDevice device, VkImage image, const ImageViewInfo& info) {
         m_Device = device;
 
@@ -113,12 +243,41 @@ namespace rdk {
         createInfo.format = info.format;
         createInfo.subresourceRange = subresourceRange;
 
+        VkImageViewUsageCreateInfo usageInfo{};
+        if (info.usage != 0) {
+            usageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO;
+            usageInfo.usage = info.usage;
+            createInfo.pNext = &usageInfo;
+        }
+
         auto status = vkCreateImageView(m_Device, &createInfo, nullptr, &m_Handle);
         rect_assert(status == VK_SUCCESS, "Failed to create Vulkan image view")
     }
 
     ImageView::~ImageView() {
+        release();
+    }
+
+    ImageView::ImageView(ImageView&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    ImageView& ImageView::operator=(ImageView&& other) noexcept {
+        if (this != &other) {
+            release();
+            m_Handle = other.m_Handle;
+            m_Device = other.m_Device;
+            other.m_Handle = VK_NULL_HANDLE;
+        }
+        return *this;
+    }
+
+    void ImageView::release() {
+        if (m_Handle == VK_NULL_HANDLE)
+            return;
+
         vkDestroyImageView(m_Device, m_Handle, nullptr);
+        m_Handle = VK_NULL_HANDLE;
     }
 
     ImageSampler::ImageSampler(
@@ -160,6 +319,28 @@ namespace rdk {
     }
 
     ImageSampler::~ImageSampler() {
+        release();
+    }
+
+    ImageSampler::ImageSampler(ImageSampler&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    ImageSampler& ImageSampler::operator=(ImageSampler&& other) noexcept {
+        if (this != &other) {
+            release();
+            m_Handle = other.m_Handle;
+            m_Device = other.m_Device;
+            other.m_Handle = VK_NULL_HANDLE;
+        }
+        return *this;
+    }
+
+    void ImageSampler::release() {
+        if (m_Handle == VK_NULL_HANDLE)
+            return;
+
         vkDestroySampler(m_Device, m_Handle, nullptr);
+        m_Handle = VK_NULL_HANDLE;
     }
 }
\ No newline at end of file
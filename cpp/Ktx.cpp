@@ -0,0 +1,267 @@
+#include <Ktx.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+
+namespace rdk {
+
+    static const u8 KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    struct KtxHeader final {
+        u8 identifier[12];
+        u32 vkFormat;
+        u32 typeSize;
+        u32 pixelWidth;
+        u32 pixelHeight;
+        u32 pixelDepth;
+        u32 layerCount;
+        u32 faceCount;
+        u32 levelCount;
+        u32 supercompressionScheme;
+        // index
+        u32 dfdByteOffset;
+        u32 dfdByteLength;
+        u32 kvdByteOffset;
+        u32 kvdByteLength;
+        u64 sgdByteOffset;
+        u64 sgdByteLength;
+    };
+
+    struct KtxLevelIndex final {
+        u64 byteOffset;
+        u64 byteLength;
+        u64 uncompressedByteLength;
+    };
+
+    static_assert(sizeof(KtxHeader) == 80, "KTX2 header must be 80 bytes");
+    static_assert(sizeof(KtxLevelIndex) == 24, "KTX2 level index entry must be 24 bytes");
+
+    // Khronos data format descriptor color models
+    enum KtxColorModel : u32 {
+        KTX_MODEL_RGBSDA = 1,
+        KTX_MODEL_BC1A = 128,
+        KTX_MODEL_BC3 = 130,
+        KTX_MODEL_BC4 = 131,
+        KTX_MODEL_BC5 = 132,
+        KTX_MODEL_BC7 = 134
+    };
+
+    struct KtxFormatInfo final {
+        u32 colorModel;
+        u32 blockDimension;
+        u32 blockBytes;
+        bool srgb;
+    };
+
+    static KtxFormatInfo getFormatInfo(VkFormat format) {
+        switch (format) {
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK: return { KTX_MODEL_BC1A, 4, 8, false };
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK: return { KTX_MODEL_BC1A, 4, 8, true };
+            case VK_FORMAT_BC3_UNORM_BLOCK: return { KTX_MODEL_BC3, 4, 16, false };
+            case VK_FORMAT_BC3_SRGB_BLOCK: return { KTX_MODEL_BC3, 4, 16, true };
+            case VK_FORMAT_BC4_UNORM_BLOCK: return { KTX_MODEL_BC4, 4, 8, false };
+            case VK_FORMAT_BC5_UNORM_BLOCK: return { KTX_MODEL_BC5, 4, 16, false };
+            case VK_FORMAT_BC7_UNORM_BLOCK: return { KTX_MODEL_BC7, 4, 16, false };
+            case VK_FORMAT_BC7_SRGB_BLOCK: return { KTX_MODEL_BC7, 4, 16, true };
+            case VK_FORMAT_R8G8B8A8_UNORM: return { KTX_MODEL_RGBSDA, 1, 4, false };
+            case VK_FORMAT_R8G8B8A8_SRGB: return { KTX_MODEL_RGBSDA, 1, 4, true };
+            default:
+                throw std::runtime_error("KtxFile: unsupported Vulkan format");
+        }
+    }
+
+    bool KtxFile::isKtx2(const u8* data, size_t size) {
+        return size >= sizeof(KtxHeader) && memcmp(data, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0;
+    }
+
+    bool KtxFile::hasKtx2Extension(const char* filepath) {
+        static const char extension[] = ".ktx2";
+        size_t length = strlen(filepath);
+        size_t extensionLength = sizeof(extension) - 1;
+        return length >= extensionLength && strcmp(filepath + length - extensionLength, extension) == 0;
+    }
+
+    KtxTexture KtxFile::load(const char* filepath) {
+        std::ifstream file(filepath, std::ios::ate | std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("KtxFile::load: failed to open texture file!");
+        }
+
+        size_t fileSize = (size_t) file.tellg();
+        std::vector<u8> buffer(fileSize);
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(buffer.data()), fileSize);
+        file.close();
+
+        return parse(buffer.data(), buffer.size());
+    }
+
+    KtxTexture KtxFile::parse(const u8* data, size_t size) {
+        KtxTexture texture = parseIndex(data, size, size);
+
+        // levels are copied tightly in level order, so uploads can use one staging buffer as is
+        u64 totalSize = 0;
+        std::vector<u64> containerOffsets(texture.levels.size());
+        for (size_t i = 0 ; i < texture.levels.size() ; i++) {
+            KtxLevel& level = texture.levels[i];
+            containerOffsets[i] = level.offset;
+            level.offset = totalSize;
+            // keep offsets aligned for vkCmdCopyBufferToImage (multiple of texel block size and 4)
+            totalSize += (level.size + 15) & ~u64(15);
+        }
+
+        texture.data.resize(totalSize);
+        for (size_t i = 0 ; i < texture.levels.size() ; i++) {
+            memcpy(texture.data.data() + texture.levels[i].offset, data + containerOffsets[i], texture.levels[i].size);
+        }
+
+        return texture;
+    }
+
+    KtxTexture KtxFile::parseIndex(const u8* data, size_t size, size_t containerSize) {
+        if (!isKtx2(data, size)) {
+            throw std::runtime_error("KtxFile::parse: not a KTX2 container!");
+        }
+
+        KtxHeader header;
+        memcpy(&header, data, sizeof(header));
+
+        if (header.supercompressionScheme != 0) {
+            throw std::runtime_error("KtxFile::parse: supercompressed KTX2 is not supported!");
+        }
+        if (header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1) {
+            throw std::runtime_error("KtxFile::parse: only single layer 2D textures are supported!");
+        }
+
+        u32 levelCount = std::max(header.levelCount, 1u);
+        if (levelCount > 32 || sizeof(KtxHeader) + levelCount * sizeof(KtxLevelIndex) > size) {
+            throw std::runtime_error("KtxFile::parse: truncated level index!");
+        }
+
+        KtxTexture texture;
+        texture.format = static_cast<VkFormat>(header.vkFormat);
+        texture.width = header.pixelWidth;
+        texture.height = std::max(header.pixelHeight, 1u);
+        texture.levels.resize(levelCount);
+
+        std::vector<KtxLevelIndex> levelIndices(levelCount);
+        memcpy(levelIndices.data(), data + sizeof(KtxHeader), levelCount * sizeof(KtxLevelIndex));
+        for (u32 i = 0 ; i < levelCount ; i++) {
+            const KtxLevelIndex& index = levelIndices[i];
+            if (index.byteOffset > containerSize || index.byteLength > containerSize - index.byteOffset) {
+                throw std::runtime_error("KtxFile::parse: level data is out of file bounds!");
+            }
+
+            KtxLevel& level = texture.levels[i];
+            level.offset = index.byteOffset;
+            level.size = index.byteLength;
+            level.width = std::max(texture.width >> i, 1u);
+            level.height = std::max(texture.height >> i, 1u);
+        }
+
+        return texture;
+    }
+
+    struct KtxSample final {
+        u32 bitOffset;
+        u32 bitLength;
+        u32 channel;
+    };
+
+    // alpha is stored as channel id 15 and never sRGB encoded
+    static constexpr u32 KTX_CHANNEL_ALPHA = 15;
+    static constexpr u32 KTX_SAMPLE_LINEAR = 0x10;
+
+    static std::vector<KtxSample> getSamples(const KtxFormatInfo& info) {
+        switch (info.colorModel) {
+            case KTX_MODEL_RGBSDA: return { { 0, 8, 0 }, { 8, 8, 1 }, { 16, 8, 2 }, { 24, 8, KTX_CHANNEL_ALPHA } };
+            // alpha block precedes color block
+            case KTX_MODEL_BC3: return { { 0, 64, KTX_CHANNEL_ALPHA }, { 64, 64, 0 } };
+            case KTX_MODEL_BC5: return { { 0, 64, 0 }, { 64, 64, 1 } };
+            default: return { { 0, info.blockBytes * 8, 0 } };
+        }
+    }
+
+    static void writeBasicDfd(std::vector<u32>& words, VkFormat format) {
+        KtxFormatInfo info = getFormatInfo(format);
+        bool uncompressed = info.colorModel == KTX_MODEL_RGBSDA;
+        std::vector<KtxSample> samples = getSamples(info);
+        u32 blockSize = 24 + 16 * static_cast<u32>(samples.size());
+
+        words.push_back(4 + blockSize);                                  // dfdTotalSize
+        words.push_back(0);                                              // vendorId = Khronos, descriptorType = basic
+        words.push_back(2 | (blockSize << 16));                          // versionNumber, descriptorBlockSize
+        words.push_back(info.colorModel | (1 << 8) | ((info.srgb ? 2u : 1u) << 16)); // model, BT709 primaries, transfer
+        u32 dimension = info.blockDimension - 1;
+        words.push_back(dimension | (dimension << 8));                   // texel block dimensions
+        words.push_back(info.blockBytes);                                // bytesPlane0
+        words.push_back(0);                                              // bytesPlane4..7
+
+        for (const KtxSample& sample : samples) {
+            u32 channelType = sample.channel;
+            if (sample.channel == KTX_CHANNEL_ALPHA && info.srgb) {
+                channelType |= KTX_SAMPLE_LINEAR;
+            }
+            words.push_back(sample.bitOffset | ((sample.bitLength - 1) << 16) | (channelType << 24));
+            words.push_back(0);                                          // sample positions
+            words.push_back(0);                                          // sampleLower
+            words.push_back(uncompressed ? 255 : UINT32_MAX);            // sampleUpper
+        }
+    }
+
+    std::vector<u8> KtxFile::serialize(const KtxTexture& texture) {
+        u32 levelCount = static_cast<u32>(texture.levels.size());
+
+        std::vector<u32> dfd;
+        writeBasicDfd(dfd, texture.format);
+
+        KtxHeader header {};
+        memcpy(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+        header.vkFormat = texture.format;
+        // all supported formats are either block compressed or 8 bit per channel
+        header.typeSize = 1;
+        header.pixelWidth = texture.width;
+        header.pixelHeight = texture.height;
+        header.pixelDepth = 0;
+        header.layerCount = 0;
+        header.faceCount = 1;
+        header.levelCount = levelCount;
+        header.supercompressionScheme = 0;
+        header.dfdByteOffset = static_cast<u32>(sizeof(KtxHeader) + levelCount * sizeof(KtxLevelIndex));
+        header.dfdByteLength = static_cast<u32>(dfd.size() * sizeof(u32));
+
+        std::vector<KtxLevelIndex> levelIndices(levelCount);
+        u64 offset = header.dfdByteOffset + header.dfdByteLength;
+        // smallest levels go first, as the spec recommends for streaming
+        for (u32 i = levelCount ; i-- > 0 ;) {
+            offset = (offset + 15) & ~u64(15);
+            levelIndices[i].byteOffset = offset;
+            levelIndices[i].byteLength = texture.levels[i].size;
+            levelIndices[i].uncompressedByteLength = texture.levels[i].size;
+            offset += texture.levels[i].size;
+        }
+
+        std::vector<u8> file(offset, 0);
+        memcpy(file.data(), &header, sizeof(header));
+        memcpy(file.data() + sizeof(header), levelIndices.data(), levelCount * sizeof(KtxLevelIndex));
+        memcpy(file.data() + header.dfdByteOffset, dfd.data(), header.dfdByteLength);
+        for (u32 i = 0 ; i < levelCount ; i++) {
+            memcpy(file.data() + levelIndices[i].byteOffset, texture.data.data() + texture.levels[i].offset, texture.levels[i].size);
+        }
+
+        return file;
+    }
+
+    void KtxFile::save(const char* filepath, const KtxTexture& texture) {
+        std::vector<u8> file = serialize(texture);
+
+        std::ofstream stream(filepath, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) {
+            throw std::runtime_error("KtxFile::save: failed to open file for writing!");
+        }
+        stream.write(reinterpret_cast<const char*>(file.data()), file.size());
+    }
+
+}
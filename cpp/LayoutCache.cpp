@@ -0,0 +1,92 @@
+#include <LayoutCache.h>
+#include <AssetPack.h>
+
+namespace rdk {
+
+    size_t LayoutCache::KeyHash::operator()(const Key& key) const {
+        return static_cast<size_t>(AssetPack::hashName(reinterpret_cast<const char*>(key.data()), key.size() * sizeof(u32)));
+    }
+
+    void LayoutCache::create(VkDevice device) {
+        m_Device = device;
+    }
+
+    void LayoutCache::destroy() {
+        for (auto& layout : m_PipelineLayouts) {
+            vkDestroyPipelineLayout(m_Device, layout.second, nullptr);
+        }
+        m_PipelineLayouts.clear();
+        for (auto& layout : m_DescriptorLayouts) {
+            vkDestroyDescriptorSetLayout(m_Device, layout.second, nullptr);
+        }
+        m_DescriptorLayouts.clear();
+    }
+
+    VkDescriptorSetLayout LayoutCache::getDescriptorLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings) {
+        Key key;
+        key.reserve(bindings.size() * 4);
+        for (const auto& binding : bindings) {
+            key.push_back(binding.binding);
+            key.push_back(binding.descriptorType);
+            key.push_back(binding.descriptorCount);
+            key.push_back(binding.stageFlags);
+        }
+
+        auto it = m_DescriptorLayouts.find(key);
+        if (it != m_DescriptorLayouts.end())
+            return it->second;
+
+        // setup info
+        VkDescriptorSetLayoutCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        info.bindingCount = static_cast<u32>(bindings.size());
+        info.pBindings = bindings.data();
+
+        VkDescriptorSetLayout layout;
+        auto status = vkCreateDescriptorSetLayout(m_Device, &info, nullptr, &layout);
+        rect_assert(status == VK_SUCCESS, "Failed to create Vulkan descriptor set layout")
+
+        m_DescriptorLayouts.emplace(std::move(key), layout);
+        return layout;
+    }
+
+    VkPipelineLayout LayoutCache::getPipelineLayout(
+            const std::vector<VkDescriptorSetLayout>& setLayouts,
+            const std::vector<VkPushConstantRange>& pushConstants
+    ) {
+        // set layouts come from this cache, so their handles identify their bindings
+        Key key;
+        key.reserve(1 + setLayouts.size() * 2 + pushConstants.size() * 3);
+        key.push_back(static_cast<u32>(setLayouts.size()));
+        for (VkDescriptorSetLayout setLayout : setLayouts) {
+            u64 handle = reinterpret_cast<u64>(setLayout);
+            key.push_back(static_cast<u32>(handle));
+            key.push_back(static_cast<u32>(handle >> 32));
+        }
+        for (const auto& range : pushConstants) {
+            key.push_back(range.stageFlags);
+            key.push_back(range.offset);
+            key.push_back(range.size);
+        }
+
+        auto it = m_PipelineLayouts.find(key);
+        if (it != m_PipelineLayouts.end())
+            return it->second;
+
+        // setup info
+        VkPipelineLayoutCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        info.setLayoutCount = static_cast<u32>(setLayouts.size());
+        info.pSetLayouts = setLayouts.data();
+        info.pushConstantRangeCount = static_cast<u32>(pushConstants.size());
+        info.pPushConstantRanges = pushConstants.data();
+
+        VkPipelineLayout layout;
+        auto status = vkCreatePipelineLayout(m_Device, &info, nullptr, &layout);
+        rect_assert(status == VK_SUCCESS, "Failed to create Vulkan pipeline layout")
+
+        m_PipelineLayouts.emplace(std::move(key), layout);
+        return layout;
+    }
+
+}
@@ -0,0 +1,184 @@
+#include <Lz4.h>
+
+#include <vector>
+#include <cstring>
+
+namespace rdk {
+
+    static const size_t MIN_MATCH = 4;
+    // last match must start at least 12 bytes before end, last 5 bytes are always literals
+    static const size_t MF_LIMIT = 12;
+    static const size_t LAST_LITERALS = 5;
+    static const size_t MAX_DISTANCE = 65535;
+    static const u32 HASH_LOG = 16;
+
+    static inline u32 read32(const u8* src) {
+        u32 value;
+        memcpy(&value, src, sizeof(value));
+        return value;
+    }
+
+    static inline u32 hashSequence(u32 sequence) {
+        return (sequence * 2654435761u) >> (32 - HASH_LOG);
+    }
+
+    static inline u8* writeLength(u8* op, size_t length) {
+        while (length >= 255) {
+            *op++ = 255;
+            length -= 255;
+        }
+        *op++ = static_cast<u8>(length);
+        return op;
+    }
+
+    static u8* writeSequence(u8* op, const u8* literals, size_t literalLength, size_t offset, size_t matchLength) {
+        u8* token = op++;
+        u8 literalToken = literalLength >= 15 ? 15 : static_cast<u8>(literalLength);
+        if (literalLength >= 15) {
+            op = writeLength(op, literalLength - 15);
+        }
+        if (literalLength > 0) {
+            memcpy(op, literals, literalLength);
+        }
+        op += literalLength;
+
+        if (matchLength == 0) {
+            *token = static_cast<u8>(literalToken << 4);
+            return op;
+        }
+
+        *op++ = static_cast<u8>(offset);
+        *op++ = static_cast<u8>(offset >> 8);
+
+        size_t matchCode = matchLength - MIN_MATCH;
+        u8 matchToken = matchCode >= 15 ? 15 : static_cast<u8>(matchCode);
+        if (matchCode >= 15) {
+            op = writeLength(op, matchCode - 15);
+        }
+
+        *token = static_cast<u8>((literalToken << 4) | matchToken);
+        return op;
+    }
+
+    size_t Lz4::compressBound(size_t srcSize) {
+        return srcSize + srcSize / 255 + 16;
+    }
+
+    size_t Lz4::compress(const u8* src, size_t srcSize, u8* dst, size_t dstCapacity) {
+        if (dstCapacity < compressBound(srcSize))
+            return 0;
+
+        u8* op = dst;
+        size_t anchor = 0;
+
+        if (srcSize > MF_LIMIT) {
+            // positions of last seen 4 byte sequences, greedy single probe like LZ4 fast mode
+            std::vector<u32> table(size_t(1) << HASH_LOG, 0);
+            size_t matchLimit = srcSize - LAST_LITERALS;
+            size_t ip = 1;
+
+            while (ip < srcSize - MF_LIMIT) {
+                u32 sequence = read32(src + ip);
+                u32 hash = hashSequence(sequence);
+                size_t candidate = table[hash];
+                table[hash] = static_cast<u32>(ip);
+
+                if (candidate >= ip || ip - candidate > MAX_DISTANCE || read32(src + candidate) != sequence) {
+                    // skip faster through incompressible data
+                    ip += 1 + ((ip - anchor) >> 6);
+                    continue;
+                }
+
+                while (ip > anchor && candidate > 0 && src[ip - 1] == src[candidate - 1]) {
+                    ip--;
+                    candidate--;
+                }
+
+                size_t matchLength = MIN_MATCH;
+                while (ip + matchLength < matchLimit && src[candidate + matchLength] == src[ip + matchLength]) {
+                    matchLength++;
+                }
+
+                op = writeSequence(op, src + anchor, ip - anchor, ip - candidate, matchLength);
+                ip += matchLength;
+                anchor = ip;
+
+                if (ip - 2 < srcSize - MF_LIMIT) {
+                    table[hashSequence(read32(src + ip - 2))] = static_cast<u32>(ip - 2);
+                }
+            }
+        }
+
+        op = writeSequence(op, src + anchor, srcSize - anchor, 0, 0);
+        return static_cast<size_t>(op - dst);
+    }
+
+    bool Lz4::decompress(const u8* src, size_t srcSize, u8* dst, size_t dstSize) {
+        size_t ip = 0;
+        size_t op = 0;
+
+        while (ip < srcSize) {
+            u8 token = src[ip++];
+
+            size_t literalLength = token >> 4;
+            if (literalLength == 15) {
+                u8 extra;
+                do {
+                    if (ip >= srcSize)
+                        return false;
+                    extra = src[ip++];
+                    literalLength += extra;
+                } while (extra == 255);
+            }
+
+            if (literalLength > srcSize - ip || literalLength > dstSize - op)
+                return false;
+            if (literalLength > 0) {
+                memcpy(dst + op, src + ip, literalLength);
+            }
+            ip += literalLength;
+            op += literalLength;
+
+            // last sequence has literals only
+            if (ip == srcSize)
+                break;
+
+            if (srcSize - ip < 2)
+                return false;
+            size_t offset = src[ip] | (size_t(src[ip + 1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > op)
+                return false;
+
+            size_t matchLength = token & 15;
+            if (matchLength == 15) {
+                u8 extra;
+                do {
+                    if (ip >= srcSize)
+                        return false;
+                    extra = src[ip++];
+                    matchLength += extra;
+                } while (extra == 255);
+            }
+            matchLength += MIN_MATCH;
+
+            if (matchLength > dstSize - op)
+                return false;
+
+            u8* out = dst + op;
+            const u8* match = out - offset;
+            if (offset >= matchLength) {
+                memcpy(out, match, matchLength);
+            } else {
+                // overlapping copy repeats the last offset bytes
+                for (size_t i = 0 ; i < matchLength ; i++) {
+                    out[i] = match[i];
+                }
+            }
+            op += matchLength;
+        }
+
+        return op == dstSize;
+    }
+
+}
@@ -0,0 +1,341 @@
+#include <MeshLod.h>
+
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace rdk {
+
+    // symmetric 4x4 matrix of plane equation products
+    struct Quadric final {
+        double a2 = 0, ab = 0, ac = 0, ad = 0;
+        double b2 = 0, bc = 0, bd = 0;
+        double c2 = 0, cd = 0;
+        double d2 = 0;
+
+        void addPlane(double a, double b, double c, double d) {
+            a2 += a * a; ab += a * b; ac += a * c; ad += a * d;
+            b2 += b * b; bc += b * c; bd += b * d;
+            c2 += c * c; cd += c * d;
+            d2 += d * d;
+        }
+
+        void add(const Quadric& q) {
+            a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+            b2 += q.b2; bc += q.bc; bd += q.bd;
+            c2 += q.c2; cd += q.cd;
+            d2 += q.d2;
+        }
+
+        [[nodiscard]] double error(const glm::vec3& v) const {
+            double x = v.x, y = v.y, z = v.z;
+            double result = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+                    + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+                    + c2 * z * z + 2 * cd * z
+                    + d2;
+            return std::max(result, 0.0);
+        }
+    };
+
+    struct Collapse final {
+        double cost;
+        u32 from;
+        u32 to;
+        u32 fromVersion;
+        u32 toVersion;
+
+        bool operator>(const Collapse& other) const {
+            return cost > other.cost;
+        }
+    };
+
+    struct PositionKey final {
+        u32 x, y, z;
+
+        bool operator==(const PositionKey& other) const {
+            return x == other.x && y == other.y && z == other.z;
+        }
+    };
+
+    struct PositionKeyHash final {
+        size_t operator()(const PositionKey& key) const {
+            return (size_t(key.x) * 73856093u) ^ (size_t(key.y) * 19349663u) ^ (size_t(key.z) * 83492791u);
+        }
+    };
+
+    static inline glm::vec3 readPosition(const float* positions, u32 stride, u32 vertex) {
+        const float* p = reinterpret_cast<const float*>(reinterpret_cast<const u8*>(positions) + size_t(vertex) * stride);
+        return { p[0], p[1], p[2] };
+    }
+
+    static inline u64 edgeKey(u32 a, u32 b) {
+        return a < b ? (u64(a) << 32) | b : (u64(b) << 32) | a;
+    }
+
+    std::vector<u32> MeshSimplifier::simplify(
+            const float* positions, u32 vertexCount, u32 stride,
+            const u32* indices, u32 indexCount,
+            u32 targetIndexCount, float maxError,
+            float* resultError
+    ) {
+        u32 triangleCount = indexCount / 3;
+        std::vector<glm::vec3> points(vertexCount);
+        for (u32 i = 0 ; i < vertexCount ; i++) {
+            points[i] = readPosition(positions, stride, i);
+        }
+
+        // vertices sharing a position with another vertex are attribute seams, keep them in place
+        std::vector<bool> locked(vertexCount, false);
+        std::unordered_map<PositionKey, u32, PositionKeyHash> positionOwners;
+        for (u32 i = 0 ; i < vertexCount ; i++) {
+            PositionKey key;
+            memcpy(&key, &points[i], sizeof(key));
+            auto owner = positionOwners.emplace(key, i);
+            if (!owner.second) {
+                locked[i] = true;
+                locked[owner.first->second] = true;
+            }
+        }
+
+        // open boundary edges belong to one triangle only, collapsing them shrinks the silhouette
+        std::unordered_map<u64, u32> edgeUsage;
+        for (u32 t = 0 ; t < triangleCount ; t++) {
+            for (u32 e = 0 ; e < 3 ; e++) {
+                edgeUsage[edgeKey(indices[t * 3 + e], indices[t * 3 + (e + 1) % 3])]++;
+            }
+        }
+        for (const auto& edge : edgeUsage) {
+            if (edge.second == 1) {
+                locked[u32(edge.first >> 32)] = true;
+                locked[u32(edge.first & 0xFFFFFFFF)] = true;
+            }
+        }
+
+        // accumulate plane quadrics and triangle adjacency
+        std::vector<u32> triangles(indices, indices + triangleCount * 3);
+        std::vector<bool> triangleAlive(triangleCount, true);
+        std::vector<Quadric> quadrics(vertexCount);
+        std::vector<std::vector<u32>> vertexTriangles(vertexCount);
+        u32 aliveCount = triangleCount;
+
+        for (u32 t = 0 ; t < triangleCount ; t++) {
+            u32 i0 = triangles[t * 3], i1 = triangles[t * 3 + 1], i2 = triangles[t * 3 + 2];
+            vertexTriangles[i0].push_back(t);
+            vertexTriangles[i1].push_back(t);
+            vertexTriangles[i2].push_back(t);
+
+            glm::vec3 normal = glm::cross(points[i1] - points[i0], points[i2] - points[i0]);
+            float length = glm::length(normal);
+            if (length <= 0.0f)
+                continue;
+            normal /= length;
+
+            double d = -glm::dot(normal, points[i0]);
+            quadrics[i0].addPlane(normal.x, normal.y, normal.z, d);
+            quadrics[i1].addPlane(normal.x, normal.y, normal.z, d);
+            quadrics[i2].addPlane(normal.x, normal.y, normal.z, d);
+        }
+
+        std::vector<u32> versions(vertexCount, 0);
+        std::vector<bool> removed(vertexCount, false);
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> collapses;
+
+        auto pushCollapse = [&](u32 a, u32 b) {
+            Quadric q = quadrics[a];
+            q.add(quadrics[b]);
+            Collapse collapse {};
+            collapse.cost = -1;
+            if (!locked[a]) {
+                collapse = { q.error(points[b]), a, b, versions[a], versions[b] };
+            }
+            if (!locked[b]) {
+                double cost = q.error(points[a]);
+                if (collapse.cost < 0 || cost < collapse.cost) {
+                    collapse = { cost, b, a, versions[b], versions[a] };
+                }
+            }
+            if (collapse.cost >= 0) {
+                collapses.push(collapse);
+            }
+        };
+
+        for (const auto& edge : edgeUsage) {
+            pushCollapse(u32(edge.first >> 32), u32(edge.first & 0xFFFFFFFF));
+        }
+
+        auto flipsTriangle = [&](u32 from, u32 to) {
+            for (u32 t : vertexTriangles[from]) {
+                if (!triangleAlive[t])
+                    continue;
+
+                u32* triangle = &triangles[t * 3];
+                if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+                    continue;
+
+                glm::vec3 p[3], q[3];
+                for (u32 i = 0 ; i < 3 ; i++) {
+                    p[i] = points[triangle[i]];
+                    q[i] = triangle[i] == from ? points[to] : p[i];
+                }
+                glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+                if (glm::dot(before, after) <= 0.0f)
+                    return true;
+            }
+            return false;
+        };
+
+        double maxCost = double(maxError) * double(maxError);
+        double appliedCost = 0;
+
+        while (!collapses.empty() && aliveCount * 3 > targetIndexCount) {
+            Collapse collapse = collapses.top();
+            collapses.pop();
+
+            u32 from = collapse.from;
+            u32 to = collapse.to;
+            // entry was computed before one of its vertices changed
+            if (removed[from] || removed[to] || versions[from] != collapse.fromVersion || versions[to] != collapse.toVersion)
+                continue;
+
+            if (collapse.cost > maxCost)
+                break;
+
+            if (flipsTriangle(from, to))
+                continue;
+
+            for (u32 t : vertexTriangles[from]) {
+                if (!triangleAlive[t])
+                    continue;
+
+                u32* triangle = &triangles[t * 3];
+                if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+                    triangleAlive[t] = false;
+                    aliveCount--;
+                    continue;
+                }
+
+                for (u32 i = 0 ; i < 3 ; i++) {
+                    if (triangle[i] == from)
+                        triangle[i] = to;
+                }
+                vertexTriangles[to].push_back(t);
+            }
+            vertexTriangles[from].clear();
+
+            removed[from] = true;
+            quadrics[to].add(quadrics[from]);
+            versions[to]++;
+            appliedCost = std::max(appliedCost, collapse.cost);
+
+            // re-evaluate edges around the surviving vertex
+            std::unordered_set<u32> neighbours;
+            for (u32 t : vertexTriangles[to]) {
+                if (!triangleAlive[t])
+                    continue;
+
+                for (u32 i = 0 ; i < 3 ; i++) {
+                    u32 vertex = triangles[t * 3 + i];
+                    if (vertex != to)
+                        neighbours.insert(vertex);
+                }
+            }
+            for (u32 neighbour : neighbours) {
+                pushCollapse(to, neighbour);
+            }
+        }
+
+        std::vector<u32> result;
+        result.reserve(aliveCount * 3);
+        for (u32 t = 0 ; t < triangleCount ; t++) {
+            if (triangleAlive[t]) {
+                result.insert(result.end(), &triangles[t * 3], &triangles[t * 3] + 3);
+            }
+        }
+
+        if (resultError)
+            *resultError = static_cast<float>(std::sqrt(appliedCost));
+
+        return result;
+    }
+
+    LodChain MeshSimplifier::buildLodChain(
+            const float* positions, u32 vertexCount, u32 stride,
+            const u32* indices, u32 indexCount,
+            const LodSettings& settings
+    ) {
+        LodChain chain;
+        chain.indices.assign(indices, indices + indexCount);
+        chain.levels.push_back({ 0, indexCount, 0.0f });
+
+        std::vector<u32> source(indices, indices + indexCount);
+        float error = 0;
+
+        for (u32 level = 1 ; level < settings.maxLevels ; level++) {
+            u32 target = static_cast<u32>(float(source.size()) * settings.reduction) / 3 * 3;
+            if (target < settings.minIndexCount)
+                break;
+
+            float levelError = 0;
+            std::vector<u32> simplified = simplify(
+                    positions, vertexCount, stride,
+                    source.data(), static_cast<u32>(source.size()),
+                    target, settings.maxError, &levelError
+            );
+            // the mesh is locked by seams/borders or error limit, further levels are pointless
+            if (simplified.size() < settings.minIndexCount || float(simplified.size()) > float(source.size()) * 0.95f)
+                break;
+
+            // errors of consecutive collapses accumulate since each level starts from the previous one
+            error += levelError;
+
+            LodLevel lod;
+            lod.firstIndex = static_cast<u32>(chain.indices.size());
+            lod.indexCount = static_cast<u32>(simplified.size());
+            lod.error = error;
+            chain.levels.push_back(lod);
+            chain.indices.insert(chain.indices.end(), simplified.begin(), simplified.end());
+
+            source = std::move(simplified);
+        }
+
+        return chain;
+    }
+
+    u32 LodSelector::select(const LodObject& object, const LodView& view) {
+        const LodChain* chain = object.chain;
+        if (!chain || chain->levels.size() <= 1)
+            return 0;
+
+        float distance = glm::length(object.center - view.position) - object.radius * object.scale;
+        distance = std::max(distance, 1e-4f);
+        // world space length -> pixels at given distance
+        float pixelsPerUnit = view.viewportHeight / (2.0f * std::tan(view.fovY * 0.5f));
+
+        for (u32 level = static_cast<u32>(chain->levels.size()) - 1 ; level > 0 ; level--) {
+            float projectedError = chain->levels[level].error * object.scale / distance * pixelsPerUnit;
+            if (projectedError <= view.pixelError)
+                return level;
+        }
+
+        return 0;
+    }
+
+    void LodSelector::select(LodObject* objects, size_t count, const LodView& view, ThreadPool* threadPool) {
+        auto selectRange = [objects, &view](size_t begin, size_t end) {
+            for (size_t i = begin ; i < end ; i++) {
+                objects[i].level = select(objects[i], view);
+            }
+        };
+
+        if (threadPool) {
+            threadPool->parallelFor(count, 256, selectRange);
+        } else {
+            selectRange(0, count);
+        }
+    }
+
+}
@@ -0,0 +1,225 @@
+#include <MipGenerator.h>
+#include <CommandPool.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace rdk {
+
+    void MipGenerator::create(Device* device, const AssetPack* assetPack, const char* shaderFilepath) {
+        m_Device = device;
+        m_ShaderFilepath = shaderFilepath;
+        VkDevice logicalDevice = device->getLogicalHandle();
+
+        // sRGB images are written through UNORM alias, so both go through the same storage format
+        m_StorageSupported = device->isFormatSupported(
+                VK_FORMAT_R8G8B8A8_UNORM,
+                VK_IMAGE_TILING_OPTIMAL,
+                VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT
+        );
+        if (!m_StorageSupported) {
+            std::cerr << "MipGenerator::create: RGBA8 storage images are not supported, mips are generated with blits" << std::endl;
+            return;
+        }
+
+        ComputeShader shader;
+        try {
+            shader = ComputeShader(logicalDevice, shaderFilepath, assetPack);
+        } catch (const std::exception& e) {
+            std::cerr << "MipGenerator::create: " << e.what() << ", mips are generated with blits" << std::endl;
+            return;
+        }
+
+        VkDescriptorSetLayoutBinding mipsBinding = Pipeline::createBinding(0, COMPUTE_STORAGE_IMAGE);
+        mipsBinding.descriptorCount = MAX_LEVELS;
+        std::vector<VkDescriptorSetLayoutBinding> bindings = {
+                mipsBinding,
+                Pipeline::createBinding(1, COMPUTE_STORAGE_BUFFER)
+        };
+        m_Pipeline.create(logicalDevice, std::move(shader), bindings, sizeof(MipParams));
+
+        // every dispatch takes its own set, released once its submission has finished
+        const u32 maxSets = 256;
+        VkDescriptorPoolSize poolSizes[] = {
+                { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, maxSets * MAX_LEVELS },
+                { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, maxSets }
+        };
+        m_DescriptorPool.create(logicalDevice, poolSizes, 2, maxSets, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
+
+        m_Counter.create(
+                sizeof(u32),
+                logicalDevice,
+                device->getPhysicalHandle(),
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        void* counter = m_Counter.mapMemory(sizeof(u32));
+        memset(counter, 0, sizeof(u32));
+        m_Counter.unmapMemory();
+
+        m_Active = true;
+    }
+
+    void MipGenerator::destroy() {
+        if (!m_Active)
+            return;
+
+        flush();
+        m_Counter.destroy();
+        m_DescriptorPool.destroy();
+        m_Pipeline.destroy();
+        m_Active = false;
+    }
+
+    // format of storage views the mips are written through
+    static VkFormat storageFormat(VkFormat format) {
+        return format == VK_FORMAT_R8G8B8A8_SRGB ? VK_FORMAT_R8G8B8A8_UNORM : format;
+    }
+
+    bool MipGenerator::supports(VkFormat format, u32 width, u32 height, u32 mipLevels) const {
+        return m_Active
+            && (format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB)
+            && m_Device->isFormatSupported(storageFormat(format), VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT)
+            && std::max(width, height) <= MAX_SIZE
+            && mipLevels > 1 && mipLevels <= MAX_LEVELS;
+    }
+
+    VkImageCreateFlags MipGenerator::imageFlags(VkFormat format) {
+        // sRGB formats usually have no storage support, extended usage validates storage usage against views instead
+        return format == VK_FORMAT_R8G8B8A8_SRGB
+            ? VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT
+            : 0;
+    }
+
+    bool MipGenerator::cmdGenerate(
+            VkCommandBuffer commandBuffer,
+            VkImage image, VkFormat format,
+            u32 width, u32 height, u32 mipLevels,
+            MipFilter filter
+    ) {
+        VkDevice device = m_Device->getLogicalHandle();
+
+        VkDescriptorSet descriptorSet;
+        try {
+            descriptorSet = m_DescriptorPool.allocateSet(m_Pipeline.getDescriptorLayout());
+        } catch (const std::exception&) {
+            return false;
+        }
+        m_PendingSets.emplace_back(descriptorSet);
+
+        // one view per level, unused array slots repeat the last level and are never touched by shader
+        std::vector<VkDescriptorImageInfo> mipInfos(MAX_LEVELS);
+        for (u32 level = 0 ; level < MAX_LEVELS ; level++) {
+            if (level < mipLevels) {
+                ImageViewInfo viewInfo;
+                viewInfo.format = storageFormat(format);
+                viewInfo.baseMipLevel = level;
+                viewInfo.mipLevels = 1;
+                viewInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT;
+                m_PendingViews.emplace_back(device, image, viewInfo);
+            }
+            mipInfos[level].imageView = m_PendingViews.back().getHandle();
+            mipInfos[level].sampler = VK_NULL_HANDLE;
+            mipInfos[level].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        }
+
+        VkWriteDescriptorSet mipsWrite{};
+        mipsWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        mipsWrite.dstSet = descriptorSet;
+        mipsWrite.dstBinding = 0;
+        mipsWrite.dstArrayElement = 0;
+        mipsWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        mipsWrite.descriptorCount = MAX_LEVELS;
+        mipsWrite.pImageInfo = mipInfos.data();
+        vkUpdateDescriptorSets(device, 1, &mipsWrite, 0, nullptr);
+
+        DescriptorPool::writeBuffer(
+                device,
+                descriptorSet, 1,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                m_Counter.getHandle(), 0, sizeof(u32)
+        );
+
+        // previous dispatch resets counter at its very end
+        CommandPool::cmdMemoryBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+        );
+        CommandPool::cmdImageBarrier(
+                commandBuffer, image,
+                0, 1,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT
+        );
+        CommandPool::cmdImageBarrier(
+                commandBuffer, image,
+                1, mipLevels - 1,
+                VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT
+        );
+
+        u32 groupsX = ComputePipeline::groupCount(width, 64);
+        u32 groupsY = ComputePipeline::groupCount(height, 64);
+        MipParams params;
+        params.width = width;
+        params.height = height;
+        params.levels = mipLevels - 1;
+        params.groups = groupsX * groupsY;
+        params.srgb = format == VK_FORMAT_R8G8B8A8_SRGB ? 1 : 0;
+        params.filter = static_cast<u32>(filter);
+
+        m_Pipeline.bind(commandBuffer, descriptorSet);
+        m_Pipeline.pushConstants(commandBuffer, &params, sizeof(params));
+        m_Pipeline.dispatch(commandBuffer, groupsX, groupsY);
+
+        CommandPool::cmdImageBarrier(
+                commandBuffer, image,
+                0, mipLevels,
+                VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT
+        );
+
+        return true;
+    }
+
+    void MipGenerator::release(DeletionQueue& deletionQueue) {
+        for (auto& view : m_PendingViews) {
+            deletionQueue.release(std::move(view));
+        }
+        for (VkDescriptorSet descriptorSet : m_PendingSets) {
+            deletionQueue.release(m_DescriptorPool.getHandle(), descriptorSet);
+        }
+        m_PendingViews.clear();
+        m_PendingSets.clear();
+    }
+
+    void MipGenerator::flush() {
+        if (!m_PendingSets.empty()) {
+            vkFreeDescriptorSets(
+                    m_Device->getLogicalHandle(),
+                    m_DescriptorPool.getHandle(),
+                    static_cast<u32>(m_PendingSets.size()),
+                    m_PendingSets.data()
+            );
+        }
+        m_PendingViews.clear();
+        m_PendingSets.clear();
+    }
+
+    void MipGenerator::reload(DeletionQueue& deletionQueue) {
+        if (!m_Active || !m_Pipeline.getShader().reload())
+            return;
+
+        try {
+            deletionQueue.release(m_Pipeline.recreate());
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+
+}
@@ -0,0 +1,455 @@
+#include <OcclusionCuller.h>
+#include <CommandPool.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace rdk {
+
+    static const VkDeviceSize DRAW_COMMAND_SIZE = sizeof(VkDrawIndexedIndirectCommand);
+
+    static u32 prevPow2(u32 value) {
+        u32 pow2 = 1;
+        while (pow2 * 2 <= value) {
+            pow2 *= 2;
+        }
+        return pow2;
+    }
+
+    static bool hasStencil(VkFormat format) {
+        return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
+    }
+
+    void OcclusionCuller::create(
+            Device* device,
+            DeletionQueue* deletionQueue,
+            const AssetPack* assetPack,
+            VkFormat depthFormat,
+            const char* hizFilepath,
+            const char* cullFilepath
+    ) {
+        m_Device = device;
+        m_DeletionQueue = deletionQueue;
+        m_HizFilepath = hizFilepath;
+        m_CullFilepath = cullFilepath;
+        VkDevice logicalDevice = device->getLogicalHandle();
+
+        bool pyramidSupported = device->isFormatSupported(
+                VK_FORMAT_R32_SFLOAT,
+                VK_IMAGE_TILING_OPTIMAL,
+                VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT
+        );
+        bool depthSupported = device->isFormatSupported(depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+        if (!pyramidSupported || !depthSupported) {
+            std::cerr << "OcclusionCuller::create: depth can't be reduced into R32 pyramid, occlusion culling is disabled" << std::endl;
+            return;
+        }
+
+        ComputeShader hizShader;
+        ComputeShader cullShader;
+        try {
+            hizShader = ComputeShader(logicalDevice, hizFilepath, assetPack);
+            cullShader = ComputeShader(logicalDevice, cullFilepath, assetPack);
+        } catch (const std::exception& e) {
+            std::cerr << "OcclusionCuller::create: " << e.what() << ", occlusion culling is disabled" << std::endl;
+            return;
+        }
+
+        std::vector<VkDescriptorSetLayoutBinding> hizBindings = {
+                Pipeline::createBinding(0, COMPUTE_SAMPLER),
+                Pipeline::createBinding(1, COMPUTE_STORAGE_IMAGE)
+        };
+        m_HizPipeline.create(logicalDevice, std::move(hizShader), hizBindings, sizeof(HizParams));
+
+        std::vector<VkDescriptorSetLayoutBinding> cullBindings = {
+                Pipeline::createBinding(0, COMPUTE_STORAGE_BUFFER),
+                Pipeline::createBinding(1, COMPUTE_STORAGE_BUFFER),
+                Pipeline::createBinding(2, COMPUTE_STORAGE_BUFFER),
+                Pipeline::createBinding(3, COMPUTE_SAMPLER)
+        };
+        m_CullPipeline.create(logicalDevice, std::move(cullShader), cullBindings, sizeof(CullParams));
+
+        // sets are rewritten on resize and object changes, old ones stay alive until frames in flight retire
+        const u32 maxSets = 4 * (MAX_LEVELS + 1);
+        VkDescriptorPoolSize poolSizes[] = {
+                { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, maxSets },
+                { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, maxSets },
+                { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, maxSets * 3 }
+        };
+        m_DescriptorPool.create(logicalDevice, poolSizes, 3, maxSets, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
+
+        // pyramid is read with texelFetch only, filtering never blends depth of neighbouring texels
+        ImageSamplerInfo samplerInfo;
+        samplerInfo.minFilter = VK_FILTER_NEAREST;
+        samplerInfo.magFilter = VK_FILTER_NEAREST;
+        samplerInfo.modeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.modeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.modeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.maxLod = static_cast<float>(MAX_LEVELS);
+        m_Sampler = ImageSampler(*device, samplerInfo);
+
+        m_Active = true;
+    }
+
+    void OcclusionCuller::destroy() {
+        if (!m_Active)
+            return;
+
+        if (m_ObjectCount > 0) {
+            m_Objects.destroy();
+            m_Visibility.destroy();
+            m_Draws.destroy();
+            m_ObjectCount = 0;
+        }
+        m_LevelViews.clear();
+        m_PyramidView = ImageView();
+        m_Pyramid = Image();
+        m_Levels = 0;
+        m_LevelSets.clear();
+        m_CullSet = VK_NULL_HANDLE;
+
+        m_Sampler = ImageSampler();
+        m_DescriptorPool.destroy();
+        m_CullPipeline.destroy();
+        m_HizPipeline.destroy();
+        m_DepthView = VK_NULL_HANDLE;
+        m_DepthExtent = {};
+        m_PyramidExtent = {};
+        m_SetsDirty = true;
+        m_Active = false;
+    }
+
+    void OcclusionCuller::setObjects(const std::vector<CullObject>& objects) {
+        if (!m_Active)
+            return;
+
+        releaseObjects();
+        m_SetsDirty = true;
+        if (objects.empty())
+            return;
+
+        VkDevice logicalDevice = m_Device->getLogicalHandle();
+        VkPhysicalDevice physicalDevice = m_Device->getPhysicalHandle();
+        m_ObjectCount = static_cast<u32>(objects.size());
+
+        VkDeviceSize objectsSize = sizeof(CullObject) * objects.size();
+        m_Objects.create(
+                objectsSize,
+                logicalDevice,
+                physicalDevice,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        void* data = m_Objects.mapMemory(objectsSize);
+        memcpy(data, objects.data(), static_cast<size_t>(objectsSize));
+        m_Objects.unmapMemory();
+
+        m_Visibility.create(
+                sizeof(u32) * objects.size(),
+                logicalDevice,
+                physicalDevice,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+        m_Draws.create(
+                DRAW_COMMAND_SIZE * 2 * objects.size(),
+                logicalDevice,
+                physicalDevice,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+        // nothing is known about new objects, so all of them go into the early phase
+        m_VisibilityReset = true;
+    }
+
+    void OcclusionCuller::releaseObjects() {
+        if (m_ObjectCount == 0)
+            return;
+
+        m_DeletionQueue->release(m_Objects);
+        m_DeletionQueue->release(m_Visibility);
+        m_DeletionQueue->release(m_Draws);
+        m_ObjectCount = 0;
+    }
+
+    void OcclusionCuller::createPyramid(const VkExtent2D& extent) {
+        VkDevice logicalDevice = m_Device->getLogicalHandle();
+
+        // power of two levels halve exactly, so every texel of level i covers 2x2 texels of level i - 1
+        m_PyramidExtent.width = prevPow2(extent.width);
+        m_PyramidExtent.height = prevPow2(extent.height);
+        m_Levels = 1;
+        while (m_Levels < MAX_LEVELS && (m_PyramidExtent.width >> m_Levels) + (m_PyramidExtent.height >> m_Levels) > 0) {
+            m_Levels++;
+        }
+
+        ImageInfo imageInfo;
+        imageInfo.width = m_PyramidExtent.width;
+        imageInfo.height = m_PyramidExtent.height;
+        imageInfo.format = VK_FORMAT_R32_SFLOAT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        imageInfo.mipLevels = m_Levels;
+        m_Pyramid = Image(logicalDevice, m_Device->getPhysicalHandle(), imageInfo);
+
+        ImageViewInfo viewInfo;
+        viewInfo.format = VK_FORMAT_R32_SFLOAT;
+        viewInfo.mipLevels = m_Levels;
+        m_PyramidView = ImageView(logicalDevice, m_Pyramid.getHandle(), viewInfo);
+
+        for (u32 level = 0 ; level < m_Levels ; level++) {
+            ImageViewInfo levelInfo;
+            levelInfo.format = VK_FORMAT_R32_SFLOAT;
+            levelInfo.baseMipLevel = level;
+            levelInfo.mipLevels = 1;
+            m_LevelViews.emplace_back(logicalDevice, m_Pyramid.getHandle(), levelInfo);
+        }
+    }
+
+    void OcclusionCuller::releasePyramid() {
+        for (auto& view : m_LevelViews) {
+            m_DeletionQueue->release(std::move(view));
+        }
+        m_LevelViews.clear();
+        if (m_Levels > 0) {
+            m_DeletionQueue->release(std::move(m_PyramidView));
+            m_DeletionQueue->release(std::move(m_Pyramid));
+        }
+        m_Levels = 0;
+        m_PyramidExtent = {};
+    }
+
+    void OcclusionCuller::releaseSets() {
+        VkDescriptorPool pool = m_DescriptorPool.getHandle();
+        for (VkDescriptorSet levelSet : m_LevelSets) {
+            m_DeletionQueue->release(pool, levelSet);
+        }
+        m_LevelSets.clear();
+        if (m_CullSet != VK_NULL_HANDLE) {
+            m_DeletionQueue->release(pool, m_CullSet);
+            m_CullSet = VK_NULL_HANDLE;
+        }
+    }
+
+    void OcclusionCuller::prepare(const DepthTarget& depth) {
+        if (!isActive())
+            return;
+
+        bool resized = depth.extent.width != m_DepthExtent.width || depth.extent.height != m_DepthExtent.height;
+        if (resized) {
+            releasePyramid();
+            createPyramid(depth.extent);
+            m_DepthExtent = depth.extent;
+            m_SetsDirty = true;
+        }
+        if (depth.view != m_DepthView) {
+            m_DepthView = depth.view;
+            m_SetsDirty = true;
+        }
+
+        if (m_SetsDirty) {
+            releaseSets();
+            writeSets(depth);
+            m_SetsDirty = false;
+        }
+    }
+
+    void OcclusionCuller::writeSets(const DepthTarget& depth) {
+        VkDevice device = m_Device->getLogicalHandle();
+        VkSampler sampler = m_Sampler.getHandle();
+
+        for (u32 level = 0 ; level < m_Levels ; level++) {
+            VkDescriptorSet levelSet = m_DescriptorPool.allocateSet(m_HizPipeline.getDescriptorLayout());
+            m_LevelSets.emplace_back(levelSet);
+
+            if (level == 0) {
+                DescriptorPool::writeImage(
+                        device, levelSet, 0,
+                        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                        depth.view, sampler, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+                );
+            } else {
+                DescriptorPool::writeImage(
+                        device, levelSet, 0,
+                        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                        m_LevelViews[level - 1].getHandle(), sampler, VK_IMAGE_LAYOUT_GENERAL
+                );
+            }
+            DescriptorPool::writeImage(
+                    device, levelSet, 1,
+                    VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                    m_LevelViews[level].getHandle(), VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL
+            );
+        }
+
+        m_CullSet = m_DescriptorPool.allocateSet(m_CullPipeline.getDescriptorLayout());
+        DescriptorPool::writeBuffer(
+                device, m_CullSet, 0,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                m_Objects.getHandle(), 0, sizeof(CullObject) * m_ObjectCount
+        );
+        DescriptorPool::writeBuffer(
+                device, m_CullSet, 1,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                m_Visibility.getHandle(), 0, sizeof(u32) * m_ObjectCount
+        );
+        DescriptorPool::writeBuffer(
+                device, m_CullSet, 2,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                m_Draws.getHandle(), 0, DRAW_COMMAND_SIZE * 2 * m_ObjectCount
+        );
+        DescriptorPool::writeImage(
+                device, m_CullSet, 3,
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                m_PyramidView.getHandle(), sampler, VK_IMAGE_LAYOUT_GENERAL
+        );
+    }
+
+    void OcclusionCuller::cmdCull(VkCommandBuffer commandBuffer, CullPhase phase, const glm::mat4& viewProj) {
+        if (!isActive())
+            return;
+
+        if (phase == CullPhase::EARLY && m_VisibilityReset) {
+            vkCmdFillBuffer(commandBuffer, m_Visibility.getHandle(), 0, VK_WHOLE_SIZE, 1);
+            CommandPool::cmdMemoryBarrier(
+                    commandBuffer,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+            );
+            m_VisibilityReset = false;
+        }
+        // draw commands may still be read by indirect draws of previous phase or frame
+        CommandPool::cmdMemoryBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0
+        );
+
+        CullParams params;
+        params.viewProj = viewProj;
+        params.pyramidWidth = m_PyramidExtent.width;
+        params.pyramidHeight = m_PyramidExtent.height;
+        params.objectCount = m_ObjectCount;
+        params.phase = static_cast<u32>(phase);
+        params.levels = m_Levels;
+
+        m_CullPipeline.bind(commandBuffer, m_CullSet);
+        m_CullPipeline.pushConstants(commandBuffer, &params, sizeof(params));
+        m_CullPipeline.dispatch(commandBuffer, ComputePipeline::groupCount(m_ObjectCount, 64));
+
+        CommandPool::cmdMemoryBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT
+        );
+    }
+
+    void OcclusionCuller::cmdBuildPyramid(VkCommandBuffer commandBuffer, const DepthTarget& depth) {
+        if (!isActive())
+            return;
+
+        VkImageAspectFlags depthAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+        if (hasStencil(depth.format)) {
+            depthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+        CommandPool::cmdImageBarrier(
+                commandBuffer, depth.image, 0, 1,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                depthAspect
+        );
+        // previous pyramid may still be read by late cull of previous frame
+        VkImage pyramid = m_Pyramid.getHandle();
+        CommandPool::cmdImageBarrier(
+                commandBuffer, pyramid, 0, m_Levels,
+                VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT
+        );
+
+        HizParams params;
+        params.srcWidth = depth.renderExtent.width;
+        params.srcHeight = depth.renderExtent.height;
+        for (u32 level = 0 ; level < m_Levels ; level++) {
+            params.dstWidth = std::max(1u, m_PyramidExtent.width >> level);
+            params.dstHeight = std::max(1u, m_PyramidExtent.height >> level);
+
+            m_HizPipeline.bind(commandBuffer, m_LevelSets[level]);
+            m_HizPipeline.pushConstants(commandBuffer, &params, sizeof(params));
+            m_HizPipeline.dispatch(
+                    commandBuffer,
+                    ComputePipeline::groupCount(params.dstWidth, 8),
+                    ComputePipeline::groupCount(params.dstHeight, 8)
+            );
+
+            CommandPool::cmdImageBarrier(
+                    commandBuffer, pyramid, level, 1,
+                    VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT
+            );
+            params.srcWidth = params.dstWidth;
+            params.srcHeight = params.dstHeight;
+        }
+
+        CommandPool::cmdImageBarrier(
+                commandBuffer, depth.image, 0, 1,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                depthAspect
+        );
+    }
+
+    void OcclusionCuller::cmdDraw(VkCommandBuffer commandBuffer, CullPhase phase) {
+        if (!isActive())
+            return;
+
+        VkBuffer draws = m_Draws.getHandle();
+        VkDeviceSize offset = phase == CullPhase::EARLY ? 0 : DRAW_COMMAND_SIZE * m_ObjectCount;
+        // without multi draw indirect every command needs its own call
+        u32 maxDrawCount = 1;
+        if (m_Device->getFeatures().multiDrawIndirect) {
+            maxDrawCount = std::max(1u, m_Device->getProperties().limits.maxDrawIndirectCount);
+        }
+
+        u32 drawn = 0;
+        while (drawn < m_ObjectCount) {
+            u32 drawCount = std::min(maxDrawCount, m_ObjectCount - drawn);
+            vkCmdDrawIndexedIndirect(
+                    commandBuffer,
+                    draws, offset + DRAW_COMMAND_SIZE * drawn,
+                    drawCount,
+                    static_cast<u32>(DRAW_COMMAND_SIZE)
+            );
+            drawn += drawCount;
+        }
+    }
+
+    void OcclusionCuller::reload(const std::string& filepath) {
+        if (!m_Active)
+            return;
+
+        ComputePipeline* pipeline = nullptr;
+        if (filepath == m_HizFilepath) {
+            pipeline = &m_HizPipeline;
+        } else if (filepath == m_CullFilepath) {
+            pipeline = &m_CullPipeline;
+        }
+        if (pipeline == nullptr || !pipeline->getShader().reload())
+            return;
+
+        try {
+            m_DeletionQueue->release(pipeline->recreate());
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+
+}
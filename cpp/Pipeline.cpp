@@ -8,11 +8,31 @@ namespace rdk {
         m_Info.pStages = m_ShaderStages.data();
     }
 
+    void Pipeline::setSpecialization(const std::vector<VkSpecializationMapEntry>& entries, const std::vector<VkBool32>& data) {
+        m_SpecializationEntries = entries;
+        m_SpecializationData = data;
+    }
+
     void Pipeline::setVertexInput(const VertexInput &vertexInput) {
         m_VertexInputState = vertexInput.info;
+        m_VertexBindings.assign(
+                vertexInput.info.pVertexBindingDescriptions,
+                vertexInput.info.pVertexBindingDescriptions + vertexInput.info.vertexBindingDescriptionCount
+        );
+        m_VertexAttributes.assign(
+                vertexInput.info.pVertexAttributeDescriptions,
+                vertexInput.info.pVertexAttributeDescriptions + vertexInput.info.vertexAttributeDescriptionCount
+        );
+        m_VertexInputState.pVertexBindingDescriptions = m_VertexBindings.data();
+        m_VertexInputState.pVertexAttributeDescriptions = m_VertexAttributes.data();
     }
 
-    void Pipeline::create() {
+    void Pipeline::setAttachmentFormats(VkFormat colorFormat, VkFormat depthFormat) {
+        m_ColorFormat = colorFormat;
+        m_DepthFormat = depthFormat;
+    }
+
+    VkResult Pipeline::build(VkPipeline* handle) {
         m_Info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
         m_Info.pVertexInputState = &m_VertexInputState;
         m_Info.pInputAssemblyState = &m_InputAssembly;
@@ -23,27 +43,75 @@ namespace rdk {
         m_Info.pColorBlendState = &m_ColorBlending;
         m_Info.pDynamicState = &m_DynamicState;
         m_Info.layout = m_Layout;
-        m_Info.renderPass = m_SwapChain->getRenderPass().getHandle();
+        // pipeline may have been moved since specialization was set, so stages are pointed to it on every build
+        m_SpecializationInfo.mapEntryCount = static_cast<u32>(m_SpecializationEntries.size());
+        m_SpecializationInfo.pMapEntries = m_SpecializationEntries.data();
+        m_SpecializationInfo.dataSize = m_SpecializationData.size() * sizeof(VkBool32);
+        m_SpecializationInfo.pData = m_SpecializationData.data();
+        for (auto& stage : m_ShaderStages) {
+            stage.pSpecializationInfo = m_SpecializationEntries.empty() ? nullptr : &m_SpecializationInfo;
+        }
+        if (m_SwapChain->isDynamicRendering()) {
+            if (m_ColorFormat == VK_FORMAT_UNDEFINED) {
+                m_ColorFormat = m_SwapChain->getColorFormat();
+                m_DepthFormat = m_SwapChain->getDepthFormat();
+            }
+            m_RenderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+            m_RenderingInfo.colorAttachmentCount = 1;
+            m_RenderingInfo.pColorAttachmentFormats = &m_ColorFormat;
+            m_RenderingInfo.depthAttachmentFormat = m_DepthFormat;
+            m_Info.pNext = &m_RenderingInfo;
+            m_Info.renderPass = VK_NULL_HANDLE;
+        } else {
+            m_Info.pNext = nullptr;
+            m_Info.renderPass = m_SwapChain->getRenderPass().getHandle();
+        }
         m_Info.subpass = 0;
         m_Info.basePipelineHandle = VK_NULL_HANDLE; // Optional
         m_Info.basePipelineIndex = -1; // Optional
 
-        auto pipelineStatus = vkCreateGraphicsPipelines(
+        return vkCreateGraphicsPipelines(
                 m_LogicalDevice,
-                VK_NULL_HANDLE,
+                m_SwapChain->getDevice().getPipelineCache(),
                 1, &m_Info,
-                nullptr, &m_Handle
+                nullptr, handle
         );
+    }
+
+    void Pipeline::create() {
+        auto pipelineStatus = build(&m_Handle);
         rect_assert(pipelineStatus == VK_SUCCESS, "Failed to create Vulkan pipeline")
     }
 
+    VkPipeline Pipeline::recreate(const Shader& shader) {
+        setShader(shader);
+        VkPipeline handle;
+        // old pipeline stays bound when rebuild fails
+        if (build(&handle) != VK_SUCCESS) {
+            throw std::runtime_error("Pipeline::recreate: Failed to create Vulkan pipeline!");
+        }
+        VkPipeline oldHandle = m_Handle;
+        m_Handle = handle;
+        return oldHandle;
+    }
+
     void Pipeline::destroy() {
-        destroyDescriptorLayout();
+        if (!m_LayoutCached) {
+            destroyDescriptorLayout();
+        }
         vkDestroyPipeline(m_LogicalDevice, m_Handle, nullptr);
     }
 
     void Pipeline::beginRenderPass(VkCommandBuffer commandBuffer, u32 imageIndex) {
         auto& swapChain = *m_SwapChain;
+        if (swapChain.isDynamicRendering()) {
+            cmdBeginRendering(
+                    swapChain.getDevice(), commandBuffer,
+                    swapChain.getRenderingTarget(imageIndex), swapChain.getExtent(),
+                    swapChain.getRenderPassInfo()
+            );
+            return;
+        }
         // setup info
         VkRenderPassBeginInfo renderPassInfo{};
         renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -62,7 +130,59 @@ namespace rdk {
         vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
     }
 
-    void Pipeline::endRenderPass(VkCommandBuffer commandBuffer) {
+    void Pipeline::suspendRenderPass(VkCommandBuffer commandBuffer) {
+        // dynamic rendering leaves attachments in attachment layouts
+        if (m_SwapChain->isDynamicRendering()) {
+            m_SwapChain->getDevice().cmdEndRendering(commandBuffer);
+        } else {
+            vkCmdEndRenderPass(commandBuffer);
+        }
+    }
+
+    void Pipeline::resumeRenderPass(VkCommandBuffer commandBuffer, u32 imageIndex) {
+        auto& swapChain = *m_SwapChain;
+        if (swapChain.isDynamicRendering()) {
+            RenderPassInfo resumeInfo;
+            resumeInfo.colorLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+            resumeInfo.colorInitialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            resumeInfo.depthLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+            resumeInfo.depthInitialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            cmdBeginRendering(swapChain.getDevice(), commandBuffer, swapChain.getRenderingTarget(imageIndex), swapChain.getExtent(), resumeInfo);
+            return;
+        }
+        // setup info
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = swapChain.getResumeRenderPass().getHandle();
+        renderPassInfo.framebuffer = swapChain.getFrameBuffer(imageIndex);
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = swapChain.getExtent();
+        // both attachments are loaded
+        renderPassInfo.clearValueCount = 0;
+        renderPassInfo.pClearValues = nullptr;
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    }
+
+    void Pipeline::beginOverlayPass(VkCommandBuffer commandBuffer, u32 imageIndex) {
+        auto& swapChain = *m_SwapChain;
+        RenderingTarget target = swapChain.getRenderingTarget(imageIndex);
+        target.depthImage = VK_NULL_HANDLE;
+        target.depthView = VK_NULL_HANDLE;
+
+        RenderPassInfo overlayInfo;
+        overlayInfo.colorLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+        overlayInfo.colorInitialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        cmdBeginRendering(swapChain.getDevice(), commandBuffer, target, swapChain.getExtent(), overlayInfo);
+    }
+
+    void Pipeline::endRenderPass(VkCommandBuffer commandBuffer, u32 imageIndex) {
+        auto& swapChain = *m_SwapChain;
+        if (swapChain.isDynamicRendering()) {
+            // transitions color into presentation layout, as final layout of render pass does
+            cmdEndRendering(swapChain.getDevice(), commandBuffer, swapChain.getRenderingTarget(imageIndex));
+            return;
+        }
         vkCmdEndRenderPass(commandBuffer);
     }
 
@@ -81,7 +201,14 @@ namespace rdk {
     }
 
     void Pipeline::setViewPort(VkCommandBuffer commandBuffer) {
-        VkExtent2D extent = m_SwapChain->getExtent();
+        setViewPort(commandBuffer, m_SwapChain->getExtent());
+    }
+
+    void Pipeline::setScissor(VkCommandBuffer commandBuffer) {
+        setScissor(commandBuffer, m_SwapChain->getExtent());
+    }
+
+    void Pipeline::setViewPort(VkCommandBuffer commandBuffer, const VkExtent2D& extent) {
         VkViewport viewport{};
         viewport.x = 0.0f;
         viewport.y = 0.0f;
@@ -92,8 +219,7 @@ namespace rdk {
         vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
     }
 
-    void Pipeline::setScissor(VkCommandBuffer commandBuffer) {
-        VkExtent2D extent = m_SwapChain->getExtent();
+    void Pipeline::setScissor(VkCommandBuffer commandBuffer, const VkExtent2D& extent) {
         VkRect2D scissor{};
         scissor.offset = {0, 0};
         scissor.extent = extent;
@@ -104,8 +230,8 @@ namespace rdk {
         vkCmdDraw(commandBuffer, vertexCount, instanceCount, 0, 0);
     }
 
-    void Pipeline::drawIndices(VkCommandBuffer commandBuffer, u32 indexCount, u32 instanceCount) {
-        vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, 0, 0, 0);
+    void Pipeline::drawIndices(VkCommandBuffer commandBuffer, u32 indexCount, u32 instanceCount, u32 firstIndex) {
+        vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, firstIndex, 0, 0);
     }
 
     void Pipeline::setDynamicStates(const std::vector<VkDynamicState>& dynamicStates) {
@@ -204,6 +330,20 @@ namespace rdk {
         rect_assert(pipelineLayoutStatus == VK_SUCCESS, "Failed to create Vulkan pipeline layout")
     }
 
+    void Pipeline::setLayout(LayoutCache& layoutCache, const ShaderLayout& layout) {
+        std::vector<VkDescriptorSetLayout> setLayouts;
+        for (const auto& bindings : layout.sets) {
+            setLayouts.push_back(layoutCache.getDescriptorLayout(bindings));
+        }
+        // pipeline without resources still has set 0, so descriptor pool and binds stay valid
+        if (setLayouts.empty()) {
+            setLayouts.push_back(layoutCache.getDescriptorLayout({}));
+        }
+        m_DescriptorSetLayout = setLayouts[0];
+        m_Layout = layoutCache.getPipelineLayout(setLayouts, layout.pushConstants);
+        m_LayoutCached = true;
+    }
+
     void Pipeline::setVertexBuffer(Buffer* vertexBuffer) {
         m_VertexBuffer = vertexBuffer;
     }
@@ -270,6 +410,30 @@ namespace rdk {
                 layoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
                 layoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
                 break;
+            case LayoutBinding::VERTEX_STORAGE_BUFFER:
+                layoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                layoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+                break;
+            case LayoutBinding::FRAG_STORAGE_BUFFER:
+                layoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                layoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+                break;
+            case LayoutBinding::COMPUTE_UNIFORM_BUFFER:
+                layoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                layoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+                break;
+            case LayoutBinding::COMPUTE_STORAGE_BUFFER:
+                layoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                layoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+                break;
+            case LayoutBinding::COMPUTE_STORAGE_IMAGE:
+                layoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+                layoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+                break;
+            case LayoutBinding::COMPUTE_SAMPLER:
+                layoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                layoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+                break;
         }
 
         return layoutBinding;
@@ -0,0 +1,690 @@
+#include <PixelConvert.h>
+
+#include <cmath>
+#include <cstring>
+#include <atomic>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+
+#define PIXEL_CONVERT_X86
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC emits AVX2 intrinsics in any translation unit, dispatch guarantees they only run on capable CPUs
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2,f16c")))
+#endif
+
+#elif defined(__aarch64__) || defined(_M_ARM64)
+
+#define PIXEL_CONVERT_NEON
+#include <arm_neon.h>
+
+#endif
+
+namespace rdk {
+
+    // ---------------------- scalar
+
+    static inline u8 mulDiv255(u32 value, u32 alpha) {
+        // exact round(value * alpha / 255) for 8 bit inputs
+        u32 t = value * alpha + 128;
+        return static_cast<u8>((t + (t >> 8)) >> 8);
+    }
+
+    static inline u32 floatBits(float value) {
+        u32 bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static inline float bitsFloat(u32 bits) {
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    static const u32 HALF_SUBNORMAL_MAGIC = ((127 - 15) + (23 - 10) + 1) << 23;
+    static const u32 HALF_NORMAL_BIAS = 0xFFFu - ((127u - 15u) << 23);
+    static const u32 HALF_EXP_MAGIC = (254 - 15) << 23;
+
+    static inline u16 floatToHalfScalar(float value) {
+        u32 bits = floatBits(value);
+        u32 sign = (bits >> 16) & 0x8000;
+        u32 abs = bits & 0x7FFFFFFF;
+        u32 result;
+
+        if (abs >= 0x47800000u) {
+            // too large for half, Inf or NaN
+            result = abs > 0x7F800000u ? 0x7E00 : 0x7C00;
+        } else if (abs < 0x38800000u) {
+            // half subnormal or zero, FPU adds with rounding to nearest even
+            result = floatBits(bitsFloat(abs) + bitsFloat(HALF_SUBNORMAL_MAGIC)) - HALF_SUBNORMAL_MAGIC;
+        } else {
+            u32 mantissaOdd = (abs >> 13) & 1;
+            result = (abs + HALF_NORMAL_BIAS + mantissaOdd) >> 13;
+        }
+
+        return static_cast<u16>(result | sign);
+    }
+
+    static inline float halfToFloatScalar(u16 value) {
+        u32 exponentMantissa = value & 0x7FFF;
+        u32 sign = u32(value & 0x8000) << 16;
+        u32 bits = floatBits(bitsFloat(exponentMantissa << 13) * bitsFloat(HALF_EXP_MAGIC));
+        if (exponentMantissa > 0x7BFF) {
+            bits |= 255u << 23;
+        }
+        return bitsFloat(bits | sign);
+    }
+
+    struct SrgbLinearTable final {
+        float values[256];
+
+        SrgbLinearTable() {
+            for (int i = 0 ; i < 256 ; i++) {
+                float value = float(i) / 255.0f;
+                values[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+            }
+        }
+    };
+
+    static const float* srgbTable() {
+        static const SrgbLinearTable table;
+        return table.values;
+    }
+
+    static void expandRGBToRGBAScalar(const u8* src, u8* dst, size_t count, u8 alpha) {
+        for (size_t i = 0 ; i < count ; i++) {
+            dst[i * 4 + 0] = src[i * 3 + 0];
+            dst[i * 4 + 1] = src[i * 3 + 1];
+            dst[i * 4 + 2] = src[i * 3 + 2];
+            dst[i * 4 + 3] = alpha;
+        }
+    }
+
+    static void packRGBAToRGBScalar(const u8* src, u8* dst, size_t count) {
+        for (size_t i = 0 ; i < count ; i++) {
+            dst[i * 3 + 0] = src[i * 4 + 0];
+            dst[i * 3 + 1] = src[i * 4 + 1];
+            dst[i * 3 + 2] = src[i * 4 + 2];
+        }
+    }
+
+    static void swizzleRGBAScalar(const u8* src, u8* dst, size_t count, const u8* order) {
+        for (size_t i = 0 ; i < count ; i++) {
+            u8 pixel[4];
+            memcpy(pixel, &src[i * 4], 4);
+            for (int c = 0 ; c < 4 ; c++) {
+                dst[i * 4 + c] = pixel[order[c]];
+            }
+        }
+    }
+
+    static void premultiplyAlphaScalar(const u8* src, u8* dst, size_t count) {
+        for (size_t i = 0 ; i < count ; i++) {
+            u8 alpha = src[i * 4 + 3];
+            dst[i * 4 + 0] = mulDiv255(src[i * 4 + 0], alpha);
+            dst[i * 4 + 1] = mulDiv255(src[i * 4 + 1], alpha);
+            dst[i * 4 + 2] = mulDiv255(src[i * 4 + 2], alpha);
+            dst[i * 4 + 3] = alpha;
+        }
+    }
+
+    static void srgbToLinearScalar(const u8* src, float* dst, size_t count) {
+        const float* table = srgbTable();
+        for (size_t i = 0 ; i < count ; i++) {
+            dst[i * 4 + 0] = table[src[i * 4 + 0]];
+            dst[i * 4 + 1] = table[src[i * 4 + 1]];
+            dst[i * 4 + 2] = table[src[i * 4 + 2]];
+            dst[i * 4 + 3] = float(src[i * 4 + 3]) / 255.0f;
+        }
+    }
+
+    static void floatToHalfScalar(const float* src, u16* dst, size_t count) {
+        for (size_t i = 0 ; i < count ; i++) {
+            dst[i] = floatToHalfScalar(src[i]);
+        }
+    }
+
+    static void halfToFloatScalar(const u16* src, float* dst, size_t count) {
+        for (size_t i = 0 ; i < count ; i++) {
+            dst[i] = halfToFloatScalar(src[i]);
+        }
+    }
+
+#ifdef PIXEL_CONVERT_X86
+
+    // ---------------------- SSE2
+
+    static void expandRGBToRGBASSE2(const u8* src, u8* dst, size_t count, u8 alpha) {
+        const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+        const __m128i alphaBits = _mm_set1_epi32(static_cast<int>(u32(alpha) << 24));
+
+        size_t i = 0;
+        // 16 byte load covers 4 pixels + 4 bytes, keep 2 pixels distance to the end of src
+        for (; i + 6 <= count ; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+            __m128i p01 = _mm_unpacklo_epi32(v, _mm_srli_si128(v, 3));
+            __m128i p23 = _mm_unpacklo_epi32(_mm_srli_si128(v, 6), _mm_srli_si128(v, 9));
+            __m128i pixels = _mm_unpacklo_epi64(p01, p23);
+            pixels = _mm_or_si128(_mm_and_si128(pixels, rgbMask), alphaBits);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), pixels);
+        }
+
+        expandRGBToRGBAScalar(src + i * 3, dst + i * 4, count - i, alpha);
+    }
+
+    static void packRGBAToRGBSSE2(const u8* src, u8* dst, size_t count) {
+        const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+        const __m128i evenMask = _mm_set_epi32(0, -1, 0, -1);
+        const __m128i lowMask = _mm_set_epi32(0, 0, -1, -1);
+
+        size_t i = 0;
+        for (; i + 4 <= count ; i += 4) {
+            __m128i v = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4)), rgbMask);
+            // 6 bytes per 64 bit lane: even pixel | odd pixel << 24
+            __m128i pairs = _mm_or_si128(_mm_and_si128(v, evenMask), _mm_srli_epi64(_mm_andnot_si128(evenMask, v), 8));
+            // close 2 byte gap between lanes
+            __m128i packed = _mm_or_si128(_mm_and_si128(pairs, lowMask), _mm_srli_si128(_mm_andnot_si128(lowMask, pairs), 2));
+
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i * 3), packed);
+            int tail = _mm_cvtsi128_si32(_mm_srli_si128(packed, 8));
+            memcpy(dst + i * 3 + 8, &tail, 4);
+        }
+
+        packRGBAToRGBScalar(src + i * 4, dst + i * 3, count - i);
+    }
+
+    static void swizzleRGBASSE2(const u8* src, u8* dst, size_t count, const u8* order) {
+        // SSE2 has no byte shuffle, move channels with per register shift counts instead
+        const __m128i byteMask = _mm_set1_epi32(0xFF);
+        __m128i srcShift[4];
+        __m128i dstShift[4];
+        for (int c = 0 ; c < 4 ; c++) {
+            srcShift[c] = _mm_cvtsi32_si128(order[c] * 8);
+            dstShift[c] = _mm_cvtsi32_si128(c * 8);
+        }
+
+        size_t i = 0;
+        for (; i + 4 <= count ; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+            __m128i result = _mm_setzero_si128();
+            for (int c = 0 ; c < 4 ; c++) {
+                __m128i channel = _mm_and_si128(_mm_srl_epi32(v, srcShift[c]), byteMask);
+                result = _mm_or_si128(result, _mm_sll_epi32(channel, dstShift[c]));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), result);
+        }
+
+        swizzleRGBAScalar(src + i * 4, dst + i * 4, count - i, order);
+    }
+
+    static inline __m128i premultiplySSE2(__m128i pixels) {
+        const __m128i rgbWords = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+        const __m128i alphaOne = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+        const __m128i bias = _mm_set1_epi16(128);
+        // broadcast alpha word of each pixel, alpha itself is multiplied by 255/255
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0xFF), 0xFF);
+        alpha = _mm_or_si128(_mm_and_si128(alpha, rgbWords), alphaOne);
+        __m128i t = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), bias);
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+
+    static void premultiplyAlphaSSE2(const u8* src, u8* dst, size_t count) {
+        const __m128i zero = _mm_setzero_si128();
+
+        size_t i = 0;
+        for (; i + 4 <= count ; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+            __m128i lo = premultiplySSE2(_mm_unpacklo_epi8(v, zero));
+            __m128i hi = premultiplySSE2(_mm_unpackhi_epi8(v, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_packus_epi16(lo, hi));
+        }
+
+        premultiplyAlphaScalar(src + i * 4, dst + i * 4, count - i);
+    }
+
+    static inline __m128i floatToHalfSSE2(__m128 value) {
+        const __m128i signMask = _mm_set1_epi32(static_cast<int>(0x80000000u));
+        const __m128i halfMax = _mm_set1_epi32((127 + 16) << 23);
+        const __m128i nanBit = _mm_set1_epi32(0x200);
+        const __m128i halfInf = _mm_set1_epi32(0x7C00);
+        const __m128i minNormal = _mm_set1_epi32((127 - 14) << 23);
+        const __m128i subnormalMagic = _mm_set1_epi32(static_cast<int>(HALF_SUBNORMAL_MAGIC));
+        const __m128i normalBias = _mm_set1_epi32(static_cast<int>(HALF_NORMAL_BIAS));
+
+        __m128 sign = _mm_and_ps(_mm_castsi128_ps(signMask), value);
+        __m128 absValue = _mm_xor_ps(value, sign);
+        __m128i absBits = _mm_castps_si128(absValue);
+
+        __m128 isNan = _mm_cmpunord_ps(absValue, absValue);
+        __m128i isRegular = _mm_cmpgt_epi32(halfMax, absBits);
+        __m128i infOrNan = _mm_or_si128(_mm_and_si128(_mm_castps_si128(isNan), nanBit), halfInf);
+        __m128i isSubnormal = _mm_cmpgt_epi32(minNormal, absBits);
+
+        __m128 subnormalRounded = _mm_add_ps(absValue, _mm_castsi128_ps(subnormalMagic));
+        __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(subnormalRounded), subnormalMagic);
+
+        __m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(absBits, 31 - 13), 31);
+        __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(absBits, normalBias), mantissaOdd), 13);
+
+        __m128i finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+        __m128i result = _mm_or_si128(_mm_and_si128(isRegular, finite), _mm_andnot_si128(isRegular, infOrNan));
+        // sign lands in bit 15, upper bits become ones which signed pack keeps intact
+        return _mm_or_si128(result, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+    }
+
+    static inline __m128 halfToFloatSSE2(__m128i half) {
+        const __m128i noSignMask = _mm_set1_epi32(0x7FFF);
+        const __m128 exponentMagic = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(HALF_EXP_MAGIC)));
+        const __m128i wasInfNan = _mm_set1_epi32(0x7BFF);
+        const __m128 infNanExponent = _mm_castsi128_ps(_mm_set1_epi32(255 << 23));
+
+        __m128i exponentMantissa = _mm_and_si128(noSignMask, half);
+        __m128i sign = _mm_slli_epi32(_mm_xor_si128(half, exponentMantissa), 16);
+        __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(exponentMantissa, 13)), exponentMagic);
+        __m128 infNan = _mm_and_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(exponentMantissa, wasInfNan)), infNanExponent);
+        return _mm_or_ps(scaled, _mm_or_ps(_mm_castsi128_ps(sign), infNan));
+    }
+
+    static void floatToHalfSSE2(const float* src, u16* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 8 <= count ; i += 8) {
+            __m128i lo = floatToHalfSSE2(_mm_loadu_ps(src + i));
+            __m128i hi = floatToHalfSSE2(_mm_loadu_ps(src + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(lo, hi));
+        }
+
+        floatToHalfScalar(src + i, dst + i, count - i);
+    }
+
+    static void halfToFloatSSE2(const u16* src, float* dst, size_t count) {
+        const __m128i zero = _mm_setzero_si128();
+
+        size_t i = 0;
+        for (; i + 8 <= count ; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_ps(dst + i, halfToFloatSSE2(_mm_unpacklo_epi16(v, zero)));
+            _mm_storeu_ps(dst + i + 4, halfToFloatSSE2(_mm_unpackhi_epi16(v, zero)));
+        }
+
+        halfToFloatScalar(src + i, dst + i, count - i);
+    }
+
+    // ---------------------- AVX2
+
+    TARGET_AVX2 static void expandRGBToRGBAAVX2(const u8* src, u8* dst, size_t count, u8 alpha) {
+        const __m256i shuffle = _mm256_setr_epi8(
+                0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+        );
+        const __m256i alphaBits = _mm256_set1_epi32(static_cast<int>(u32(alpha) << 24));
+
+        size_t i = 0;
+        // second 16 byte load starts at pixel 4 and covers 4 bytes of pixel 8
+        for (; i + 10 <= count ; i += 8) {
+            __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+            __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3 + 12));
+            __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+            v = _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle), alphaBits);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), v);
+        }
+
+        expandRGBToRGBASSE2(src + i * 3, dst + i * 4, count - i, alpha);
+    }
+
+    TARGET_AVX2 static void packRGBAToRGBAVX2(const u8* src, u8* dst, size_t count) {
+        const __m256i shuffle = _mm256_setr_epi8(
+                0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1
+        );
+
+        size_t i = 0;
+        // each lane is stored as 16 bytes with 4 garbage bytes, overwritten by next store
+        for (; i + 10 <= count ; i += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+            v = _mm256_shuffle_epi8(v, shuffle);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 3), _mm256_castsi256_si128(v));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 3 + 12), _mm256_extracti128_si256(v, 1));
+        }
+
+        packRGBAToRGBSSE2(src + i * 4, dst + i * 3, count - i);
+    }
+
+    TARGET_AVX2 static void swizzleRGBAAVX2(const u8* src, u8* dst, size_t count, const u8* order) {
+        alignas(32) u8 indices[32];
+        for (int i = 0 ; i < 32 ; i++) {
+            indices[i] = static_cast<u8>((i & 12) + order[i & 3]);
+        }
+        const __m256i shuffle = _mm256_load_si256(reinterpret_cast<const __m256i*>(indices));
+
+        size_t i = 0;
+        for (; i + 8 <= count ; i += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_shuffle_epi8(v, shuffle));
+        }
+
+        swizzleRGBAScalar(src + i * 4, dst + i * 4, count - i, order);
+    }
+
+    TARGET_AVX2 static inline __m256i premultiplyAVX2(__m256i pixels) {
+        const __m256i rgbWords = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+        const __m256i alphaOne = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0);
+        const __m256i bias = _mm256_set1_epi16(128);
+        __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, 0xFF), 0xFF);
+        alpha = _mm256_or_si256(_mm256_and_si256(alpha, rgbWords), alphaOne);
+        __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(pixels, alpha), bias);
+        return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    }
+
+    TARGET_AVX2 static void premultiplyAlphaAVX2(const u8* src, u8* dst, size_t count) {
+        const __m256i zero = _mm256_setzero_si256();
+
+        size_t i = 0;
+        for (; i + 8 <= count ; i += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+            // unpack and pack both work per 128 bit lane, so pixel order is preserved
+            __m256i lo = premultiplyAVX2(_mm256_unpacklo_epi8(v, zero));
+            __m256i hi = premultiplyAVX2(_mm256_unpackhi_epi8(v, zero));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_packus_epi16(lo, hi));
+        }
+
+        premultiplyAlphaSSE2(src + i * 4, dst + i * 4, count - i);
+    }
+
+    TARGET_AVX2 static void srgbToLinearAVX2(const u8* src, float* dst, size_t count) {
+        const float* table = srgbTable();
+        const __m256 alphaScale = _mm256_set1_ps(255.0f);
+
+        size_t i = 0;
+        for (; i + 2 <= count ; i += 2) {
+            __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i * 4));
+            __m256i indices = _mm256_cvtepu8_epi32(bytes);
+            __m256 color = _mm256_i32gather_ps(table, indices, 4);
+            __m256 alpha = _mm256_div_ps(_mm256_cvtepi32_ps(indices), alphaScale);
+            _mm256_storeu_ps(dst + i * 4, _mm256_blend_ps(color, alpha, 0x88));
+        }
+
+        srgbToLinearScalar(src + i * 4, dst + i * 4, count - i);
+    }
+
+    TARGET_AVX2 static void floatToHalfAVX2(const float* src, u16* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 8 <= count ; i += 8) {
+            __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), half);
+        }
+
+        floatToHalfScalar(src + i, dst + i, count - i);
+    }
+
+    TARGET_AVX2 static void halfToFloatAVX2(const u16* src, float* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 8 <= count ; i += 8) {
+            __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(half));
+        }
+
+        halfToFloatScalar(src + i, dst + i, count - i);
+    }
+
+    static bool isAVX2Supported() {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool f16c = (info[2] & (1 << 29)) != 0;
+        // OS must save YMM registers on context switch
+        if (!osxsave || !f16c || (_xgetbv(0) & 6) != 6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+#endif
+    }
+
+#endif // PIXEL_CONVERT_X86
+
+#ifdef PIXEL_CONVERT_NEON
+
+    // ---------------------- NEON
+
+    static void expandRGBToRGBANEON(const u8* src, u8* dst, size_t count, u8 alpha) {
+        size_t i = 0;
+        for (; i + 16 <= count ; i += 16) {
+            uint8x16x3_t rgb = vld3q_u8(src + i * 3);
+            uint8x16x4_t rgba;
+            rgba.val[0] = rgb.val[0];
+            rgba.val[1] = rgb.val[1];
+            rgba.val[2] = rgb.val[2];
+            rgba.val[3] = vdupq_n_u8(alpha);
+            vst4q_u8(dst + i * 4, rgba);
+        }
+
+        expandRGBToRGBAScalar(src + i * 3, dst + i * 4, count - i, alpha);
+    }
+
+    static void packRGBAToRGBNEON(const u8* src, u8* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 16 <= count ; i += 16) {
+            uint8x16x4_t rgba = vld4q_u8(src + i * 4);
+            uint8x16x3_t rgb;
+            rgb.val[0] = rgba.val[0];
+            rgb.val[1] = rgba.val[1];
+            rgb.val[2] = rgba.val[2];
+            vst3q_u8(dst + i * 3, rgb);
+        }
+
+        packRGBAToRGBScalar(src + i * 4, dst + i * 3, count - i);
+    }
+
+    static void swizzleRGBANEON(const u8* src, u8* dst, size_t count, const u8* order) {
+        size_t i = 0;
+        for (; i + 16 <= count ; i += 16) {
+            uint8x16x4_t rgba = vld4q_u8(src + i * 4);
+            uint8x16x4_t result;
+            for (int c = 0 ; c < 4 ; c++) {
+                result.val[c] = rgba.val[order[c]];
+            }
+            vst4q_u8(dst + i * 4, result);
+        }
+
+        swizzleRGBAScalar(src + i * 4, dst + i * 4, count - i, order);
+    }
+
+    static inline uint8x16_t premultiplyNEON(uint8x16_t channel, uint8x16_t alpha) {
+        uint16x8_t lo = vmull_u8(vget_low_u8(channel), vget_low_u8(alpha));
+        uint16x8_t hi = vmull_u8(vget_high_u8(channel), vget_high_u8(alpha));
+        // (t + 128 + ((t + 128) >> 8)) >> 8, same rounding as scalar mulDiv255
+        return vcombine_u8(
+                vrshrn_n_u16(vrsraq_n_u16(lo, lo, 8), 8),
+                vrshrn_n_u16(vrsraq_n_u16(hi, hi, 8), 8)
+        );
+    }
+
+    static void premultiplyAlphaNEON(const u8* src, u8* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 16 <= count ; i += 16) {
+            uint8x16x4_t rgba = vld4q_u8(src + i * 4);
+            rgba.val[0] = premultiplyNEON(rgba.val[0], rgba.val[3]);
+            rgba.val[1] = premultiplyNEON(rgba.val[1], rgba.val[3]);
+            rgba.val[2] = premultiplyNEON(rgba.val[2], rgba.val[3]);
+            vst4q_u8(dst + i * 4, rgba);
+        }
+
+        premultiplyAlphaScalar(src + i * 4, dst + i * 4, count - i);
+    }
+
+    static void floatToHalfNEON(const float* src, u16* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 4 <= count ; i += 4) {
+            float16x4_t half = vcvt_f16_f32(vld1q_f32(src + i));
+            vst1_u16(dst + i, vreinterpret_u16_f16(half));
+        }
+
+        floatToHalfScalar(src + i, dst + i, count - i);
+    }
+
+    static void halfToFloatNEON(const u16* src, float* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 4 <= count ; i += 4) {
+            float16x4_t half = vreinterpret_f16_u16(vld1_u16(src + i));
+            vst1q_f32(dst + i, vcvt_f32_f16(half));
+        }
+
+        halfToFloatScalar(src + i, dst + i, count - i);
+    }
+
+#endif // PIXEL_CONVERT_NEON
+
+    // ---------------------- dispatch
+
+    static std::atomic<int> s_SimdLevel(-1);
+
+    SimdLevel PixelConvert::getSupportedLevel() {
+#if defined(PIXEL_CONVERT_X86)
+        static const SimdLevel level = isAVX2Supported() ? SimdLevel::AVX2 : SimdLevel::SSE2;
+        return level;
+#elif defined(PIXEL_CONVERT_NEON)
+        return SimdLevel::NEON;
+#else
+        return SimdLevel::SCALAR;
+#endif
+    }
+
+    SimdLevel PixelConvert::getSimdLevel() {
+        int level = s_SimdLevel.load(std::memory_order_relaxed);
+        if (level < 0) {
+            level = static_cast<int>(getSupportedLevel());
+            s_SimdLevel.store(level, std::memory_order_relaxed);
+        }
+        return static_cast<SimdLevel>(level);
+    }
+
+    void PixelConvert::setSimdLevel(SimdLevel level) {
+        SimdLevel supported = getSupportedLevel();
+        bool available = level == SimdLevel::SCALAR || level == supported
+                || (level == SimdLevel::SSE2 && supported == SimdLevel::AVX2);
+        s_SimdLevel.store(static_cast<int>(available ? level : supported), std::memory_order_relaxed);
+    }
+
+    const char* PixelConvert::getName(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::SCALAR: return "Scalar";
+            case SimdLevel::SSE2: return "SSE2";
+            case SimdLevel::AVX2: return "AVX2";
+            case SimdLevel::NEON: return "NEON";
+        }
+        return "Unknown";
+    }
+
+    void PixelConvert::expandRGBToRGBA(const u8* src, u8* dst, size_t pixelCount, u8 alpha) {
+        switch (getSimdLevel()) {
+#ifdef PIXEL_CONVERT_X86
+            case SimdLevel::AVX2: return expandRGBToRGBAAVX2(src, dst, pixelCount, alpha);
+            case SimdLevel::SSE2: return expandRGBToRGBASSE2(src, dst, pixelCount, alpha);
+#endif
+#ifdef PIXEL_CONVERT_NEON
+            case SimdLevel::NEON: return expandRGBToRGBANEON(src, dst, pixelCount, alpha);
+#endif
+            default: return expandRGBToRGBAScalar(src, dst, pixelCount, alpha);
+        }
+    }
+
+    void PixelConvert::packRGBAToRGB(const u8* src, u8* dst, size_t pixelCount) {
+        switch (getSimdLevel()) {
+#ifdef PIXEL_CONVERT_X86
+            case SimdLevel::AVX2: return packRGBAToRGBAVX2(src, dst, pixelCount);
+            case SimdLevel::SSE2: return packRGBAToRGBSSE2(src, dst, pixelCount);
+#endif
+#ifdef PIXEL_CONVERT_NEON
+            case SimdLevel::NEON: return packRGBAToRGBNEON(src, dst, pixelCount);
+#endif
+            default: return packRGBAToRGBScalar(src, dst, pixelCount);
+        }
+    }
+
+    void PixelConvert::swizzleRGBA(const u8* src, u8* dst, size_t pixelCount, const u8 order[4]) {
+        switch (getSimdLevel()) {
+#ifdef PIXEL_CONVERT_X86
+            case SimdLevel::AVX2: return swizzleRGBAAVX2(src, dst, pixelCount, order);
+            case SimdLevel::SSE2: return swizzleRGBASSE2(src, dst, pixelCount, order);
+#endif
+#ifdef PIXEL_CONVERT_NEON
+            case SimdLevel::NEON: return swizzleRGBANEON(src, dst, pixelCount, order);
+#endif
+            default: return swizzleRGBAScalar(src, dst, pixelCount, order);
+        }
+    }
+
+    void PixelConvert::premultiplyAlpha(const u8* src, u8* dst, size_t pixelCount) {
+        switch (getSimdLevel()) {
+#ifdef PIXEL_CONVERT_X86
+            case SimdLevel::AVX2: return premultiplyAlphaAVX2(src, dst, pixelCount);
+            case SimdLevel::SSE2: return premultiplyAlphaSSE2(src, dst, pixelCount);
+#endif
+#ifdef PIXEL_CONVERT_NEON
+            case SimdLevel::NEON: return premultiplyAlphaNEON(src, dst, pixelCount);
+#endif
+            default: return premultiplyAlphaScalar(src, dst, pixelCount);
+        }
+    }
+
+    void PixelConvert::srgbToLinear(const u8* src, float* dst, size_t pixelCount) {
+        switch (getSimdLevel()) {
+#ifdef PIXEL_CONVERT_X86
+            case SimdLevel::AVX2: return srgbToLinearAVX2(src, dst, pixelCount);
+#endif
+            // table lookups, gathers only pay off on AVX2
+            default: return srgbToLinearScalar(src, dst, pixelCount);
+        }
+    }
+
+    void PixelConvert::srgbToLinearHalf(const u8* src, u16* dst, size_t pixelCount) {
+        // convert through small float chunks which stay in L1
+        static const size_t CHUNK = 256;
+        float linear[CHUNK * 4];
+        for (size_t i = 0 ; i < pixelCount ; i += CHUNK) {
+            size_t count = pixelCount - i < CHUNK ? pixelCount - i : CHUNK;
+            srgbToLinear(src + i * 4, linear, count);
+            floatToHalf(linear, dst + i * 4, count * 4);
+        }
+    }
+
+    void PixelConvert::floatToHalf(const float* src, u16* dst, size_t count) {
+        switch (getSimdLevel()) {
+#ifdef PIXEL_CONVERT_X86
+            case SimdLevel::AVX2: return floatToHalfAVX2(src, dst, count);
+            case SimdLevel::SSE2: return floatToHalfSSE2(src, dst, count);
+#endif
+#ifdef PIXEL_CONVERT_NEON
+            case SimdLevel::NEON: return floatToHalfNEON(src, dst, count);
+#endif
+            default: return floatToHalfScalar(src, dst, count);
+        }
+    }
+
+    void PixelConvert::halfToFloat(const u16* src, float* dst, size_t count) {
+        switch (getSimdLevel()) {
+#ifdef PIXEL_CONVERT_X86
+            case SimdLevel::AVX2: return halfToFloatAVX2(src, dst, count);
+            case SimdLevel::SSE2: return halfToFloatSSE2(src, dst, count);
+#endif
+#ifdef PIXEL_CONVERT_NEON
+            case SimdLevel::NEON: return halfToFloatNEON(src, dst, count);
+#endif
+            default: return halfToFloatScalar(src, dst, count);
+        }
+    }
+
+}
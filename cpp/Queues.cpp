@@ -6,6 +6,7 @@ namespace rdk {
     void Queue::create(VkDevice logicalDevice, const QueueFamilyIndices &familyIndices) {
         vkGetDeviceQueue(logicalDevice, familyIndices.graphicsFamily, 0, (VkQueue*) &m_GraphicsHandle);
         vkGetDeviceQueue(logicalDevice, familyIndices.presentationFamily, 0, (VkQueue*) &m_PresentationHandle);
+        vkGetDeviceQueue(logicalDevice, familyIndices.computeFamily, 0, (VkQueue*) &m_ComputeHandle);
         m_FamilyIndices = familyIndices;
     }
 
@@ -1,19 +1,102 @@
 #include <RenderPass.h>
+#include <CommandPool.h>
 
 namespace rdk {
 
-    RenderPass::RenderPass(VkDevice device, VkFormat colorFormat, VkFormat depthFormat) {
+    static VkImageAspectFlags depthAspect(VkFormat format) {
+        if (format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT)
+            return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+        return VK_IMAGE_ASPECT_DEPTH_BIT;
+    }
+
+    void cmdBeginRendering(
+            const Device& device,
+            VkCommandBuffer commandBuffer,
+            const RenderingTarget& target,
+            const VkExtent2D& renderArea,
+            const RenderPassInfo& info
+    ) {
+        bool hasDepth = target.depthView != VK_NULL_HANDLE;
+        // the same dependency as external sub pass dependency of render pass, chained with image available wait
+        if (info.colorInitialLayout != VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) {
+            CommandPool::cmdImageBarrier(
+                    commandBuffer, target.colorImage, 0, 1,
+                    info.colorInitialLayout, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0,
+                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+            );
+        }
+        // depth written by previous frame must be done before it's cleared
+        if (hasDepth && info.depthInitialLayout != VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
+            CommandPool::cmdImageBarrier(
+                    commandBuffer, target.depthImage, 0, 1,
+                    info.depthInitialLayout, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                    VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    depthAspect(target.depthFormat)
+            );
+        }
+        // setup color attachment
+        VkRenderingAttachmentInfoKHR colorAttachment{};
+        colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+        colorAttachment.imageView = target.colorView;
+        colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachment.loadOp = info.colorLoadOp;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachment.clearValue.color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        // setup depth attachment
+        VkRenderingAttachmentInfoKHR depthAttachment{};
+        depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+        depthAttachment.imageView = target.depthView;
+        depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        depthAttachment.loadOp = info.depthLoadOp;
+        depthAttachment.storeOp = info.depthStoreOp;
+        depthAttachment.clearValue.depthStencil = {1.0f, 0};
+        // setup rendering info
+        VkRenderingInfoKHR renderingInfo{};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+        renderingInfo.renderArea.offset = {0, 0};
+        renderingInfo.renderArea.extent = renderArea;
+        renderingInfo.layerCount = 1;
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachments = &colorAttachment;
+        renderingInfo.pDepthAttachment = hasDepth ? &depthAttachment : nullptr;
+
+        device.cmdBeginRendering(commandBuffer, renderingInfo);
+    }
+
+    void cmdEndRendering(
+            const Device& device,
+            VkCommandBuffer commandBuffer,
+            const RenderingTarget& target,
+            const RenderPassInfo& info
+    ) {
+        device.cmdEndRendering(commandBuffer);
+
+        if (info.colorFinalLayout != VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) {
+            CommandPool::cmdImageBarrier(
+                    commandBuffer, target.colorImage, 0, 1,
+                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, info.colorFinalLayout,
+                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0
+            );
+        }
+    }
+
+    RenderPass::RenderPass(VkDevice device, VkFormat colorFormat, VkFormat depthFormat, const RenderPassInfo& info) {
         m_Device = device;
         // setup color attachment
         VkAttachmentDescription colorAttachment{};
         colorAttachment.format = colorFormat;
         colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        colorAttachment.loadOp = info.colorLoadOp;
         colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
         colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        colorAttachment.initialLayout = info.colorInitialLayout;
+        colorAttachment.finalLayout = info.colorFinalLayout;
         // setup color attachment reference
         VkAttachmentReference colorAttachmentRef{};
         colorAttachmentRef.attachment = 0;
@@ -23,11 +106,11 @@ namespace rdk {
         VkAttachmentDescription depthAttachment{};
         depthAttachment.format = depthFormat;
         depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-        depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.loadOp = info.depthLoadOp;
+        depthAttachment.storeOp = info.depthStoreOp;
         depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        depthAttachment.initialLayout = info.depthInitialLayout;
         depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
         // setup depth attachment reference
         VkAttachmentReference depthAttachmentRef{};
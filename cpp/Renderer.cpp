@@ -20,8 +20,12 @@
 
 namespace rdk {
 
+    // clip planes of camera, clustered lighting slices view depth between them
+    static const float CAMERA_NEAR = 0.1f;
+    static const float CAMERA_FAR = 10.0f;
+
     Renderer::Renderer(const AppInfo &appInfo, Window* window) : m_AppInfo(appInfo), m_Window(window) {
-        m_Shaders = std::make_shared<std::vector<Shader>>();
+        m_Shaders = std::make_shared<std::vector<ShaderVariants>>();
         // list device extensions to be supported
         m_Device.setExtensions({
             VK_KHR_SWAPCHAIN_EXTENSION_NAME
@@ -82,6 +86,10 @@ namespace rdk {
                 &m_Device, &m_DescriptorPool,
                 &m_Queue, &m_Pipeline
         );
+        m_FileSystem.create(&m_ThreadPool);
+#ifdef HOT_RELOAD
+        m_FileWatcher.create();
+#endif
     }
 
     Renderer::~Renderer() {
@@ -89,11 +97,34 @@ namespace rdk {
         destroyUI();
 #endif
 
+        // pending loads touch streamer state only from update(), wait for their workers and drop the results
+        m_FileSystem.destroy();
+        {
+            std::unique_lock<std::mutex> lock(m_AsyncMutex);
+            m_AsyncFinished.wait(lock, [this]() { return m_AsyncLoads == 0; });
+            m_DecodedTextures.clear();
+        }
+
         m_Device.waitIdle();
 
-        m_ImageSamplers.clear();
-        m_ImageViews.clear();
-        m_Images.clear();
+        m_TextureStreamer.destroy();
+
+#ifdef DEBUG
+        if (m_AssetPack.isOpen()) {
+            AssetPack::logStats("Renderer: asset pack loads per asset type", m_AssetPack.getStats());
+        }
+#endif
+
+        m_Textures.clear();
+
+        for (auto& computePipeline : m_ComputePipelines) {
+            computePipeline.destroy();
+        }
+        m_ComputePipelines.clear();
+        m_ComputeDescriptorPool.destroy();
+        m_MipGenerator.destroy();
+        m_OcclusionCuller.destroy();
+        m_ClusteredLights.destroy();
 
         m_DescriptorPool.destroy();
 
@@ -110,6 +141,7 @@ namespace rdk {
         delete m_SwapChain;
 
         m_Pipeline.destroy();
+        m_LayoutCache.destroy();
 
         m_CommandPool.destroy();
 
@@ -150,9 +182,31 @@ namespace rdk {
         listener->onRenderUI(m_DeltaTime);
 #endif
 
-        m_CommandPool.beginFrame();
-        listener->onRender(m_DeltaTime);
-        m_CommandPool.endFrame();
+        // streamed uploads and descriptor rewrites need the frame slot to be idle
+        m_CommandPool.waitFrame();
+        hotReload();
+        registerDecodedTextures();
+        m_TextureStreamer.update();
+        updateStreamedDescriptor();
+        updateTextureDescriptor();
+
+        if (m_CommandPool.beginFrame()) {
+            m_CommandPool.beginAsyncCompute();
+            listener->onAsyncCompute(m_DeltaTime);
+            m_CommandPool.submitAsyncCompute();
+
+            listener->onCompute(m_DeltaTime);
+            m_ClusteredLights.cmdBuild(m_CommandPool.getCurrentBuffer(), m_CommandPool.getCurrentFrame(), getSceneDepth().renderExtent);
+            if (m_OcclusionCuller.isActive()) {
+                m_OcclusionCuller.prepare(getSceneDepth());
+                m_OcclusionCuller.cmdCull(m_CommandPool.getCurrentBuffer(), CullPhase::EARLY, m_CullMatrix);
+            }
+            m_CommandPool.beginRenderPass();
+            listener->onRender(m_DeltaTime);
+            submitDrawList();
+            drawCulled();
+            m_CommandPool.endFrame();
+        }
 
         auto endTime = std::chrono::high_resolution_clock::now();
         m_DeltaTime = std::chrono::duration<float, std::chrono::seconds::period>(endTime - m_BeginTime).count();
@@ -162,16 +216,138 @@ namespace rdk {
         m_CommandPool.drawVertices(vertexCount, instanceCount);
     }
 
-    void Renderer::drawIndices(u32 indexCount, u32 instanceCount) {
-        m_CommandPool.drawIndices(indexCount, instanceCount);
+    void Renderer::drawIndices(u32 indexCount, u32 instanceCount, u32 firstIndex) {
+        m_CommandPool.drawIndices(indexCount, instanceCount, firstIndex);
+    }
+
+    void Renderer::drawLod(const LodObject& object, u32 instanceCount) {
+        const LodLevel& level = object.chain->levels[object.level];
+        m_CommandPool.drawIndices(level.indexCount, instanceCount, level.firstIndex);
+    }
+
+    void Renderer::drawSorted(u64 key, u32 indexCount, u32 instanceCount, u32 firstIndex, const DrawState& state) {
+        DrawItem draw;
+        draw.key = key;
+        draw.state = state;
+        draw.indexCount = indexCount;
+        draw.instanceCount = instanceCount;
+        draw.firstIndex = firstIndex;
+        m_DrawList.add(draw);
+    }
+
+    void Renderer::drawLodSorted(u64 key, const LodObject& object, u32 instanceCount, const DrawState& state) {
+        const LodLevel& level = object.chain->levels[object.level];
+        drawSorted(key, level.indexCount, instanceCount, level.firstIndex, state);
+    }
+
+    void Renderer::submitDrawList() {
+        if (m_DrawList.empty())
+            return;
+
+        // the same state is bound by CommandPool::beginRenderPass(), so default draws need no binds at all
+        DrawState bound;
+        bound.pipeline = m_Pipeline.getHandle();
+        bound.layout = m_Pipeline.getLayout();
+        bound.descriptorSet = m_DescriptorPool[m_CommandPool.getCurrentFrame()];
+        bound.vertexBuffer = m_VertexBuffer.getHandle();
+        bound.indexBuffer = m_IndexBuffer.getHandle();
+
+        m_DrawList.sort(&m_ThreadPool);
+        m_DrawList.submit(m_CommandPool.getCurrentBuffer(), bound);
+        m_DrawList.clear();
+    }
+
+    void Renderer::setCullObjects(const std::vector<CullObject>& objects) {
+        m_OcclusionCuller.setObjects(objects);
+    }
+
+    DepthTarget Renderer::getSceneDepth() {
+        const DynamicResolution& dynamicResolution = m_CommandPool.getDynamicResolution();
+        DepthTarget depth;
+        depth.format = m_SwapChain->getDepthFormat();
+        if (dynamicResolution.isActive()) {
+            depth.image = dynamicResolution.getDepthImage();
+            depth.view = dynamicResolution.getDepthView();
+            depth.extent = dynamicResolution.getTargetExtent();
+            depth.renderExtent = dynamicResolution.getRenderExtent();
+        } else {
+            depth.image = m_SwapChain->getDepthImage();
+            depth.view = m_SwapChain->getDepthView();
+            depth.extent = m_SwapChain->getExtent();
+            depth.renderExtent = depth.extent;
+        }
+        return depth;
+    }
+
+    void Renderer::drawCulled() {
+        if (!m_OcclusionCuller.isActive())
+            return;
+
+        VkCommandBuffer commandBuffer = m_CommandPool.getCurrentBuffer();
+        m_Pipeline.bind(commandBuffer, &m_DescriptorPool[m_CommandPool.getCurrentFrame()]);
+        m_OcclusionCuller.cmdDraw(commandBuffer, CullPhase::EARLY);
+
+        // pyramid is built from depth of early phase and draws of onRender(), without leaving the frame
+        m_CommandPool.suspendRenderPass();
+        m_OcclusionCuller.cmdBuildPyramid(commandBuffer, getSceneDepth());
+        m_OcclusionCuller.cmdCull(commandBuffer, CullPhase::LATE, m_CullMatrix);
+        m_CommandPool.resumeRenderPass();
+
+        m_OcclusionCuller.cmdDraw(commandBuffer, CullPhase::LATE);
     }
 
     void Renderer::onFrameBufferResized(int width, int height) {
         m_CommandPool.setFrameBufferResized(true);
     }
 
-    void Renderer::addShader(const std::string& vertFilepath, const std::string& fragFilepath) {
-        m_Shaders->emplace_back(m_Device.getLogicalHandle(), vertFilepath, fragFilepath);
+    void Renderer::mountAssetPack(const char* filepath) {
+        m_AssetPack.open(filepath);
+    }
+
+    void Renderer::addShader(const std::string& vertFilepath, const std::string& fragFilepath, const std::vector<ShaderFeature>& features) {
+        m_Shaders->emplace_back(m_Device.getLogicalHandle(), vertFilepath, fragFilepath, features, &m_AssetPack);
+        watchAsset(vertFilepath);
+        watchAsset(fragFilepath);
+    }
+
+    void Renderer::setShaderFeatures(u32 features) {
+        if (m_SwapChain == nullptr) {
+            m_ShaderFeatures = features;
+            return;
+        }
+        if (features == m_ShaderFeatures)
+            return;
+
+        ShaderVariants& shaderVariants = m_Shaders->at(m_PipelineShader);
+        std::vector<VkSpecializationMapEntry> specializationEntries;
+        std::vector<VkBool32> specializationData;
+        try {
+            const Shader& shader = shaderVariants.get(features);
+            // layout and descriptor sets of pipeline are kept, so define features must not change resources
+            if (!shader.isReflected() || shader.getLayout() != shaderVariants.get(m_ShaderFeatures).getLayout()) {
+                std::cerr << "Renderer::setShaderFeatures: variant " << features << " has other resource layout, features are kept" << std::endl;
+                return;
+            }
+
+            shaderVariants.getSpecialization(features, &specializationEntries, &specializationData);
+            m_Pipeline.setSpecialization(specializationEntries, specializationData);
+            VkPipeline oldPipeline = m_Pipeline.recreate(shader);
+            m_CommandPool.getDeletionQueue().release(oldPipeline);
+            m_ShaderFeatures = features;
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            // later rebuilds after reload go on with current variant
+            shaderVariants.getSpecialization(m_ShaderFeatures, &specializationEntries, &specializationData);
+            m_Pipeline.setSpecialization(specializationEntries, specializationData);
+            m_Pipeline.setShader(shaderVariants.get(m_ShaderFeatures));
+        }
+    }
+
+    void Renderer::watchAsset(const std::string& filepath) {
+        // pack entries don't change while mapped
+        if (!m_AssetPack.contains(filepath.c_str())) {
+            m_FileWatcher.watch(filepath);
+        }
     }
 
     void Renderer::createVertexBuffer(const VertexData& vertexData) {
@@ -232,17 +408,21 @@ namespace rdk {
 
     void Renderer::initialize() {
         m_SwapChain = new SwapChain(m_Window->getHandle(), &m_Device, m_Surface, m_Device.findDepthFormat());
-        m_RenderPass = &m_SwapChain->getRenderPass();
+        // dynamic rendering has no render pass, pipelines are built against swap chain formats
+        m_RenderPass = m_SwapChain->isDynamicRendering() ? nullptr : &m_SwapChain->getRenderPass();
+
+        // vertex input and descriptor layouts are reflected from shader, so they can't drift apart from it
+        ShaderVariants& shaderVariants = m_Shaders->at(m_PipelineShader);
+        const Shader& shader = shaderVariants.get(m_ShaderFeatures);
+        rect_assert(shader.isReflected(), "Renderer::initialize: pipeline shader has no reflected layout")
+        const ShaderLayout& shaderLayout = shader.getLayout();
+        rect_assert(shaderLayout.vertexStride == sizeof(Vertex), "Renderer::initialize: vertex shader inputs don't match Vertex")
 
         VkVertexInputBindingDescription vertexBindDesc;
         vertexBindDesc.binding = 0;
-        vertexBindDesc.stride = sizeof(Vertex);
+        vertexBindDesc.stride = shaderLayout.vertexStride;
         vertexBindDesc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        std::vector<VkVertexInputAttributeDescription> attrs {
-                { 0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, position) },
-                { 1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, color) },
-                { 2, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, uv) }
-        };
+        const std::vector<VkVertexInputAttributeDescription>& attrs = shaderLayout.vertexAttributes;
 
         // setup pipeline
         m_Pipeline = Pipeline(m_Device.getLogicalHandle(), m_SwapChain);
@@ -253,7 +433,11 @@ namespace rdk {
         m_Pipeline.setDynamicStates();
         m_Pipeline.setViewport(m_SwapChain->getExtent());
         m_Pipeline.setScissor(m_SwapChain->getExtent());
-        m_Pipeline.setShader(m_Shaders->at(0));
+        m_Pipeline.setShader(shader);
+        std::vector<VkSpecializationMapEntry> specializationEntries;
+        std::vector<VkBool32> specializationData;
+        shaderVariants.getSpecialization(m_ShaderFeatures, &specializationEntries, &specializationData);
+        m_Pipeline.setSpecialization(specializationEntries, specializationData);
         m_Pipeline.setRasterizer();
         m_Pipeline.setMultisampling();
 
@@ -262,40 +446,61 @@ namespace rdk {
 
         m_Pipeline.setDepthStencil();
 
-        // setup descriptor layout bindings
-        VkDescriptorSetLayoutBinding layoutBindings[] = {
-                m_Pipeline.createBinding(0, VERTEX_UNIFORM_BUFFER),
-                m_Pipeline.createBinding(1, FRAG_SAMPLER)
-        };
-        int bindings = sizeof(layoutBindings) / sizeof(layoutBindings[0]);
-        VkDescriptorSetLayout descriptorSetLayout = m_Pipeline.createDescriptorLayout(layoutBindings, bindings);
+        // stage flags of shared bindings are combined, camera uniform is read by fragment stage too to find cluster of fragment
+        m_LayoutCache.create(m_Device.getLogicalHandle());
+        m_Pipeline.setLayout(m_LayoutCache, shaderLayout);
+        VkDescriptorSetLayout descriptorSetLayout = m_Pipeline.getDescriptorLayout();
 
         // setup descriptor pool
         u32 maxFramesInFlight = m_CommandPool.getMaxFramesInFlight();
 
-        VkDescriptorPoolSize uboPoolSize{};
-        uboPoolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        uboPoolSize.descriptorCount = maxFramesInFlight;
+        std::vector<VkDescriptorPoolSize> poolSizes = shaderLayout.getPoolSizes(0, maxFramesInFlight);
+        u32 poolSizeCount = static_cast<u32>(poolSizes.size());
 
-        VkDescriptorPoolSize samplerPoolSize{};
-        samplerPoolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        samplerPoolSize.descriptorCount = maxFramesInFlight;
-
-        VkDescriptorPoolSize poolSizes[] = {
-                uboPoolSize,
-                samplerPoolSize
-        };
-        int poolSizeCount = sizeof(poolSizes) / sizeof(poolSizes[0]);
-
-        m_DescriptorPool.create(m_Device.getLogicalHandle(), poolSizes, poolSizeCount, maxFramesInFlight);
+        m_DescriptorPool.create(m_Device.getLogicalHandle(), poolSizes.data(), poolSizeCount, maxFramesInFlight);
         m_DescriptorPool.createSets(maxFramesInFlight, descriptorSetLayout);
 
-        m_Pipeline.setLayout();
-        m_Pipeline.createLayout();
+        m_ClusteredLights.create(&m_Device, &m_AssetPack, maxFramesInFlight);
+        m_ClusteredLights.setDepthRange(CAMERA_NEAR, CAMERA_FAR);
+        if (m_ClusteredLights.isActive()) {
+            watchAsset(m_ClusteredLights.getShaderFilepath());
+        }
+        for (u32 i = 0 ; i < maxFramesInFlight ; i++) {
+            m_ClusteredLights.writeDescriptors(m_DescriptorPool[i], i, 2);
+        }
+
+        // setup compute descriptor pool, sets are allocated and freed one by one
+        VkDescriptorPoolSize computePoolSizes[] = {
+                { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 64 },
+                { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 16 },
+                { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 16 },
+                { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 16 }
+        };
+        int computePoolSizeCount = sizeof(computePoolSizes) / sizeof(computePoolSizes[0]);
+        m_ComputeDescriptorPool.create(
+                m_Device.getLogicalHandle(),
+                computePoolSizes, computePoolSizeCount,
+                32,
+                VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
+        );
 
         m_Pipeline.create();
 
         m_CommandPool.create();
+        m_MipGenerator.create(&m_Device, &m_AssetPack);
+        if (m_MipGenerator.isActive()) {
+            watchAsset(m_MipGenerator.getShaderFilepath());
+        }
+        m_OcclusionCuller.create(&m_Device, &m_CommandPool.getDeletionQueue(), &m_AssetPack, m_SwapChain->getDepthFormat());
+        if (m_OcclusionCuller.isSupported()) {
+            watchAsset(m_OcclusionCuller.getHizFilepath());
+            watchAsset(m_OcclusionCuller.getCullFilepath());
+        }
+        // nothing else reads depth back, so without culling it never has to leave tile memory
+        m_CommandPool.setSceneDepthStored(m_OcclusionCuller.isSupported());
+        m_RenderPass = m_SwapChain->isDynamicRendering() ? nullptr : &m_SwapChain->getRenderPass();
+        m_TextureStreamer.create(&m_Device, &m_Queue, &m_CommandPool.getTimeline(), maxFramesInFlight);
+        m_TextureDescriptorDirty.assign(maxFramesInFlight, false);
 
         m_CommandPool.transitionImageLayout(
                 m_SwapChain->getDepthImage(),
@@ -317,6 +522,26 @@ namespace rdk {
         createIndexBuffer(indexData);
     }
 
+    const LodChain& Renderer::createLodMesh(const VertexData& vertexData, const IndexData& indexData, const LodSettings& settings) {
+        u32 vertexCount = static_cast<u32>(vertexData.size / sizeof(Vertex));
+        u32 indexCount = static_cast<u32>(indexData.size / sizeof(u32));
+
+        m_LodChain = MeshSimplifier::buildLodChain(
+                reinterpret_cast<const float*>(vertexData.data), vertexCount, sizeof(Vertex),
+                indexData.data, indexCount,
+                settings
+        );
+
+        createVertexBuffer(vertexData);
+        createIndexBuffer({ m_LodChain.indices.size() * sizeof(u32), m_LodChain.indices.data() });
+
+        return m_LodChain;
+    }
+
+    void Renderer::selectLods(LodObject* objects, size_t count, const LodView& view) {
+        LodSelector::select(objects, count, view, &m_ThreadPool);
+    }
+
     void Renderer::createUniformBuffers(VkDeviceSize size) {
         u32 maxFramesInFlight = m_CommandPool.getMaxFramesInFlight();
         VkDevice device = m_Device.getLogicalHandle();
@@ -325,9 +550,6 @@ namespace rdk {
         m_UniformBuffers.resize(maxFramesInFlight);
         m_UniformBufferBlocks.resize(maxFramesInFlight);
 
-        VkImageView imageView = m_ImageViews[0].getHandle();
-        VkSampler imageSampler = m_ImageSamplers[0].getHandle();
-
         for (int i = 0 ; i < maxFramesInFlight ; i++) {
 
             // -------------------- uniform buffer setup
@@ -359,38 +581,43 @@ namespace rdk {
             uboWriteDescriptor.pImageInfo = nullptr; // Optional
             uboWriteDescriptor.pTexelBufferView = nullptr; // Optional
 
-            // ---------------------- combined image sampler setup
-
-            VkDescriptorImageInfo imageInfo{};
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageInfo.imageView = imageView;
-            imageInfo.sampler = imageSampler;
+            vkUpdateDescriptorSets(device, 1, &uboWriteDescriptor, 0, nullptr);
+            m_ClusteredLights.writeCameraBuffer(i, uniformBuffer.getHandle(), size);
 
-            VkWriteDescriptorSet imageWriteDescriptor{};
-            imageWriteDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            imageWriteDescriptor.dstSet = m_DescriptorPool[i];
-            imageWriteDescriptor.dstBinding = 1;
-            imageWriteDescriptor.dstArrayElement = 0;
-            imageWriteDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            imageWriteDescriptor.descriptorCount = 1;
-            imageWriteDescriptor.pImageInfo = &imageInfo;
-
-            VkWriteDescriptorSet writeDescriptors[] = {
-                    uboWriteDescriptor,
-                    imageWriteDescriptor
-            };
-            int writeDescriptorCount = sizeof(writeDescriptors) / sizeof(writeDescriptors[0]);
+            // ---------------------- combined image sampler setup
+            // streamed texture writes its own sampler descriptor on residency changes
 
-            vkUpdateDescriptorSets(device, writeDescriptorCount, writeDescriptors, 0, nullptr);
+            const Texture2D* texture = m_Textures.get(m_BoundTexture);
+            if (texture != nullptr && m_BoundStreamedTexture == NONE_STREAMED_TEXTURE) {
+                writeSamplerDescriptor(m_DescriptorPool[i], texture->view.getHandle(), texture->sampler.getHandle());
+            }
         }
     }
 
+    void Renderer::writeSamplerDescriptor(VkDescriptorSet descriptorSet, VkImageView imageView, VkSampler sampler) {
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfo.imageView = imageView;
+        imageInfo.sampler = sampler;
+
+        VkWriteDescriptorSet imageWriteDescriptor{};
+        imageWriteDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        imageWriteDescriptor.dstSet = descriptorSet;
+        imageWriteDescriptor.dstBinding = 1;
+        imageWriteDescriptor.dstArrayElement = 0;
+        imageWriteDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        imageWriteDescriptor.descriptorCount = 1;
+        imageWriteDescriptor.pImageInfo = &imageInfo;
+
+        vkUpdateDescriptorSets(m_Device.getLogicalHandle(), 1, &imageWriteDescriptor, 0, nullptr);
+    }
+
     MVP Renderer::createMVP(float aspect) {
         MVP mvp;
         createUniformBuffers(sizeof(MVP));
         mvp.model = glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
         mvp.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-        mvp.proj = glm::perspective(glm::radians(45.0f), aspect, 0.1f, 10.0f);
+        mvp.proj = glm::perspective(glm::radians(45.0f), aspect, CAMERA_NEAR, CAMERA_FAR);
         return mvp;
     }
 
@@ -401,21 +628,172 @@ namespace rdk {
 
         mvp.model = glm::rotate(glm::mat4(1.0f), m_DeltaTime * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
         mvp.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-        mvp.proj = glm::perspective(glm::radians(45.0f), aspect, 0.1f, 10.0f);
+        mvp.proj = glm::perspective(glm::radians(45.0f), aspect, CAMERA_NEAR, CAMERA_FAR);
 
         memcpy(m_UniformBufferBlocks[currentFrame], &mvp, sizeof(MVP));
+        m_CullMatrix = mvp.proj * mvp.view * mvp.model;
     }
 
-    void Renderer::createTexture2D(const char *filepath) {
+    TextureHandle Renderer::createTexture2D(const char *filepath) {
+        Texture2D texture = loadTexture2D(filepath);
+        texture.filepath = filepath;
+        watchAsset(filepath);
+        return addTexture2D(std::move(texture));
+    }
+
+    TextureHandle Renderer::addTexture2D(Texture2D&& texture) {
+        TextureHandle handle = m_Textures.emplace(std::move(texture));
+        // first texture is bound unless another one is bound explicitly
+        if (!m_Textures.contains(m_BoundTexture)) {
+            m_BoundTexture = handle;
+            m_TextureDescriptorDirty.assign(m_CommandPool.getMaxFramesInFlight(), true);
+        }
+        return handle;
+    }
+
+    void Renderer::destroyTexture2D(TextureHandle handle) {
+        releaseTexture2D(m_Textures.remove(handle));
+        if (handle != m_BoundTexture)
+            return;
+
+        // sets still point at released view and sampler, so they are rewritten with another live texture.
+        // Without one they keep the old descriptor until next texture is added.
+        m_BoundTexture = m_Textures.empty() ? TextureHandle{} : m_Textures.getHandle(0);
+        m_TextureDescriptorDirty.assign(m_CommandPool.getMaxFramesInFlight(), true);
+    }
+
+    void Renderer::bindTexture2D(TextureHandle handle) {
+        m_BoundTexture = handle;
+        m_BoundStreamedTexture = NONE_STREAMED_TEXTURE;
+        m_TextureDescriptorDirty.assign(m_CommandPool.getMaxFramesInFlight(), true);
+    }
+
+    ComputePipelineHandle Renderer::createComputePipeline(
+            const std::string& filepath,
+            const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+            u32 pushConstantSize
+    ) {
+        VkDevice device = m_Device.getLogicalHandle();
+        // compile errors throw before slot is taken
+        ComputeShader shader(device, filepath, &m_AssetPack);
+        ComputePipelineHandle handle = m_ComputePipelines.emplace();
+        m_ComputePipelines.get(handle)->create(device, std::move(shader), bindings, pushConstantSize);
+        watchAsset(filepath);
+        return handle;
+    }
+
+    void Renderer::destroyComputePipeline(ComputePipelineHandle handle) {
+        ComputePipeline computePipeline = m_ComputePipelines.remove(handle);
+        DeletionQueue& deletionQueue = m_CommandPool.getDeletionQueue();
+        deletionQueue.release(computePipeline.getHandle());
+        deletionQueue.release(computePipeline.getLayout());
+        deletionQueue.release(computePipeline.getDescriptorLayout());
+    }
+
+    ComputePipeline& Renderer::getComputePipeline(ComputePipelineHandle handle) {
+        ComputePipeline* computePipeline = m_ComputePipelines.get(handle);
+        if (computePipeline == nullptr) {
+            throw std::runtime_error("Renderer::getComputePipeline: stale handle!");
+        }
+        return *computePipeline;
+    }
+
+    VkDescriptorSet Renderer::createComputeSet(ComputePipelineHandle handle) {
+        return m_ComputeDescriptorPool.allocateSet(getComputePipeline(handle).getDescriptorLayout());
+    }
+
+    void Renderer::destroyComputeSet(VkDescriptorSet descriptorSet) {
+        m_CommandPool.getDeletionQueue().release(m_ComputeDescriptorPool.getHandle(), descriptorSet);
+    }
+
+    void Renderer::writeStorageBuffer(VkDescriptorSet descriptorSet, u32 binding, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+        DescriptorPool::writeBuffer(
+                m_Device.getLogicalHandle(),
+                descriptorSet, binding,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                buffer, offset, range
+        );
+    }
+
+    void Renderer::writeUniformBuffer(VkDescriptorSet descriptorSet, u32 binding, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+        DescriptorPool::writeBuffer(
+                m_Device.getLogicalHandle(),
+                descriptorSet, binding,
+                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                buffer, offset, range
+        );
+    }
+
+    void Renderer::writeStorageImage(VkDescriptorSet descriptorSet, u32 binding, VkImageView view) {
+        DescriptorPool::writeImage(
+                m_Device.getLogicalHandle(),
+                descriptorSet, binding,
+                VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                view, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL
+        );
+    }
+
+    Buffer Renderer::createStorageBuffer(VkDeviceSize size, VkBufferUsageFlags usage) {
+        // shared by both families without ownership transfers, when async compute runs on its own family
+        const QueueFamilyIndices& familyIndices = m_Queue.getFamilyIndices();
+        std::vector<u32> queueFamilies;
+        if (familyIndices.hasAsyncCompute()) {
+            queueFamilies = { static_cast<u32>(familyIndices.graphicsFamily), static_cast<u32>(familyIndices.computeFamily) };
+        }
+
+        Buffer buffer;
+        buffer.create(
+                size,
+                m_Device.getLogicalHandle(),
+                m_Device.getPhysicalHandle(),
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | usage,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                queueFamilies
+        );
+        return buffer;
+    }
+
+    void Renderer::destroyStorageBuffer(const Buffer& buffer) {
+        m_CommandPool.getDeletionQueue().release(buffer);
+    }
+
+    void Renderer::pushComputeConstants(ComputePipelineHandle handle, const void* data, u32 size) {
+        getComputePipeline(handle).pushConstants(m_CommandPool.getRecordingBuffer(), data, size);
+    }
+
+    void Renderer::dispatch(ComputePipelineHandle handle, VkDescriptorSet descriptorSet, u32 groupCountX, u32 groupCountY, u32 groupCountZ) {
+        m_CommandPool.dispatch(getComputePipeline(handle), descriptorSet, groupCountX, groupCountY, groupCountZ);
+    }
+
+    void Renderer::dispatchIndirect(ComputePipelineHandle handle, VkDescriptorSet descriptorSet, VkBuffer buffer, VkDeviceSize offset) {
+        m_CommandPool.dispatchIndirect(getComputePipeline(handle), descriptorSet, buffer, offset);
+    }
+
+    void Renderer::computeBarrier(VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+        CommandPool::cmdMemoryBarrier(
+                m_CommandPool.getRecordingBuffer(),
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                dstStage, dstAccess
+        );
+    }
+
+    Texture2D Renderer::loadTexture2D(const char* filepath) {
+        AssetBlob blob = AssetPack::loadAsset(filepath, &m_AssetPack, &m_ThreadPool);
+
+        if (KtxFile::hasKtx2Extension(filepath)) {
+            return createTexture2DKtx(KtxFile::parse(blob.data(), blob.size()));
+        }
+
         VkDevice device = m_Device.getLogicalHandle();
         VkPhysicalDevice physicalDevice = m_Device.getPhysicalHandle();
 
-        ImageData imageData = ImageLoader::load(filepath,device,physicalDevice);
+        ImageData imageData = ImageLoader::load(blob.data(), blob.size(), device, physicalDevice);
         VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
         VkBuffer stageBuffer = imageData.stageBuffer.getHandle();
         u32 width = imageData.width;
         u32 height = imageData.height;
         u32 mipLevels = imageData.mipLevels;
+        bool computeMips = m_MipGenerator.supports(format, width, height, mipLevels);
 
         ImageInfo imageInfo;
         imageInfo.width = imageData.width;
@@ -425,9 +803,14 @@ namespace rdk {
         imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
         imageInfo.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
         imageInfo.mipLevels = mipLevels;
-        m_Images.emplace_back(device, physicalDevice, imageInfo);
+        if (computeMips) {
+            imageInfo.usage |= MipGenerator::imageUsage();
+            imageInfo.flags = MipGenerator::imageFlags(format);
+        }
+        Texture2D result;
+        result.image = Image(device, physicalDevice, imageInfo);
 
-        VkImage texture2D = m_Images.rbegin()->getHandle();
+        VkImage texture2D = result.image.getHandle();
 
         m_CommandPool.transitionImageLayout(
                 texture2D, format,
@@ -437,23 +820,634 @@ namespace rdk {
 
         m_CommandPool.copyBufferImage(stageBuffer, texture2D, width, height);
 
-        if (m_Device.isLinearFilterSupported(format)) {
-            m_CommandPool.generateMipmaps(texture2D, width, height, mipLevels);
-        } else {
-            std::cerr << "Renderer::createTexture2D: Device is not supporting Linear Filtering feature for MipMapping!" << std::endl;
+        if (computeMips) {
+            VkCommandBuffer commandBuffer = m_CommandPool.beginTempCommand();
+            computeMips = m_MipGenerator.cmdGenerate(commandBuffer, texture2D, format, width, height, mipLevels, m_MipFilter);
+            m_CommandPool.endTempCommand();
+            m_MipGenerator.flush();
+        }
+
+        if (!computeMips) {
+            if (m_Device.isLinearFilterSupported(format)) {
+                m_CommandPool.generateMipmaps(texture2D, width, height, mipLevels);
+            } else {
+                std::cerr << "Renderer::createTexture2D: Device is not supporting Linear Filtering feature for MipMapping!" << std::endl;
+            }
         }
 
         imageData.stageBuffer.destroy();
 
+        createTextureViewSampler(result, format, mipLevels);
+        return result;
+    }
+
+    Texture2D Renderer::createTexture2DKtx(const KtxTexture& texture) {
+        VkDevice device = m_Device.getLogicalHandle();
+        VkPhysicalDevice physicalDevice = m_Device.getPhysicalHandle();
+
+        VkFormat format = texture.format;
+        u32 mipLevels = static_cast<u32>(texture.levels.size());
+
+        if (!m_Device.isFormatSupported(format, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT)) {
+            throw std::runtime_error("Renderer::createTexture2D: KTX2 texture format is not supported by device!");
+        }
+
+        // container levels are copied into stage buffer as is, no decoding on load
+        VkDeviceSize size = texture.data.size();
+        Buffer stageBuffer;
+        stageBuffer.create(
+                size,
+                device, physicalDevice,
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        void* block = stageBuffer.mapMemory(size);
+        memcpy(block, texture.data.data(), size);
+        stageBuffer.unmapMemory();
+
+        ImageInfo imageInfo;
+        imageInfo.width = texture.width;
+        imageInfo.height = texture.height;
+        imageInfo.format = format;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        imageInfo.mipLevels = mipLevels;
+        Texture2D result;
+        result.image = Image(device, physicalDevice, imageInfo);
+
+        VkImage texture2D = result.image.getHandle();
+
+        m_CommandPool.transitionImageLayout(
+                texture2D, format,
+                VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                mipLevels
+        );
+
+        std::vector<VkBufferImageCopy> regions(mipLevels);
+        for (u32 i = 0 ; i < mipLevels ; i++) {
+            const KtxLevel& level = texture.levels[i];
+            VkBufferImageCopy& region = regions[i];
+            region.bufferOffset = level.offset;
+            region.bufferRowLength = 0;
+            region.bufferImageHeight = 0;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = i;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = { 0, 0, 0 };
+            region.imageExtent = { level.width, level.height, 1 };
+        }
+        m_CommandPool.copyBufferImage(stageBuffer.getHandle(), texture2D, regions);
+
+        m_CommandPool.transitionImageLayout(
+                texture2D, format,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                mipLevels
+        );
+
+        stageBuffer.destroy();
+
+        createTextureViewSampler(result, format, mipLevels);
+        return result;
+    }
+
+    struct BatchTexture final {
+        const char* filepath;
+        AssetBlob blob;
+        // KTX2 pack entry, copied or decompressed straight into stage memory as whole container
+        const PackEntry* packEntry = nullptr;
+        bool ktx = false;
+        KtxTexture ktxTexture;
+        u32 width = 0;
+        u32 height = 0;
+        u32 mipLevels = 1;
+        VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        // mips generated with compute dispatch instead of blits
+        bool computeMips = false;
+        bool failed = false;
+    };
+
+    std::vector<TextureHandle> Renderer::createTextures2D(const std::vector<const char*>& filepaths) {
+        VkDevice device = m_Device.getLogicalHandle();
+        VkPhysicalDevice physicalDevice = m_Device.getPhysicalHandle();
+
+        std::vector<BatchTexture> textures(filepaths.size());
+        for (size_t i = 0 ; i < filepaths.size() ; i++) {
+            textures[i].filepath = filepaths[i];
+            textures[i].ktx = KtxFile::hasKtx2Extension(filepaths[i]);
+        }
+
+        // loose files are read with one batch of async reads, waited here and not on workers,
+        // as fallback reads run on the same pool
+        std::vector<ReadRequest> requests;
+        std::vector<size_t> requestTextures;
+        for (size_t i = 0 ; i < textures.size() ; i++) {
+            if (!m_AssetPack.contains(textures[i].filepath)) {
+                ReadRequest request;
+                request.filepath = textures[i].filepath;
+                requests.emplace_back(request);
+                requestTextures.emplace_back(i);
+            }
+        }
+        std::vector<std::future<ReadResult>> reads = m_FileSystem.readBatch(requests);
+        for (size_t i = 0 ; i < reads.size() ; i++) {
+            ReadResult result = reads[i].get();
+            BatchTexture& texture = textures[requestTextures[i]];
+            if (result.success) {
+                texture.blob = AssetBlob(std::move(result.data));
+            } else {
+                texture.failed = true;
+            }
+        }
+
+        // parse headers in parallel to size the shared stage buffer, KTX2 containers are parsed whole
+        const AssetPack* assetPack = &m_AssetPack;
+        m_ThreadPool.parallelFor(textures.size(), 1, [&textures, assetPack](size_t begin, size_t end) {
+            for (size_t i = begin ; i < end ; i++) {
+                BatchTexture& texture = textures[i];
+                if (texture.failed)
+                    continue;
+
+                const PackEntry* entry = texture.ktx ? assetPack->find(texture.filepath) : nullptr;
+                if (entry != nullptr) {
+                    // only level index is decoded here, level offsets then point into container in stage memory
+                    try {
+                        std::vector<u8> head = assetPack->readHead(*entry, KtxFile::KTX2_INDEX_SIZE);
+                        texture.ktxTexture = KtxFile::parseIndex(head.data(), head.size(), entry->rawSize);
+                    } catch (const std::exception&) {
+                        texture.failed = true;
+                        continue;
+                    }
+                    texture.packEntry = entry;
+                    texture.width = texture.ktxTexture.width;
+                    texture.height = texture.ktxTexture.height;
+                    texture.mipLevels = static_cast<u32>(texture.ktxTexture.levels.size());
+                    texture.format = texture.ktxTexture.format;
+                    texture.size = entry->rawSize;
+                    continue;
+                }
+                if (texture.blob.data() == nullptr) {
+                    try {
+                        texture.blob = AssetPack::loadAsset(texture.filepath, assetPack);
+                    } catch (const std::exception&) {
+                        texture.failed = true;
+                        continue;
+                    }
+                }
+                if (texture.ktx) {
+                    try {
+                        texture.ktxTexture = KtxFile::parse(texture.blob.data(), texture.blob.size());
+                        texture.blob = AssetBlob();
+                    } catch (const std::exception&) {
+                        texture.failed = true;
+                        continue;
+                    }
+                    texture.width = texture.ktxTexture.width;
+                    texture.height = texture.ktxTexture.height;
+                    texture.mipLevels = static_cast<u32>(texture.ktxTexture.levels.size());
+                    texture.format = texture.ktxTexture.format;
+                    texture.size = texture.ktxTexture.data.size();
+                } else {
+                    texture.failed = !ImageLoader::info(texture.blob.data(), texture.blob.size(), &texture.width, &texture.height);
+                    if (texture.failed) {
+                        continue;
+                    }
+                    texture.mipLevels = ImageLoader::mipLevels(texture.width, texture.height);
+                    texture.size = VkDeviceSize(texture.width) * texture.height * 4;
+                }
+            }
+        });
+
+        VkDeviceSize stageSize = 0;
+        for (auto& texture : textures) {
+            if (texture.failed) {
+                throw std::runtime_error(std::string("Renderer::createTextures2D: failed to read texture ") + texture.filepath);
+            }
+            if (texture.ktx && !m_Device.isFormatSupported(texture.format, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT)) {
+                throw std::runtime_error(std::string("Renderer::createTextures2D: KTX2 texture format is not supported by device ") + texture.filepath);
+            }
+            if (!texture.ktx) {
+                texture.computeMips = m_MipGenerator.supports(texture.format, texture.width, texture.height, texture.mipLevels);
+            }
+            if (!texture.ktx && !texture.computeMips && !m_Device.isLinearFilterSupported(texture.format)) {
+                std::cerr << "Renderer::createTextures2D: Device is not supporting Linear Filtering feature for MipMapping!" << std::endl;
+                texture.mipLevels = 1;
+            }
+            // 16 bytes satisfies copy offset alignment of RGBA8 and BC block formats
+            texture.offset = stageSize;
+            stageSize += (texture.size + 15) & ~VkDeviceSize(15);
+        }
+
+        Buffer stageBuffer;
+        stageBuffer.create(
+                stageSize,
+                device, physicalDevice,
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        u8* stageMemory = static_cast<u8*>(stageBuffer.mapMemory(stageSize));
+
+        ThreadPool* threadPool = &m_ThreadPool;
+        m_ThreadPool.parallelFor(textures.size(), 1, [&textures, stageMemory, assetPack, threadPool](size_t begin, size_t end) {
+            for (size_t i = begin ; i < end ; i++) {
+                BatchTexture& texture = textures[i];
+                u8* dst = stageMemory + texture.offset;
+                if (texture.packEntry != nullptr) {
+                    // chunks of large textures spread over idle workers as well
+                    try {
+                        assetPack->read(*texture.packEntry, dst, threadPool);
+                    } catch (const std::exception&) {
+                        texture.failed = true;
+                    }
+                } else if (texture.ktx) {
+                    memcpy(dst, texture.ktxTexture.data.data(), texture.size);
+                    texture.ktxTexture.data.clear();
+                    texture.ktxTexture.data.shrink_to_fit();
+                } else {
+                    texture.failed = !ImageLoader::decode(texture.blob.data(), texture.blob.size(), dst, texture.size);
+                    texture.blob = AssetBlob();
+                }
+            }
+        });
+
+        stageBuffer.unmapMemory();
+
+        for (const auto& texture : textures) {
+            if (texture.failed) {
+                stageBuffer.destroy();
+                throw std::runtime_error(std::string("Renderer::createTextures2D: failed to decode texture ") + texture.filepath);
+            }
+        }
+
+        // create all images first, then record every upload into one command buffer
+        std::vector<Texture2D> created(textures.size());
+        std::vector<VkImage> images(textures.size());
+        for (size_t i = 0 ; i < textures.size() ; i++) {
+            const BatchTexture& texture = textures[i];
+            ImageInfo imageInfo;
+            imageInfo.width = texture.width;
+            imageInfo.height = texture.height;
+            imageInfo.format = texture.format;
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+            imageInfo.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            imageInfo.mipLevels = texture.mipLevels;
+            if (texture.computeMips) {
+                imageInfo.usage |= MipGenerator::imageUsage();
+                imageInfo.flags = MipGenerator::imageFlags(texture.format);
+            }
+            created[i].image = Image(device, physicalDevice, imageInfo);
+            images[i] = created[i].image.getHandle();
+        }
+
+        VkCommandBuffer commandBuffer = m_CommandPool.beginTempCommand();
+        VkBuffer stageHandle = stageBuffer.getHandle();
+
+        for (size_t i = 0 ; i < textures.size() ; i++) {
+            const BatchTexture& texture = textures[i];
+            VkImage image = images[i];
+
+            CommandPool::cmdTransitionImageLayout(
+                    commandBuffer, image, texture.format,
+                    VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    texture.mipLevels
+            );
+
+            u32 copyLevels = texture.ktx ? texture.mipLevels : 1;
+            std::vector<VkBufferImageCopy> regions(copyLevels);
+            for (u32 level = 0 ; level < copyLevels ; level++) {
+                VkBufferImageCopy& region = regions[level];
+                region.bufferOffset = texture.offset + (texture.ktx ? texture.ktxTexture.levels[level].offset : 0);
+                region.bufferRowLength = 0;
+                region.bufferImageHeight = 0;
+                region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                region.imageSubresource.mipLevel = level;
+                region.imageSubresource.baseArrayLayer = 0;
+                region.imageSubresource.layerCount = 1;
+                region.imageOffset = { 0, 0, 0 };
+                region.imageExtent = { std::max(texture.width >> level, 1u), std::max(texture.height >> level, 1u), 1 };
+            }
+            CommandPool::cmdCopyBufferImage(commandBuffer, stageHandle, image, regions);
+
+            if (texture.ktx || texture.mipLevels == 1) {
+                CommandPool::cmdTransitionImageLayout(
+                        commandBuffer, image, texture.format,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        texture.mipLevels
+                );
+            } else if (!texture.computeMips || !m_MipGenerator.cmdGenerate(
+                    commandBuffer, image, texture.format,
+                    texture.width, texture.height, texture.mipLevels,
+                    m_MipFilter
+            )) {
+                CommandPool::cmdGenerateMipmaps(commandBuffer, image, texture.width, texture.height, texture.mipLevels);
+            }
+        }
+
+        m_CommandPool.endTempCommand();
+        m_MipGenerator.flush();
+        stageBuffer.destroy();
+
+        std::vector<TextureHandle> handles;
+        handles.reserve(textures.size());
+        for (size_t i = 0 ; i < textures.size() ; i++) {
+            createTextureViewSampler(created[i], textures[i].format, textures[i].mipLevels);
+            created[i].filepath = textures[i].filepath;
+            watchAsset(textures[i].filepath);
+            handles.emplace_back(addTexture2D(std::move(created[i])));
+        }
+        return handles;
+    }
+
+    void Renderer::createTextureViewSampler(Texture2D& texture, VkFormat format, u32 mipLevels) {
         ImageViewInfo imageViewInfo;
         imageViewInfo.format = format;
         imageViewInfo.mipLevels = mipLevels;
-        m_ImageViews.emplace_back(device, texture2D, imageViewInfo);
+        // sRGB textures may carry storage usage for MipGenerator, which their own format doesn't support
+        imageViewInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT;
+        texture.view = ImageView(m_Device.getLogicalHandle(), texture.image.getHandle(), imageViewInfo);
 
         ImageSamplerInfo samplerInfo;
         samplerInfo.minLod = static_cast<float>(0);
         samplerInfo.maxLod = static_cast<float>(mipLevels);
-        m_ImageSamplers.emplace_back(m_Device, samplerInfo);
+        texture.sampler = ImageSampler(m_Device, samplerInfo);
+    }
+
+    StreamedTextureId Renderer::streamTexture2D(const char* filepath) {
+        StreamedTextureId id = m_TextureStreamer.createTexture2D(filepath, &m_AssetPack);
+        trackStreamedTexture(id, filepath);
+        return id;
+    }
+
+    void Renderer::streamTexture2DAsync(const char* filepath, StreamedTextureCallback onReady) {
+        readStreamedTexture(filepath, NONE_STREAMED_TEXTURE, std::move(onReady));
+    }
+
+    void Renderer::readStreamedTexture(const std::string& filepath, StreamedTextureId replaceId, StreamedTextureCallback onReady) {
+        {
+            std::lock_guard<std::mutex> lock(m_AsyncMutex);
+            m_AsyncLoads++;
+        }
+
+        // mapped pack needs no read, decoding alone goes to workers
+        std::string path = filepath;
+        if (m_AssetPack.contains(filepath.c_str())) {
+            m_ThreadPool.submit([this, path, replaceId, onReady]() mutable {
+                AssetBlob blob;
+                try {
+                    blob = AssetPack::loadAsset(path.c_str(), &m_AssetPack);
+                } catch (const std::exception& e) {
+                    std::cerr << "Renderer::streamTexture2DAsync: " << e.what() << std::endl;
+                    finishAsyncLoad(nullptr);
+                    return;
+                }
+                decodeStreamedTexture(path, replaceId, std::move(blob), std::move(onReady));
+            });
+            return;
+        }
+
+        ReadRequest request;
+        request.filepath = path;
+        m_FileSystem.read(request, [this, replaceId, onReady](ReadResult&& result) mutable {
+            if (!result.success) {
+                std::cerr << "Renderer::streamTexture2DAsync: failed to read " << result.filepath << ": " << result.error << std::endl;
+                finishAsyncLoad(nullptr);
+                return;
+            }
+            // completion runs on I/O thread, decoding is moved off it right away
+            auto data = std::make_shared<ReadResult>(std::move(result));
+            m_ThreadPool.submit([this, data, replaceId, onReady]() mutable {
+                decodeStreamedTexture(data->filepath, replaceId, AssetBlob(std::move(data->data)), std::move(onReady));
+            });
+        });
+    }
+
+    void Renderer::decodeStreamedTexture(
+            const std::string& filepath,
+            StreamedTextureId replaceId,
+            AssetBlob&& blob,
+            StreamedTextureCallback&& onReady
+    ) {
+        DecodedTexture texture;
+        try {
+            texture.source = TextureStreamer::decodeTexture2D(filepath.c_str(), blob.data(), blob.size());
+        } catch (const std::exception& e) {
+            std::cerr << "Renderer::streamTexture2DAsync: " << filepath << ": " << e.what() << std::endl;
+            finishAsyncLoad(nullptr);
+            return;
+        }
+        texture.filepath = filepath;
+        texture.replaceId = replaceId;
+        texture.onReady = std::move(onReady);
+        finishAsyncLoad(&texture);
+    }
+
+    void Renderer::finishAsyncLoad(DecodedTexture* texture) {
+        std::lock_guard<std::mutex> lock(m_AsyncMutex);
+        if (texture != nullptr) {
+            m_DecodedTextures.emplace_back(std::move(*texture));
+        }
+        m_AsyncLoads--;
+        m_AsyncFinished.notify_all();
+    }
+
+    void Renderer::registerDecodedTextures() {
+        std::vector<DecodedTexture> textures;
+        {
+            std::lock_guard<std::mutex> lock(m_AsyncMutex);
+            textures.swap(m_DecodedTextures);
+        }
+
+        for (auto& texture : textures) {
+            StreamedTextureId id = texture.replaceId;
+            try {
+                if (id == NONE_STREAMED_TEXTURE) {
+                    id = m_TextureStreamer.addTexture2D(std::move(texture.source));
+                    trackStreamedTexture(id, texture.filepath);
+                } else {
+                    m_TextureStreamer.replaceTexture2D(id, std::move(texture.source));
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Renderer::streamTexture2DAsync: " << e.what() << std::endl;
+                continue;
+            }
+            if (texture.onReady) {
+                texture.onReady(id);
+            }
+        }
+    }
+
+    void Renderer::trackStreamedTexture(StreamedTextureId id, const std::string& filepath) {
+        if (id >= m_StreamedFilepaths.size()) {
+            m_StreamedFilepaths.resize(id + 1);
+        }
+        m_StreamedFilepaths[id] = filepath;
+        watchAsset(filepath);
+    }
+
+    void Renderer::requestTextureMip(StreamedTextureId id, u32 mipLevel) {
+        m_TextureStreamer.request(id, mipLevel);
+    }
+
+    void Renderer::bindStreamedTexture2D(StreamedTextureId id) {
+        m_BoundStreamedTexture = id;
+        // force rewrite of every frame descriptor set once its frame comes around
+        m_StreamedDescriptorVersions.assign(m_CommandPool.getMaxFramesInFlight(), UINT64_MAX);
+    }
+
+    void Renderer::updateStreamedDescriptor() {
+        if (m_BoundStreamedTexture == NONE_STREAMED_TEXTURE)
+            return;
+
+        u32 currentFrame = m_CommandPool.getCurrentFrame();
+        u64 version = m_TextureStreamer.getVersion(m_BoundStreamedTexture);
+        if (m_StreamedDescriptorVersions[currentFrame] == version)
+            return;
+
+        writeSamplerDescriptor(
+                m_DescriptorPool[currentFrame],
+                m_TextureStreamer.getView(m_BoundStreamedTexture),
+                m_TextureStreamer.getSampler(m_BoundStreamedTexture)
+        );
+        m_StreamedDescriptorVersions[currentFrame] = version;
+    }
+
+    void Renderer::updateTextureDescriptor() {
+        u32 currentFrame = m_CommandPool.getCurrentFrame();
+        if (!m_TextureDescriptorDirty[currentFrame])
+            return;
+
+        const Texture2D* texture = m_Textures.get(m_BoundTexture);
+        if (m_BoundStreamedTexture == NONE_STREAMED_TEXTURE && texture != nullptr) {
+            writeSamplerDescriptor(m_DescriptorPool[currentFrame], texture->view.getHandle(), texture->sampler.getHandle());
+        }
+        m_TextureDescriptorDirty[currentFrame] = false;
+    }
+
+    void Renderer::hotReload() {
+        if (!m_FileWatcher.isActive())
+            return;
+
+        for (const auto& filepath : m_FileWatcher.poll()) {
+            reloadShaders(filepath);
+            reloadComputeShaders(filepath);
+            if (filepath == m_MipGenerator.getShaderFilepath()) {
+                m_MipGenerator.reload(m_CommandPool.getDeletionQueue());
+            }
+            m_OcclusionCuller.reload(filepath);
+            if (filepath == m_ClusteredLights.getShaderFilepath()) {
+                m_ClusteredLights.reload(m_CommandPool.getDeletionQueue());
+            }
+
+            for (size_t i = 0 ; i < m_Textures.size() ; i++) {
+                TextureHandle handle = m_Textures.getHandle(i);
+                if (m_Textures.get(handle)->filepath == filepath) {
+                    reloadTexture2D(handle);
+                }
+            }
+
+            // streamed textures are read and decoded off render thread, swapped in by registerDecodedTextures()
+            for (StreamedTextureId id = 0 ; id < m_StreamedFilepaths.size() ; id++) {
+                if (m_StreamedFilepaths[id] == filepath) {
+                    readStreamedTexture(filepath, id, nullptr);
+                }
+            }
+        }
+    }
+
+    void Renderer::reloadShaders(const std::string& filepath) {
+        for (u32 i = 0 ; i < m_Shaders->size() ; i++) {
+            ShaderVariants& shader = m_Shaders->at(i);
+            // only changed stage is recompiled
+            bool reloaded = false;
+            if (shader.getVertFilepath() == filepath) {
+                reloaded |= shader.reload(VK_SHADER_STAGE_VERTEX_BIT);
+            }
+            if (shader.getFragFilepath() == filepath) {
+                reloaded |= shader.reload(VK_SHADER_STAGE_FRAGMENT_BIT);
+            }
+
+            // only pipelines built from this shader are rebuilt
+            if (!reloaded || i != m_PipelineShader)
+                continue;
+
+            try {
+                VkPipeline oldPipeline = m_Pipeline.recreate(shader.get(m_ShaderFeatures));
+                m_CommandPool.getDeletionQueue().release(oldPipeline);
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+            }
+        }
+    }
+
+    void Renderer::reloadComputeShaders(const std::string& filepath) {
+        for (auto& computePipeline : m_ComputePipelines) {
+            if (computePipeline.getShader().getFilepath() != filepath || !computePipeline.getShader().reload())
+                continue;
+
+            try {
+                VkPipeline oldPipeline = computePipeline.recreate();
+                m_CommandPool.getDeletionQueue().release(oldPipeline);
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+            }
+        }
+    }
+
+    void Renderer::reloadTexture2D(TextureHandle handle) {
+        Texture2D* texture = m_Textures.get(handle);
+        Texture2D reloaded;
+        try {
+            reloaded = loadTexture2D(texture->filepath.c_str());
+        } catch (const std::exception& e) {
+            std::cerr << "Renderer::reloadTexture2D: " << e.what() << std::endl;
+            return;
+        }
+
+        // handle stays the same, old resources live until frames in flight are done with them
+        reloaded.filepath = texture->filepath;
+        releaseTexture2D(std::move(*texture));
+        *texture = std::move(reloaded);
+
+        // every frame set is rewritten once its frame slot is idle
+        if (handle == m_BoundTexture) {
+            m_TextureDescriptorDirty.assign(m_CommandPool.getMaxFramesInFlight(), true);
+        }
+    }
+
+    void Renderer::releaseTexture2D(Texture2D&& texture) {
+        DeletionQueue& deletionQueue = m_CommandPool.getDeletionQueue();
+        deletionQueue.release(std::move(texture.sampler));
+        deletionQueue.release(std::move(texture.view));
+        deletionQueue.release(std::move(texture.image));
+    }
+
+    void Renderer::cookTexture2D(const char* srcFilepath, const char* dstFilepath, bool srgb) {
+        // ordered by quality, throws if device has no BC support at all
+        VkFormat format = m_Device.findSupportedFormat(
+                {
+                    BlockCompressor::toVkFormat(BlockFormat::BC7, srgb),
+                    BlockCompressor::toVkFormat(BlockFormat::BC3, srgb),
+                    BlockCompressor::toVkFormat(BlockFormat::BC1, srgb)
+                },
+                VK_IMAGE_TILING_OPTIMAL,
+                VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT
+        );
+
+        CookSettings settings;
+        settings.srgb = srgb;
+        if (format == BlockCompressor::toVkFormat(BlockFormat::BC7, srgb)) {
+            settings.format = BlockFormat::BC7;
+        } else if (format == BlockCompressor::toVkFormat(BlockFormat::BC3, srgb)) {
+            settings.format = BlockFormat::BC3;
+        } else {
+            settings.format = BlockFormat::BC1;
+        }
+
+        TextureCooker::cook(srcFilepath, dstFilepath, settings, &m_ThreadPool);
     }
 
     static std::vector<ImFont*> uiFonts;
@@ -601,7 +1595,16 @@ namespace rdk {
         init_info.CheckVkResultFn = handleImGuiVkResult;
         init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
 
-        bool vulkanStatus = ImGui_ImplVulkan_Init(&init_info, m_RenderPass->getHandle());
+        VkRenderPass uiRenderPass = VK_NULL_HANDLE;
+        if (m_SwapChain->isDynamicRendering()) {
+            // drawn in color only pass, see CommandPool::endFrame()
+            init_info.UseDynamicRendering = true;
+            init_info.ColorAttachmentFormat = m_SwapChain->getColorFormat();
+        } else {
+            uiRenderPass = m_RenderPass->getHandle();
+        }
+
+        bool vulkanStatus = ImGui_ImplVulkan_Init(&init_info, uiRenderPass);
         rect_assert(vulkanStatus, "Failed to initialize ImGui Vulkan bindings")
         // load fonts
         VkCommandBuffer tempCommand = m_CommandPool.beginTempCommand();
@@ -1,26 +1,13 @@
 #include <Shader.h>
+#include <SpirvTools.h>
 
 #include <shaderc/shaderc.hpp>
 
-#include <fstream>
+#include <cstdio>
 #include <iostream>
 
 namespace rdk {
 
-    static std::vector<char> readFile(const char* filepath) {
-        std::ifstream file(filepath, std::ios::ate | std::ios::binary);
-        rect_assert(file.is_open(), "Failed to open file %s\n", filepath)
-
-        size_t fileSize = (size_t) file.tellg();
-        std::vector<char> buffer(fileSize);
-        file.seekg(0);
-        file.read(buffer.data(), fileSize);
-
-        file.close();
-
-        return buffer;
-    }
-
     static void createModule(VkDevice device, const std::vector<u32>& spirvCode, VkShaderModule* module) {
         VkShaderModuleCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -50,61 +37,256 @@ namespace rdk {
         }
     }
 
+    static ShaderCompileSettings s_CompileSettings;
+
+    static shaderc_optimization_level getOptimizationLevel(ShaderOptimization optimization) {
+        switch (optimization) {
+            case ShaderOptimization::NONE:
+                return shaderc_optimization_level_zero;
+            case ShaderOptimization::SIZE:
+                return shaderc_optimization_level_size;
+            default:
+                return shaderc_optimization_level_performance;
+        }
+    }
+
     static std::vector<u32> compile(
             const char* filepath,
             const char* entryPointName,
-            const VkShaderStageFlagBits shaderType
+            const VkShaderStageFlagBits shaderType,
+            const AssetPack* assetPack,
+            const std::vector<std::string>& defines = {}
     ) {
-        auto shaderCode = readFile(filepath);
+        AssetBlob shaderCode = AssetPack::loadAsset(filepath, assetPack);
 
         shaderc::Compiler compiler;
         shaderc::CompileOptions options;
-        shaderc::SpvCompilationResult spvModule;
 
         options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_1);
-        options.SetOptimizationLevel(shaderc_optimization_level_performance);
-
-        spvModule = compiler.CompileGlslToSpv(
-                shaderCode.data(),
-                shaderCode.size(),
-                getShaderType(shaderType),
-                filepath,
-                entryPointName,
-                options
-        );
-
-        if (spvModule.GetCompilationStatus() != shaderc_compilation_status_success) {
-            std::cerr << spvModule.GetErrorMessage();
-            throw std::runtime_error("Shader::compile: Failed to compile GLSL into SPIR-V. Check error message above");
+        if (s_CompileSettings.debugInfo) {
+            options.SetGenerateDebugInfo();
+        }
+        for (const auto& define : defines) {
+            options.AddMacroDefinition(define);
+        }
+
+        auto compileModule = [&](shaderc_optimization_level level) {
+            options.SetOptimizationLevel(level);
+            shaderc::SpvCompilationResult spvModule = compiler.CompileGlslToSpv(
+                    reinterpret_cast<const char*>(shaderCode.data()),
+                    shaderCode.size(),
+                    getShaderType(shaderType),
+                    filepath,
+                    entryPointName,
+                    options
+            );
+
+            if (spvModule.GetCompilationStatus() != shaderc_compilation_status_success) {
+                std::cerr << spvModule.GetErrorMessage();
+                throw std::runtime_error("Shader::compile: Failed to compile GLSL into SPIR-V. Check error message above");
+            }
+
+            std::vector<u32> spirv(spvModule.begin(), spvModule.end());
+            if (!s_CompileSettings.debugInfo) {
+                SpirvTools::stripDebugInfo(spirv);
+            }
+            return spirv;
+        };
+
+        std::vector<u32> spirv = compileModule(getOptimizationLevel(s_CompileSettings.optimization));
+
+        if (s_CompileSettings.validate && !SpirvTools::validate(spirv, filepath)) {
+            throw std::runtime_error("Shader::compile: SPIR-V failed validation. Check error message above");
+        }
+
+        if (s_CompileSettings.logStats) {
+            SpirvStats before = SpirvTools::getStats(compileModule(shaderc_optimization_level_zero));
+            SpirvStats after = SpirvTools::getStats(spirv);
+            printf("Shader::compile: %s %zu -> %zu bytes, %u -> %u instructions\n",
+                   filepath, before.bytes, after.bytes, before.instructions, after.instructions);
         }
 
-        return { spvModule.begin(), spvModule.end() };
+        return spirv;
+    }
+
+    void Shader::setCompileSettings(const ShaderCompileSettings& settings) {
+        s_CompileSettings = settings;
+    }
+
+    const ShaderCompileSettings& Shader::getCompileSettings() {
+        return s_CompileSettings;
     }
 
-    Shader::Shader(VkDevice logicalDevice, const std::string &vertFilepath, const std::string &fragFilepath) {
+    Shader::Shader(
+            VkDevice logicalDevice,
+            const std::string &vertFilepath,
+            const std::string &fragFilepath,
+            const AssetPack* assetPack,
+            const std::vector<std::string>& defines
+    ) {
         m_LogicalDevice = logicalDevice;
+        m_AssetPack = assetPack;
+        m_VertFilepath = vertFilepath;
+        m_FragFilepath = fragFilepath;
+        m_Defines = defines;
         // setup vertex shader
-        auto vertBytecode = compile(vertFilepath.c_str(), "main", VK_SHADER_STAGE_VERTEX_BIT);
+        auto vertBytecode = compile(vertFilepath.c_str(), "main", VK_SHADER_STAGE_VERTEX_BIT, assetPack, defines);
         createModule(m_LogicalDevice, vertBytecode, &m_VertModule);
         m_VertStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         m_VertStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
         m_VertStage.pName = "main";
         m_VertStage.module = m_VertModule;
+        m_Reflected = ShaderReflection::reflect(vertBytecode, VK_SHADER_STAGE_VERTEX_BIT, &m_VertLayout);
         // setup fragment shader
-        auto fragBytecode = compile(fragFilepath.c_str(), "main", VK_SHADER_STAGE_FRAGMENT_BIT);
+        auto fragBytecode = compile(fragFilepath.c_str(), "main", VK_SHADER_STAGE_FRAGMENT_BIT, assetPack, defines);
         createModule(m_LogicalDevice, fragBytecode, &m_FragModule);
         m_FragStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         m_FragStage.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
         m_FragStage.pName = "main";
         m_FragStage.module = m_FragModule;
+        m_Reflected = ShaderReflection::reflect(fragBytecode, VK_SHADER_STAGE_FRAGMENT_BIT, &m_FragLayout) && m_Reflected;
+        m_Reflected = m_Reflected && mergeLayouts(&m_Layout);
+        if (!m_Reflected) {
+            std::cerr << "Shader: " << vertFilepath << " and " << fragFilepath << " have no reflected layout" << std::endl;
+        }
+    }
+
+    bool Shader::mergeLayouts(ShaderLayout* layout) const {
+        *layout = m_VertLayout;
+        return layout->merge(m_FragLayout);
+    }
+
+    bool Shader::reload(VkShaderStageFlagBits stage) {
+        bool vertex = stage == VK_SHADER_STAGE_VERTEX_BIT;
+        const std::string& filepath = vertex ? m_VertFilepath : m_FragFilepath;
+
+        std::vector<u32> bytecode;
+        try {
+            bytecode = compile(filepath.c_str(), "main", stage, m_AssetPack, m_Defines);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return false;
+        }
+
+        // stage stays reloadable without reflection, as long as it had none before either
+        if (m_Reflected) {
+            ShaderLayout& stageLayout = vertex ? m_VertLayout : m_FragLayout;
+            ShaderLayout oldStageLayout = stageLayout;
+            ShaderLayout layout;
+            bool reflected = ShaderReflection::reflect(bytecode, stage, &stageLayout) && mergeLayouts(&layout);
+            if (!reflected || layout != m_Layout) {
+                std::cerr << "Shader::reload: " << filepath << " changed its resource layout, restart to apply it" << std::endl;
+                stageLayout = oldStageLayout;
+                return false;
+            }
+        }
+
+        VkShaderModule module;
+        createModule(m_LogicalDevice, bytecode, &module);
+
+        VkShaderModule& oldModule = vertex ? m_VertModule : m_FragModule;
+        vkDestroyShaderModule(m_LogicalDevice, oldModule, nullptr);
+        oldModule = module;
+        (vertex ? m_VertStage : m_FragStage).module = module;
+        return true;
     }
 
     Shader::~Shader() {
         cleanup();
     }
 
+    Shader::Shader(Shader&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    Shader& Shader::operator=(Shader&& other) noexcept {
+        if (this != &other) {
+            cleanup();
+            m_LogicalDevice = other.m_LogicalDevice;
+            m_AssetPack = other.m_AssetPack;
+            m_VertFilepath = std::move(other.m_VertFilepath);
+            m_FragFilepath = std::move(other.m_FragFilepath);
+            m_Defines = std::move(other.m_Defines);
+            m_VertStage = other.m_VertStage;
+            m_VertModule = other.m_VertModule;
+            m_FragStage = other.m_FragStage;
+            m_FragModule = other.m_FragModule;
+            m_VertLayout = std::move(other.m_VertLayout);
+            m_FragLayout = std::move(other.m_FragLayout);
+            m_Layout = std::move(other.m_Layout);
+            m_Reflected = other.m_Reflected;
+            other.m_VertModule = VK_NULL_HANDLE;
+            other.m_FragModule = VK_NULL_HANDLE;
+        }
+        return *this;
+    }
+
     void Shader::cleanup() {
+        if (m_LogicalDevice == VK_NULL_HANDLE)
+            return;
+
         vkDestroyShaderModule(m_LogicalDevice, m_VertModule, nullptr);
         vkDestroyShaderModule(m_LogicalDevice, m_FragModule, nullptr);
+        m_VertModule = VK_NULL_HANDLE;
+        m_FragModule = VK_NULL_HANDLE;
+    }
+
+    ComputeShader::ComputeShader(VkDevice logicalDevice, const std::string& filepath, const AssetPack* assetPack) {
+        m_LogicalDevice = logicalDevice;
+        m_AssetPack = assetPack;
+        m_Filepath = filepath;
+        // setup compute shader
+        auto bytecode = compile(filepath.c_str(), "main", VK_SHADER_STAGE_COMPUTE_BIT, assetPack);
+        createModule(m_LogicalDevice, bytecode, &m_Module);
+        m_Stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        m_Stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        m_Stage.pName = "main";
+        m_Stage.module = m_Module;
+    }
+
+    bool ComputeShader::reload() {
+        std::vector<u32> bytecode;
+        try {
+            bytecode = compile(m_Filepath.c_str(), "main", VK_SHADER_STAGE_COMPUTE_BIT, m_AssetPack);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return false;
+        }
+
+        VkShaderModule module;
+        createModule(m_LogicalDevice, bytecode, &module);
+        vkDestroyShaderModule(m_LogicalDevice, m_Module, nullptr);
+        m_Module = module;
+        m_Stage.module = module;
+        return true;
+    }
+
+    ComputeShader::~ComputeShader() {
+        cleanup();
+    }
+
+    ComputeShader::ComputeShader(ComputeShader&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    ComputeShader& ComputeShader::operator=(ComputeShader&& other) noexcept {
+        if (this != &other) {
+            cleanup();
+            m_LogicalDevice = other.m_LogicalDevice;
+            m_AssetPack = other.m_AssetPack;
+            m_Filepath = std::move(other.m_Filepath);
+            m_Stage = other.m_Stage;
+            m_Module = other.m_Module;
+            other.m_Module = VK_NULL_HANDLE;
+        }
+        return *this;
+    }
+
+    void ComputeShader::cleanup() {
+        if (m_LogicalDevice == VK_NULL_HANDLE)
+            return;
+
+        vkDestroyShaderModule(m_LogicalDevice, m_Module, nullptr);
+        m_Module = VK_NULL_HANDLE;
     }
 }
\ No newline at end of file
@@ -0,0 +1,304 @@
+#include <ShaderReflection.h>
+
+#include <spirv_cross/spirv_cross_c.h>
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+namespace rdk {
+
+    static bool addBinding(
+            std::vector<std::vector<VkDescriptorSetLayoutBinding>>& sets,
+            u32 set,
+            const VkDescriptorSetLayoutBinding& binding
+    ) {
+        if (set >= sets.size()) {
+            sets.resize(set + 1);
+        }
+        auto& bindings = sets[set];
+        auto it = std::lower_bound(bindings.begin(), bindings.end(), binding.binding,
+                [](const VkDescriptorSetLayoutBinding& b, u32 index) { return b.binding < index; });
+
+        if (it == bindings.end() || it->binding != binding.binding) {
+            bindings.insert(it, binding);
+            return true;
+        }
+        if (it->descriptorType != binding.descriptorType || it->descriptorCount != binding.descriptorCount) {
+            std::cerr << "ShaderReflection: set " << set << " binding " << binding.binding
+                      << " is declared with different types by shader stages" << std::endl;
+            return false;
+        }
+        it->stageFlags |= binding.stageFlags;
+        return true;
+    }
+
+    static void addPushConstants(std::vector<VkPushConstantRange>& ranges, const VkPushConstantRange& range) {
+        for (auto& r : ranges) {
+            if (r.offset == range.offset && r.size == range.size) {
+                r.stageFlags |= range.stageFlags;
+                return;
+            }
+        }
+        ranges.push_back(range);
+    }
+
+    static VkFormat getVertexFormat(spvc_basetype baseType, u32 components) {
+        static const VkFormat floatFormats[] = {
+                VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT
+        };
+        static const VkFormat intFormats[] = {
+                VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT
+        };
+        static const VkFormat uintFormats[] = {
+                VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT
+        };
+
+        if (components < 1 || components > 4)
+            return VK_FORMAT_UNDEFINED;
+
+        switch (baseType) {
+            case SPVC_BASETYPE_FP32:
+                return floatFormats[components - 1];
+            case SPVC_BASETYPE_INT32:
+                return intFormats[components - 1];
+            case SPVC_BASETYPE_UINT32:
+                return uintFormats[components - 1];
+            default:
+                return VK_FORMAT_UNDEFINED;
+        }
+    }
+
+    // product of array dimensions, 0 for runtime and specialization sized arrays
+    static u32 getDescriptorCount(spvc_type type) {
+        u32 count = 1;
+        u32 dimensions = spvc_type_get_num_array_dimensions(type);
+        for (u32 i = 0 ; i < dimensions ; i++) {
+            if (!spvc_type_array_dimension_is_literal(type, i))
+                return 0;
+            count *= spvc_type_get_array_dimension(type, i);
+        }
+        return count;
+    }
+
+    static bool reflectDescriptors(
+            spvc_compiler compiler,
+            spvc_resources resources,
+            VkShaderStageFlagBits stage,
+            ShaderLayout* layout
+    ) {
+        static const std::pair<spvc_resource_type, VkDescriptorType> descriptorTypes[] = {
+                { SPVC_RESOURCE_TYPE_UNIFORM_BUFFER, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER },
+                { SPVC_RESOURCE_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER },
+                { SPVC_RESOURCE_TYPE_SAMPLED_IMAGE, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER },
+                { SPVC_RESOURCE_TYPE_SEPARATE_IMAGE, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE },
+                { SPVC_RESOURCE_TYPE_SEPARATE_SAMPLERS, VK_DESCRIPTOR_TYPE_SAMPLER },
+                { SPVC_RESOURCE_TYPE_STORAGE_IMAGE, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE },
+                { SPVC_RESOURCE_TYPE_SUBPASS_INPUT, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT }
+        };
+
+        for (const auto& descriptorType : descriptorTypes) {
+            const spvc_reflected_resource* list = nullptr;
+            size_t count = 0;
+            spvc_resources_get_resource_list_for_type(resources, descriptorType.first, &list, &count);
+
+            for (size_t i = 0 ; i < count ; i++) {
+                const spvc_reflected_resource& resource = list[i];
+                // texel buffers are images of buffer dimension, which are not mapped here
+                if (descriptorType.first == SPVC_RESOURCE_TYPE_SEPARATE_IMAGE || descriptorType.first == SPVC_RESOURCE_TYPE_STORAGE_IMAGE) {
+                    spvc_type baseType = spvc_compiler_get_type_handle(compiler, resource.base_type_id);
+                    if (spvc_type_get_image_dimension(baseType) == SpvDimBuffer) {
+                        std::cerr << "ShaderReflection::reflect: texel buffer " << resource.name << " is not supported" << std::endl;
+                        return false;
+                    }
+                }
+
+                VkDescriptorSetLayoutBinding binding{};
+                binding.binding = spvc_compiler_get_decoration(compiler, resource.id, SpvDecorationBinding);
+                binding.descriptorType = descriptorType.second;
+                binding.descriptorCount = getDescriptorCount(spvc_compiler_get_type_handle(compiler, resource.type_id));
+                binding.stageFlags = stage;
+                if (binding.descriptorCount == 0) {
+                    std::cerr << "ShaderReflection::reflect: " << resource.name << " is not sized by literal" << std::endl;
+                    return false;
+                }
+
+                u32 set = spvc_compiler_get_decoration(compiler, resource.id, SpvDecorationDescriptorSet);
+                if (!addBinding(layout->sets, set, binding))
+                    return false;
+            }
+        }
+
+        const spvc_reflected_resource* pushConstants = nullptr;
+        size_t pushConstantCount = 0;
+        spvc_resources_get_resource_list_for_type(resources, SPVC_RESOURCE_TYPE_PUSH_CONSTANT, &pushConstants, &pushConstantCount);
+        for (size_t i = 0 ; i < pushConstantCount ; i++) {
+            spvc_type type = spvc_compiler_get_type_handle(compiler, pushConstants[i].base_type_id);
+            size_t size = 0;
+            unsigned offset = 0;
+            spvc_compiler_get_declared_struct_size(compiler, type, &size);
+            // stages often share one block and use members at different offsets, range starts at first of them
+            if (spvc_type_get_num_member_types(type) > 0) {
+                spvc_compiler_type_struct_member_offset(compiler, type, 0, &offset);
+            }
+
+            VkPushConstantRange range{};
+            range.stageFlags = stage;
+            range.offset = offset;
+            range.size = static_cast<u32>(size) - offset;
+            addPushConstants(layout->pushConstants, range);
+        }
+
+        return true;
+    }
+
+    static bool reflectVertexInput(spvc_compiler compiler, spvc_resources resources, ShaderLayout* layout) {
+        const spvc_reflected_resource* inputs = nullptr;
+        size_t inputCount = 0;
+        spvc_resources_get_resource_list_for_type(resources, SPVC_RESOURCE_TYPE_STAGE_INPUT, &inputs, &inputCount);
+
+        std::vector<VkVertexInputAttributeDescription> attributes;
+        std::vector<u32> sizes;
+        for (size_t i = 0 ; i < inputCount ; i++) {
+            spvc_type type = spvc_compiler_get_type_handle(compiler, inputs[i].type_id);
+            u32 components = spvc_type_get_vector_size(type);
+            VkFormat format = getVertexFormat(spvc_type_get_basetype(type), components);
+            if (format == VK_FORMAT_UNDEFINED || spvc_type_get_columns(type) != 1 || spvc_type_get_num_array_dimensions(type) != 0) {
+                std::cerr << "ShaderReflection::reflect: vertex input " << inputs[i].name
+                          << " is not a 32 bit scalar or vector" << std::endl;
+                return false;
+            }
+
+            VkVertexInputAttributeDescription attribute{};
+            attribute.location = spvc_compiler_get_decoration(compiler, inputs[i].id, SpvDecorationLocation);
+            attribute.binding = 0;
+            attribute.format = format;
+            attributes.push_back(attribute);
+            sizes.push_back(components * 4);
+        }
+
+        std::vector<u32> order(attributes.size());
+        for (u32 i = 0 ; i < order.size() ; i++) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&attributes](u32 l, u32 r) {
+            return attributes[l].location < attributes[r].location;
+        });
+
+        layout->vertexAttributes.clear();
+        layout->vertexStride = 0;
+        for (u32 i : order) {
+            VkVertexInputAttributeDescription attribute = attributes[i];
+            attribute.offset = layout->vertexStride;
+            layout->vertexStride += sizes[i];
+            layout->vertexAttributes.push_back(attribute);
+        }
+        return true;
+    }
+
+    bool ShaderReflection::reflect(const std::vector<u32>& spirv, VkShaderStageFlagBits stage, ShaderLayout* layout) {
+        *layout = {};
+
+        spvc_context context = nullptr;
+        if (spvc_context_create(&context) != SPVC_SUCCESS) {
+            std::cerr << "ShaderReflection::reflect: failed to create SPIRV-Cross context" << std::endl;
+            return false;
+        }
+
+        spvc_parsed_ir ir = nullptr;
+        spvc_compiler compiler = nullptr;
+        spvc_resources resources = nullptr;
+        bool reflected = spvc_context_parse_spirv(context, spirv.data(), spirv.size(), &ir) == SPVC_SUCCESS
+                && spvc_context_create_compiler(context, SPVC_BACKEND_NONE, ir, SPVC_CAPTURE_MODE_TAKE_OWNERSHIP, &compiler) == SPVC_SUCCESS
+                && spvc_compiler_create_shader_resources(compiler, &resources) == SPVC_SUCCESS;
+        if (!reflected) {
+            std::cerr << "ShaderReflection::reflect: " << spvc_context_get_last_error_string(context) << std::endl;
+        }
+
+        reflected = reflected && reflectDescriptors(compiler, resources, stage, layout);
+        if (reflected && stage == VK_SHADER_STAGE_VERTEX_BIT) {
+            reflected = reflectVertexInput(compiler, resources, layout);
+        }
+
+        // releases parsed IR, compiler and resources too
+        spvc_context_destroy(context);
+        return reflected;
+    }
+
+    bool ShaderLayout::merge(const ShaderLayout& other) {
+        for (u32 set = 0 ; set < other.sets.size() ; set++) {
+            for (const auto& binding : other.sets[set]) {
+                if (!addBinding(sets, set, binding))
+                    return false;
+            }
+        }
+        // set without bindings still takes its index, so layout of every set is created
+        if (sets.size() < other.sets.size()) {
+            sets.resize(other.sets.size());
+        }
+
+        for (const auto& range : other.pushConstants) {
+            addPushConstants(pushConstants, range);
+        }
+
+        if (!other.vertexAttributes.empty()) {
+            vertexAttributes = other.vertexAttributes;
+            vertexStride = other.vertexStride;
+        }
+        return true;
+    }
+
+    std::vector<VkDescriptorPoolSize> ShaderLayout::getPoolSizes(u32 set, u32 maxSets) const {
+        std::vector<VkDescriptorPoolSize> poolSizes;
+        if (set >= sets.size())
+            return poolSizes;
+
+        for (const auto& binding : sets[set]) {
+            auto it = std::find_if(poolSizes.begin(), poolSizes.end(), [&binding](const VkDescriptorPoolSize& size) {
+                return size.type == binding.descriptorType;
+            });
+            if (it == poolSizes.end()) {
+                poolSizes.push_back({ binding.descriptorType, 0 });
+                it = poolSizes.end() - 1;
+            }
+            it->descriptorCount += binding.descriptorCount * maxSets;
+        }
+        return poolSizes;
+    }
+
+    bool ShaderLayout::operator==(const ShaderLayout& other) const {
+        if (sets.size() != other.sets.size()
+            || pushConstants.size() != other.pushConstants.size()
+            || vertexAttributes.size() != other.vertexAttributes.size()
+            || vertexStride != other.vertexStride)
+            return false;
+
+        for (size_t set = 0 ; set < sets.size() ; set++) {
+            const auto& l = sets[set];
+            const auto& r = other.sets[set];
+            if (l.size() != r.size())
+                return false;
+            for (size_t i = 0 ; i < l.size() ; i++) {
+                if (l[i].binding != r[i].binding || l[i].descriptorType != r[i].descriptorType
+                    || l[i].descriptorCount != r[i].descriptorCount || l[i].stageFlags != r[i].stageFlags)
+                    return false;
+            }
+        }
+
+        for (size_t i = 0 ; i < pushConstants.size() ; i++) {
+            const auto& l = pushConstants[i];
+            const auto& r = other.pushConstants[i];
+            if (l.stageFlags != r.stageFlags || l.offset != r.offset || l.size != r.size)
+                return false;
+        }
+
+        for (size_t i = 0 ; i < vertexAttributes.size() ; i++) {
+            const auto& l = vertexAttributes[i];
+            const auto& r = other.vertexAttributes[i];
+            if (l.location != r.location || l.binding != r.binding || l.format != r.format || l.offset != r.offset)
+                return false;
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,76 @@
+#include <ShaderVariants.h>
+
+namespace rdk {
+
+    ShaderVariants::ShaderVariants(
+            VkDevice logicalDevice,
+            const std::string& vertFilepath,
+            const std::string& fragFilepath,
+            const std::vector<ShaderFeature>& features,
+            const AssetPack* assetPack
+    ) {
+        rect_assert(features.size() <= MAX_FEATURES, "ShaderVariants: too many features for 32 bit mask")
+        m_LogicalDevice = logicalDevice;
+        m_AssetPack = assetPack;
+        m_VertFilepath = vertFilepath;
+        m_FragFilepath = fragFilepath;
+        m_Features = features;
+        get(0);
+    }
+
+    u32 ShaderVariants::getDefineMask() const {
+        u32 mask = 0;
+        for (u32 i = 0 ; i < m_Features.size() ; i++) {
+            if (m_Features[i].define) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+    }
+
+    Shader& ShaderVariants::get(u32 features) {
+        u32 key = features & getDefineMask();
+        auto it = m_Variants.find(key);
+        if (it != m_Variants.end())
+            return it->second;
+
+        std::vector<std::string> defines;
+        for (u32 i = 0 ; i < m_Features.size() ; i++) {
+            if (key & (1u << i)) {
+                defines.push_back(m_Features[i].name);
+            }
+        }
+
+        Shader shader(m_LogicalDevice, m_VertFilepath, m_FragFilepath, m_AssetPack, defines);
+        return m_Variants.emplace(key, std::move(shader)).first->second;
+    }
+
+    void ShaderVariants::getSpecialization(
+            u32 features,
+            std::vector<VkSpecializationMapEntry>* entries,
+            std::vector<VkBool32>* data
+    ) const {
+        entries->clear();
+        data->clear();
+        for (u32 i = 0 ; i < m_Features.size() ; i++) {
+            if (m_Features[i].define)
+                continue;
+
+            VkSpecializationMapEntry entry;
+            entry.constantID = i;
+            entry.offset = static_cast<u32>(data->size() * sizeof(VkBool32));
+            entry.size = sizeof(VkBool32);
+            entries->push_back(entry);
+            data->push_back((features & (1u << i)) ? VK_TRUE : VK_FALSE);
+        }
+    }
+
+    bool ShaderVariants::reload(VkShaderStageFlagBits stage) {
+        bool reloaded = false;
+        for (auto& variant : m_Variants) {
+            reloaded |= variant.second.reload(stage);
+        }
+        return reloaded;
+    }
+
+}
@@ -0,0 +1,92 @@
+#include <SpirvTools.h>
+
+#include <spirv-headers/spirv.h>
+#include <spirv-tools/libspirv.h>
+
+#include <cstring>
+#include <iostream>
+
+namespace rdk {
+
+    static const size_t HEADER_WORDS = 5;
+
+    SpirvStats SpirvTools::getStats(const std::vector<u32>& spirv) {
+        SpirvStats stats;
+        stats.bytes = spirv.size() * sizeof(u32);
+        for (size_t i = HEADER_WORDS ; i < spirv.size() ; i += spirv[i] >> 16) {
+            // zero word count would loop forever on malformed module
+            if ((spirv[i] >> 16) == 0)
+                break;
+            stats.instructions++;
+        }
+        return stats;
+    }
+
+    void SpirvTools::stripDebugInfo(std::vector<u32>& spirv) {
+        if (spirv.size() < HEADER_WORDS)
+            return;
+
+        // malformed module is left as is, so the words are never moved partially
+        bool nonSemantic = false;
+        for (size_t i = HEADER_WORDS ; i < spirv.size() ; i += spirv[i] >> 16) {
+            u32 wordCount = spirv[i] >> 16;
+            if (wordCount == 0 || i + wordCount > spirv.size())
+                return;
+            // literal name of imported set starts at word 2
+            if ((spirv[i] & 0xffff) == SpvOpExtInstImport && wordCount > 2) {
+                const char* name = reinterpret_cast<const char*>(&spirv[i + 2]);
+                nonSemantic |= strncmp(name, "NonSemantic.", 12) == 0;
+            }
+        }
+
+        size_t dst = HEADER_WORDS;
+        for (size_t src = HEADER_WORDS ; src < spirv.size() ; ) {
+            u32 wordCount = spirv[src] >> 16;
+            bool strip;
+            switch (spirv[src] & 0xffff) {
+                case SpvOpSourceContinued:
+                case SpvOpSource:
+                case SpvOpSourceExtension:
+                case SpvOpName:
+                case SpvOpMemberName:
+                case SpvOpLine:
+                case SpvOpNoLine:
+                case SpvOpModuleProcessed:
+                    strip = true;
+                    break;
+                case SpvOpString:
+                    strip = !nonSemantic;
+                    break;
+                default:
+                    strip = false;
+                    break;
+            }
+
+            if (!strip) {
+                if (dst != src) {
+                    memmove(&spirv[dst], &spirv[src], wordCount * sizeof(u32));
+                }
+                dst += wordCount;
+            }
+            src += wordCount;
+        }
+        spirv.resize(dst);
+    }
+
+    bool SpirvTools::validate(const std::vector<u32>& spirv, const char* name) {
+        spv_context context = spvContextCreate(SPV_ENV_VULKAN_1_1);
+        spv_diagnostic diagnostic = nullptr;
+        spv_result_t result = spvValidateBinary(context, spirv.data(), spirv.size(), &diagnostic);
+        if (result != SPV_SUCCESS) {
+            std::cerr << "SpirvTools::validate: " << name;
+            if (diagnostic != nullptr) {
+                std::cerr << ", word " << diagnostic->position.index << ": " << diagnostic->error;
+            }
+            std::cerr << std::endl;
+        }
+        spvDiagnosticDestroy(diagnostic);
+        spvContextDestroy(context);
+        return result == SPV_SUCCESS;
+    }
+
+}
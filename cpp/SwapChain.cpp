@@ -17,12 +17,50 @@ namespace rdk {
         create(window, surface);
         createColorImages();
         createDepthImage();
+        createRenderPasses();
+        createFrameBuffers();
+    }
+
+    RenderPassInfo SwapChain::getRenderPassInfo() const {
+        RenderPassInfo info;
+        info.depthStoreOp = m_DepthStored ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        return info;
+    }
 
-        m_RenderPass = new RenderPass(m_Device->getLogicalHandle(), m_ColorFormat, m_DepthFormat);
+    void SwapChain::setDepthStored(bool stored) {
+        if (m_DepthStored == stored)
+            return;
 
+        m_DepthStored = stored;
+        // store op doesn't affect render pass compatibility, so pipelines built against old pass stay valid
+        m_FrameBuffers.clear();
+        destroyRenderPasses();
+        createDepthImage();
+        createRenderPasses();
         createFrameBuffers();
     }
 
+    void SwapChain::createRenderPasses() {
+        if (isDynamicRendering())
+            return;
+
+        m_RenderPass = new RenderPass(m_Device->getLogicalHandle(), m_ColorFormat, m_DepthFormat, getRenderPassInfo());
+        // only used by passes suspended to read depth, so depth is always stored
+        RenderPassInfo resumeInfo;
+        resumeInfo.colorLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+        resumeInfo.colorInitialLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        resumeInfo.depthLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+        resumeInfo.depthInitialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        m_ResumeRenderPass = new RenderPass(m_Device->getLogicalHandle(), m_ColorFormat, m_DepthFormat, resumeInfo);
+    }
+
+    void SwapChain::destroyRenderPasses() {
+        delete m_ResumeRenderPass;
+        delete m_RenderPass;
+        m_ResumeRenderPass = nullptr;
+        m_RenderPass = nullptr;
+    }
+
     void SwapChain::create(void *window, VkSurfaceKHR surface) {
         VkDevice device = m_Device->getLogicalHandle();
         VkPhysicalDevice physicalDevice = m_Device->getPhysicalHandle();
@@ -48,7 +86,12 @@ namespace rdk {
         createInfo.imageColorSpace = surfaceFormat.colorSpace;
         createInfo.imageExtent = extent;
         createInfo.imageArrayLayers = 1;
-        createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        // upscaled scene is blitted into swap chain image, see DynamicResolution
+        m_ImageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        if (capabilities->supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) {
+            m_ImageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        }
+        createInfo.imageUsage = m_ImageUsage;
         // setup queue families
         int queueFamilyIndices[] = { indices.graphicsFamily, indices.presentationFamily };
 
@@ -68,8 +111,8 @@ namespace rdk {
         // setup presentation mode
         createInfo.presentMode = presentMode;
         createInfo.clipped = VK_TRUE;
-        // setup swap chain lifecycle
-        createInfo.oldSwapchain = VK_NULL_HANDLE;
+        // setup swap chain lifecycle, presentation engine may reuse resources of the old one
+        createInfo.oldSwapchain = m_Handle;
         // create swap chain
         auto swapChainStatus = vkCreateSwapchainKHR(device, &createInfo, nullptr, &m_Handle);
         rect_assert(swapChainStatus == VK_SUCCESS, "Failed to create Vulkan swap chain")
@@ -95,6 +138,9 @@ namespace rdk {
 
     void SwapChain::createFrameBuffers() {
         m_FrameBuffers.clear();
+        if (isDynamicRendering())
+            return;
+
         m_FrameBuffers.reserve(m_ImageViews.size());
         VkRenderPass renderPass = m_RenderPass->getHandle();
         VkExtent2D extent = m_Extent;
@@ -114,21 +160,35 @@ namespace rdk {
         }
     }
 
-    void SwapChain::recreate(void *window, VkSurfaceKHR surface) {
-        recreate(window, surface, m_Device->findQueueFamily(surface));
-    }
-
-    void SwapChain::recreate(void* window, VkSurfaceKHR surface, const QueueFamilyIndices& familyIndices) {
-        vkDestroySwapchainKHR(m_Device->getLogicalHandle(), m_Handle, nullptr);
-        m_DepthImageView->~ImageView();
-        m_DepthImage->~Image();
-        // create again
+    void SwapChain::recreate(void* window, VkSurfaceKHR surface, DeletionQueue& deletionQueue) {
+        VkSwapchainKHR oldHandle = m_Handle;
         create(window, surface);
+        // old images may still be rendered or presented by frames in flight
+        deletionQueue.release(oldHandle);
+        for (auto& frameBuffer : m_FrameBuffers) {
+            deletionQueue.release(std::move(frameBuffer));
+        }
+        for (auto& imageView : m_ImageViews) {
+            deletionQueue.release(std::move(imageView));
+        }
+        deletionQueue.release(std::move(*m_DepthImageView));
+        deletionQueue.release(std::move(*m_DepthImage));
+        // create again
         createColorImages();
         createDepthImage();
         createFrameBuffers();
     }
 
+    RenderingTarget SwapChain::getRenderingTarget(u32 imageIndex) const {
+        RenderingTarget target;
+        target.colorImage = m_Images[imageIndex];
+        target.colorView = m_ImageViews[imageIndex].getHandle();
+        target.depthImage = m_DepthImage->getHandle();
+        target.depthView = m_DepthImageView->getHandle();
+        target.depthFormat = m_DepthFormat;
+        return target;
+    }
+
     SwapChainSupportDetails SwapChain::querySwapChainSupport(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface) {
         SwapChainSupportDetails details;
         // query base surface capabilities
@@ -189,7 +249,7 @@ namespace rdk {
     }
 
     SwapChain::~SwapChain() {
-        delete m_RenderPass;
+        destroyRenderPasses();
 
         m_FrameBuffers.clear();
 
@@ -214,14 +274,20 @@ namespace rdk {
         imageInfo.format = depthFormat;
         imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
         imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        // sampled by Hi-Z pyramid build of occlusion culling, otherwise it's discarded after the pass
+        if (!m_DepthStored) {
+            imageInfo.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        } else if (m_Device->isFormatSupported(depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT)) {
+            imageInfo.usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+        }
         imageInfo.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
 
         ImageViewInfo imageViewInfo;
         imageViewInfo.format = depthFormat;
         imageViewInfo.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
 
-        new (m_DepthImage) Image(device, physicalDevice, imageInfo);
-        new (m_DepthImageView) ImageView(device, m_DepthImage->getHandle(), imageViewInfo);
+        *m_DepthImage = Image(device, physicalDevice, imageInfo);
+        *m_DepthImageView = ImageView(device, m_DepthImage->getHandle(), imageViewInfo);
     }
 
 }
\ No newline at end of file
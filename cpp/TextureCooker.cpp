@@ -0,0 +1,161 @@
+#include <TextureCooker.h>
+
+#include <stb_image.h>
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace rdk {
+
+    static float srgbToLinear(float value) {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    static float linearToSrgb(float value) {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    struct SrgbTable final {
+        float values[256];
+
+        SrgbTable() {
+            for (int i = 0 ; i < 256 ; i++) {
+                values[i] = srgbToLinear(float(i) / 255.0f);
+            }
+        }
+    };
+
+    std::vector<u8> TextureCooker::downsample(const u8* rgba, u32 width, u32 height, bool srgb) {
+        static const SrgbTable table;
+        const float* srgbTable = table.values;
+
+        u32 dstWidth = std::max(width / 2, 1u);
+        u32 dstHeight = std::max(height / 2, 1u);
+        std::vector<u8> result(size_t(dstWidth) * dstHeight * 4);
+
+        for (u32 y = 0 ; y < dstHeight ; y++) {
+            u32 y0 = std::min(y * 2, height - 1);
+            u32 y1 = std::min(y * 2 + 1, height - 1);
+            for (u32 x = 0 ; x < dstWidth ; x++) {
+                u32 x0 = std::min(x * 2, width - 1);
+                u32 x1 = std::min(x * 2 + 1, width - 1);
+                const u8* texels[4] = {
+                        &rgba[(size_t(y0) * width + x0) * 4],
+                        &rgba[(size_t(y0) * width + x1) * 4],
+                        &rgba[(size_t(y1) * width + x0) * 4],
+                        &rgba[(size_t(y1) * width + x1) * 4]
+                };
+
+                u8* dst = &result[(size_t(y) * dstWidth + x) * 4];
+                for (u32 c = 0 ; c < 4 ; c++) {
+                    bool linearize = srgb && c < 3;
+                    float sum = 0;
+                    for (const u8* texel : texels) {
+                        sum += linearize ? srgbTable[texel[c]] : float(texel[c]) / 255.0f;
+                    }
+                    float value = sum * 0.25f;
+                    if (linearize)
+                        value = linearToSrgb(value);
+                    dst[c] = static_cast<u8>(std::min(255.0f, std::max(0.0f, value * 255.0f + 0.5f)));
+                }
+            }
+        }
+
+        return result;
+    }
+
+    KtxTexture TextureCooker::cook(
+            const u8* rgba, u32 width, u32 height,
+            const CookSettings& settings,
+            ThreadPool* threadPool
+    ) {
+        KtxTexture texture;
+        texture.format = BlockCompressor::toVkFormat(settings.format, settings.srgb);
+        texture.width = width;
+        texture.height = height;
+
+        u32 mipLevels = settings.mipmaps ? static_cast<u32>(std::floor(std::log2(std::max(width, height)))) + 1 : 1;
+
+        std::vector<u8> level(rgba, rgba + size_t(width) * height * 4);
+        u32 levelWidth = width;
+        u32 levelHeight = height;
+
+        for (u32 i = 0 ; i < mipLevels ; i++) {
+            KtxLevel ktxLevel;
+            ktxLevel.offset = texture.data.size();
+            ktxLevel.size = BlockCompressor::compressedSize(levelWidth, levelHeight, settings.format);
+            ktxLevel.width = levelWidth;
+            ktxLevel.height = levelHeight;
+            texture.levels.push_back(ktxLevel);
+
+            texture.data.resize(ktxLevel.offset + ktxLevel.size);
+            BlockCompressor::compress(
+                    level.data(), levelWidth, levelHeight,
+                    settings.format, texture.data.data() + ktxLevel.offset,
+                    threadPool
+            );
+
+            if (i + 1 < mipLevels) {
+                level = downsample(level.data(), levelWidth, levelHeight, settings.srgb);
+                levelWidth = std::max(levelWidth / 2, 1u);
+                levelHeight = std::max(levelHeight / 2, 1u);
+            }
+        }
+
+        return texture;
+    }
+
+    KtxTexture TextureCooker::mipChain(const u8* rgba, u32 width, u32 height, bool srgb) {
+        KtxTexture texture;
+        texture.format = srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+        texture.width = width;
+        texture.height = height;
+
+        u32 mipLevels = static_cast<u32>(std::floor(std::log2(std::max(width, height)))) + 1;
+
+        std::vector<u8> level(rgba, rgba + size_t(width) * height * 4);
+        u32 levelWidth = width;
+        u32 levelHeight = height;
+
+        for (u32 i = 0 ; i < mipLevels ; i++) {
+            KtxLevel ktxLevel;
+            ktxLevel.offset = texture.data.size();
+            ktxLevel.size = level.size();
+            ktxLevel.width = levelWidth;
+            ktxLevel.height = levelHeight;
+            texture.levels.push_back(ktxLevel);
+
+            // RGBA8 levels are always 4 byte aligned, keep 16 to match KtxFile::parse layout
+            texture.data.resize((ktxLevel.offset + ktxLevel.size + 15) & ~u64(15));
+            memcpy(texture.data.data() + ktxLevel.offset, level.data(), level.size());
+
+            if (i + 1 < mipLevels) {
+                level = downsample(level.data(), levelWidth, levelHeight, srgb);
+                levelWidth = std::max(levelWidth / 2, 1u);
+                levelHeight = std::max(levelHeight / 2, 1u);
+            }
+        }
+
+        return texture;
+    }
+
+    void TextureCooker::cook(
+            const char* srcFilepath, const char* dstFilepath,
+            const CookSettings& settings,
+            ThreadPool* threadPool
+    ) {
+        int width, height, channels;
+        stbi_uc* pixels = stbi_load(srcFilepath, &width, &height, &channels, STBI_rgb_alpha);
+        if (!pixels) {
+            throw std::runtime_error("TextureCooker::cook: failed to load source image!");
+        }
+
+        KtxTexture texture = cook(pixels, static_cast<u32>(width), static_cast<u32>(height), settings, threadPool);
+        stbi_image_free(pixels);
+
+        KtxFile::save(dstFilepath, texture);
+    }
+
+}
@@ -0,0 +1,478 @@
+#include <TextureStreamer.h>
+#include <TextureCooker.h>
+#include <CommandPool.h>
+
+#include <stb_image.h>
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+namespace rdk {
+
+    static VkDeviceSize alignStage(VkDeviceSize size) {
+        // satisfies copy offset alignment of RGBA8 and BC block formats
+        return (size + 15) & ~VkDeviceSize(15);
+    }
+
+    void TextureStreamer::create(Device* device, Queue* queue, Timeline* timeline, u32 framesInFlight, const StreamingSettings& settings) {
+        m_Device = device;
+        m_Queue = queue;
+        m_Timeline = timeline;
+        m_Settings = settings;
+        m_Settings.tailLevels = std::max(m_Settings.tailLevels, 1u);
+
+        VkDevice logicalDevice = m_Device->getLogicalHandle();
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = m_Queue->getFamilyIndices().graphicsFamily;
+        auto poolStatus = vkCreateCommandPool(logicalDevice, &poolInfo, nullptr, &m_CommandPool);
+        rect_assert(poolStatus == VK_SUCCESS, "Failed to create Vulkan streaming command pool")
+
+        m_Frames.resize(framesInFlight);
+        for (auto& frame : m_Frames) {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = m_CommandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            auto bufferStatus = vkAllocateCommandBuffers(logicalDevice, &allocInfo, &frame.commandBuffer);
+            rect_assert(bufferStatus == VK_SUCCESS, "Failed to allocate Vulkan streaming command buffer")
+        }
+
+        m_DeletionQueue.create(logicalDevice);
+    }
+
+    void TextureStreamer::destroy() {
+        VkDevice logicalDevice = m_Device->getLogicalHandle();
+
+        for (auto& frame : m_Frames) {
+            m_Timeline->wait(frame.value);
+            if (frame.stageCapacity > 0) {
+                frame.stageBuffer.unmapMemory();
+                frame.stageBuffer.destroy();
+            }
+        }
+        m_Frames.clear();
+        m_DeletionQueue.destroy();
+
+        m_Textures.clear();
+        m_Samplers.clear();
+        m_AllocatedBytes = 0;
+
+        vkDestroyCommandPool(logicalDevice, m_CommandPool, nullptr);
+    }
+
+    StreamedTextureId TextureStreamer::createTexture2D(const char* filepath, const AssetPack* assetPack) {
+        AssetBlob blob = AssetPack::loadAsset(filepath, assetPack);
+        return addTexture2D(decodeTexture2D(filepath, blob.data(), blob.size()));
+    }
+
+    KtxTexture TextureStreamer::decodeTexture2D(const char* filepath, const u8* data, size_t size) {
+        if (KtxFile::hasKtx2Extension(filepath)) {
+            return KtxFile::parse(data, size);
+        }
+
+        int width, height, channels;
+        stbi_uc* pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, STBI_rgb_alpha);
+        if (!pixels) {
+            throw std::runtime_error("TextureStreamer::createTexture2D: failed to load texture image!");
+        }
+        KtxTexture source = TextureCooker::mipChain(pixels, static_cast<u32>(width), static_cast<u32>(height));
+        stbi_image_free(pixels);
+        return source;
+    }
+
+    StreamedTextureId TextureStreamer::addTexture2D(KtxTexture&& source) {
+        checkFormat(source.format);
+
+        StreamedTexture texture;
+        texture.lastRequestFrame = m_Frame;
+        m_Textures.emplace_back(std::move(texture));
+
+        StreamedTextureId id = static_cast<StreamedTextureId>(m_Textures.size() - 1);
+        replaceTexture2D(id, std::move(source));
+        return id;
+    }
+
+    void TextureStreamer::replaceTexture2D(StreamedTextureId id, KtxTexture&& source) {
+        checkFormat(source.format);
+
+        StreamedTexture& texture = m_Textures[id];
+        // contents changed, so nothing is carried over from old image
+        if (texture.image) {
+            retire(texture);
+        }
+
+        texture.source = std::move(source);
+        u32 levels = static_cast<u32>(texture.source.levels.size());
+        u32 tailLevel = levels - std::min(m_Settings.tailLevels, levels);
+        texture.residentLevel = levels;
+        texture.requestedLevel = std::min(texture.requestedLevel, levels - 1);
+
+        // only the mip tail is allocated and uploaded now, everything above streams in with update()
+        reallocate(texture, tailLevel);
+        uploadLevels(texture, tailLevel, levels);
+    }
+
+    void TextureStreamer::checkFormat(VkFormat format) const {
+        if (!m_Device->isFormatSupported(format, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT)) {
+            throw std::runtime_error("TextureStreamer::createTexture2D: texture format is not supported by device!");
+        }
+    }
+
+    void TextureStreamer::request(StreamedTextureId id, u32 mipLevel) {
+        StreamedTexture& texture = m_Textures[id];
+        texture.requestedLevel = std::min(mipLevel, static_cast<u32>(texture.source.levels.size()) - 1);
+        texture.lastRequestFrame = m_Frame;
+    }
+
+    VkSampler TextureStreamer::getSampler(StreamedTextureId id) {
+        const StreamedTexture& texture = m_Textures[id];
+        return getClampSampler(texture.residentLevel - texture.allocatedLevel);
+    }
+
+    VkSampler TextureStreamer::getClampSampler(u32 minLod) {
+        if (minLod >= m_Samplers.size()) {
+            m_Samplers.resize(minLod + 1);
+        }
+
+        auto& sampler = m_Samplers[minLod];
+        if (!sampler) {
+            ImageSamplerInfo samplerInfo;
+            samplerInfo.minLod = static_cast<float>(minLod);
+            samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+            sampler = std::make_unique<ImageSampler>(*m_Device, samplerInfo);
+        }
+
+        return sampler->getHandle();
+    }
+
+    void TextureStreamer::update() {
+        evict();
+        stream();
+
+        StreamingFrame& frame = m_Frames[m_Frame % m_Frames.size()];
+        if (frame.recording) {
+            auto endStatus = vkEndCommandBuffer(frame.commandBuffer);
+            rect_assert(endStatus == VK_SUCCESS, "Failed to record Vulkan streaming command buffer")
+
+            VkSubmitInfo submitInfo{};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &frame.commandBuffer;
+
+            // same queue as frame rendering, barriers recorded here order uploads before sampling
+            frame.value = m_Timeline->submit(m_Queue->getGraphicsHandle(), submitInfo);
+            m_DeletionQueue.submit(frame.value);
+            frame.recording = false;
+        }
+        frame.acquired = false;
+
+        m_Frame++;
+    }
+
+    StreamingFrame& TextureStreamer::beginCommands() {
+        u32 frameIndex = static_cast<u32>(m_Frame % m_Frames.size());
+        StreamingFrame& frame = m_Frames[frameIndex];
+
+        if (!frame.acquired) {
+            m_Timeline->wait(frame.value);
+            m_DeletionQueue.collect(m_Timeline->poll());
+            frame.stageOffset = 0;
+            frame.acquired = true;
+        }
+
+        if (!frame.recording) {
+            vkResetCommandBuffer(frame.commandBuffer, 0);
+
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            auto beginStatus = vkBeginCommandBuffer(frame.commandBuffer, &beginInfo);
+            rect_assert(beginStatus == VK_SUCCESS, "Failed to begin Vulkan streaming command buffer")
+            frame.recording = true;
+        }
+
+        return frame;
+    }
+
+    u8* TextureStreamer::allocateStage(VkDeviceSize size, VkDeviceSize* offset) {
+        StreamingFrame& frame = beginCommands();
+        VkDeviceSize stageOffset = alignStage(frame.stageOffset);
+
+        if (stageOffset + size > frame.stageCapacity) {
+            // grow stage buffer, the old one may still be referenced by commands recorded in this frame
+            if (frame.stageCapacity > 0) {
+                frame.stageBuffer.unmapMemory();
+                m_DeletionQueue.release(frame.stageBuffer);
+            }
+            frame.stageCapacity = std::max(std::max(m_Settings.uploadBudget, size), frame.stageCapacity * 2);
+            frame.stageBuffer.create(
+                    frame.stageCapacity,
+                    m_Device->getLogicalHandle(), m_Device->getPhysicalHandle(),
+                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+            );
+            frame.stageMemory = static_cast<u8*>(frame.stageBuffer.mapMemory(frame.stageCapacity));
+            stageOffset = 0;
+        }
+
+        frame.stageOffset = stageOffset + size;
+        *offset = stageOffset;
+        return frame.stageMemory + stageOffset;
+    }
+
+    void TextureStreamer::reallocate(StreamedTexture& texture, u32 level) {
+        StreamingFrame& frame = beginCommands();
+        VkCommandBuffer commandBuffer = frame.commandBuffer;
+        const KtxTexture& source = texture.source;
+        u32 levels = static_cast<u32>(source.levels.size());
+
+        ImageInfo imageInfo;
+        imageInfo.width = source.levels[level].width;
+        imageInfo.height = source.levels[level].height;
+        imageInfo.format = source.format;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        imageInfo.mipLevels = levels - level;
+        auto image = std::make_unique<Image>(m_Device->getLogicalHandle(), m_Device->getPhysicalHandle(), imageInfo);
+        VkImage newImage = image->getHandle();
+
+        CommandPool::cmdImageBarrier(
+                commandBuffer, newImage,
+                0, imageInfo.mipLevels,
+                VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT
+        );
+
+        // carry over uploaded levels which are still allocated, GPU to GPU without touching stage memory
+        u32 firstKept = std::max(level, texture.residentLevel);
+        if (texture.image && firstKept < levels) {
+            VkImage oldImage = texture.image->getHandle();
+            u32 oldBase = firstKept - texture.allocatedLevel;
+            u32 keptLevels = levels - firstKept;
+
+            CommandPool::cmdImageBarrier(
+                    commandBuffer, oldImage,
+                    oldBase, keptLevels,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT
+            );
+
+            std::vector<VkImageCopy> regions(keptLevels);
+            for (u32 i = 0 ; i < keptLevels ; i++) {
+                const KtxLevel& sourceLevel = source.levels[firstKept + i];
+                VkImageCopy& region = regions[i];
+                region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                region.srcSubresource.mipLevel = oldBase + i;
+                region.srcSubresource.baseArrayLayer = 0;
+                region.srcSubresource.layerCount = 1;
+                region.srcOffset = { 0, 0, 0 };
+                region.dstSubresource = region.srcSubresource;
+                region.dstSubresource.mipLevel = firstKept - level + i;
+                region.dstOffset = { 0, 0, 0 };
+                region.extent = { sourceLevel.width, sourceLevel.height, 1 };
+            }
+
+            vkCmdCopyImage(
+                    commandBuffer,
+                    oldImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    newImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    static_cast<u32>(regions.size()), regions.data()
+            );
+        }
+
+        // levels without data are transitioned as well, they are never sampled because of sampler minLod
+        CommandPool::cmdImageBarrier(
+                commandBuffer, newImage,
+                0, imageInfo.mipLevels,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT
+        );
+
+        ImageViewInfo viewInfo;
+        viewInfo.format = source.format;
+        viewInfo.mipLevels = imageInfo.mipLevels;
+        auto view = std::make_unique<ImageView>(m_Device->getLogicalHandle(), newImage, viewInfo);
+
+        if (texture.image) {
+            retire(texture);
+        }
+
+        texture.image = std::move(image);
+        texture.view = std::move(view);
+        texture.allocatedLevel = level;
+        texture.residentLevel = std::max(texture.residentLevel, level);
+        texture.version++;
+        m_AllocatedBytes += levelBytes(texture, level);
+    }
+
+    void TextureStreamer::retire(StreamedTexture& texture) {
+        m_AllocatedBytes -= levelBytes(texture, texture.allocatedLevel);
+        m_DeletionQueue.release(std::move(*texture.view));
+        m_DeletionQueue.release(std::move(*texture.image));
+        texture.view.reset();
+        texture.image.reset();
+    }
+
+    void TextureStreamer::uploadLevels(StreamedTexture& texture, u32 firstLevel, u32 lastLevel) {
+        if (firstLevel >= lastLevel)
+            return;
+
+        const KtxTexture& source = texture.source;
+
+        VkDeviceSize size = 0;
+        for (u32 i = firstLevel ; i < lastLevel ; i++) {
+            size += alignStage(source.levels[i].size);
+        }
+
+        VkDeviceSize stageOffset;
+        u8* stage = allocateStage(size, &stageOffset);
+        StreamingFrame& frame = beginCommands();
+        VkCommandBuffer commandBuffer = frame.commandBuffer;
+        VkImage image = texture.image->getHandle();
+        u32 baseLevel = firstLevel - texture.allocatedLevel;
+
+        std::vector<VkBufferImageCopy> regions(lastLevel - firstLevel);
+        VkDeviceSize offset = 0;
+        for (u32 i = firstLevel ; i < lastLevel ; i++) {
+            const KtxLevel& level = source.levels[i];
+            memcpy(stage + offset, source.data.data() + level.offset, level.size);
+
+            VkBufferImageCopy& region = regions[i - firstLevel];
+            region.bufferOffset = stageOffset + offset;
+            region.bufferRowLength = 0;
+            region.bufferImageHeight = 0;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = i - texture.allocatedLevel;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = { 0, 0, 0 };
+            region.imageExtent = { level.width, level.height, 1 };
+
+            offset += alignStage(level.size);
+        }
+
+        CommandPool::cmdImageBarrier(
+                commandBuffer, image,
+                baseLevel, lastLevel - firstLevel,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT
+        );
+
+        CommandPool::cmdCopyBufferImage(commandBuffer, frame.stageBuffer.getHandle(), image, regions);
+
+        CommandPool::cmdImageBarrier(
+                commandBuffer, image,
+                baseLevel, lastLevel - firstLevel,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT
+        );
+
+        texture.residentLevel = std::min(texture.residentLevel, firstLevel);
+        texture.version++;
+    }
+
+    static u32 tailLevelOf(const StreamedTexture& texture, u32 tailLevels) {
+        u32 levels = static_cast<u32>(texture.source.levels.size());
+        return levels - std::min(tailLevels, levels);
+    }
+
+    static bool isStale(const StreamedTexture& texture, u64 frame, u32 evictionDelay) {
+        return frame - texture.lastRequestFrame > evictionDelay;
+    }
+
+    void TextureStreamer::evict() {
+        if (m_Settings.memoryBudget == 0)
+            return;
+
+        while (m_AllocatedBytes > m_Settings.memoryBudget) {
+            // least recently requested texture which holds levels nobody asks for
+            StreamedTexture* victim = nullptr;
+            u32 victimLevel = 0;
+            for (auto& texture : m_Textures) {
+                u32 tailLevel = tailLevelOf(texture, m_Settings.tailLevels);
+                u32 unusedLevel = isStale(texture, m_Frame, m_Settings.evictionDelay)
+                        ? tailLevel
+                        : std::min(texture.requestedLevel, tailLevel);
+                if (texture.allocatedLevel >= unusedLevel)
+                    continue;
+
+                if (!victim || texture.lastRequestFrame < victim->lastRequestFrame) {
+                    victim = &texture;
+                    victimLevel = unusedLevel;
+                }
+            }
+
+            if (!victim)
+                break;
+
+            reallocate(*victim, victimLevel);
+        }
+    }
+
+    void TextureStreamer::stream() {
+        struct Candidate final {
+            StreamedTexture* texture;
+            u32 targetLevel;
+        };
+
+        std::vector<Candidate> candidates;
+        for (auto& texture : m_Textures) {
+            u32 targetLevel = texture.requestedLevel;
+            // under memory pressure stale textures only fill what they have, otherwise they would bounce with evict()
+            if (m_Settings.memoryBudget != 0 && isStale(texture, m_Frame, m_Settings.evictionDelay)) {
+                targetLevel = std::max(targetLevel, texture.allocatedLevel);
+            }
+            if (texture.residentLevel > targetLevel) {
+                candidates.push_back({ &texture, targetLevel });
+            }
+        }
+
+        // blurriest first, recently requested ones break ties
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate& left, const Candidate& right) {
+            if (left.texture->residentLevel != right.texture->residentLevel)
+                return left.texture->residentLevel > right.texture->residentLevel;
+            return left.texture->lastRequestFrame > right.texture->lastRequestFrame;
+        });
+
+        VkDeviceSize uploaded = 0;
+        for (const Candidate& candidate : candidates) {
+            StreamedTexture& texture = *candidate.texture;
+
+            if (texture.residentLevel == texture.allocatedLevel) {
+                VkDeviceSize growth = levelBytes(texture, candidate.targetLevel) - levelBytes(texture, texture.allocatedLevel);
+                if (m_Settings.memoryBudget != 0 && m_AllocatedBytes + growth > m_Settings.memoryBudget)
+                    continue;
+                reallocate(texture, candidate.targetLevel);
+            }
+
+            // one level per texture per frame, so every texture sharpens at the same pace
+            u32 level = texture.residentLevel - 1;
+            VkDeviceSize size = texture.source.levels[level].size;
+            if (uploaded > 0 && uploaded + size > m_Settings.uploadBudget)
+                continue;
+
+            uploadLevels(texture, level, level + 1);
+            uploaded += size;
+        }
+    }
+
+    VkDeviceSize TextureStreamer::levelBytes(const StreamedTexture& texture, u32 firstLevel) {
+        VkDeviceSize size = 0;
+        for (size_t i = firstLevel ; i < texture.source.levels.size() ; i++) {
+            size += texture.source.levels[i].size;
+        }
+        return size;
+    }
+
+}
@@ -0,0 +1,111 @@
+#include <ThreadPool.h>
+
+#include <atomic>
+#include <algorithm>
+
+namespace rdk {
+
+    ThreadPool::ThreadPool(u32 threadCount) {
+        if (threadCount == 0)
+            threadCount = 1;
+
+        m_Threads.reserve(threadCount);
+        for (u32 i = 0 ; i < threadCount ; i++) {
+            m_Threads.emplace_back(&ThreadPool::run, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Running = false;
+        }
+        m_Condition.notify_all();
+
+        for (auto& thread : m_Threads) {
+            thread.join();
+        }
+        m_Threads.clear();
+    }
+
+    void ThreadPool::enqueue(std::function<void()>&& task) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Tasks.emplace(std::move(task));
+        }
+        m_Condition.notify_one();
+    }
+
+    void ThreadPool::run() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Condition.wait(lock, [this]() { return !m_Running || !m_Tasks.empty(); });
+                // drain remaining tasks before shutdown
+                if (!m_Running && m_Tasks.empty())
+                    return;
+
+                task = std::move(m_Tasks.front());
+                m_Tasks.pop();
+            }
+            task();
+        }
+    }
+
+    struct ParallelForState final {
+        std::atomic<size_t> next { 0 };
+        std::atomic<size_t> done { 0 };
+        size_t chunkCount = 0;
+        size_t count = 0;
+        size_t grainSize = 1;
+        std::function<void(size_t, size_t)> body;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+
+    static void runChunks(const std::shared_ptr<ParallelForState>& state) {
+        size_t chunk;
+        while ((chunk = state->next.fetch_add(1)) < state->chunkCount) {
+            size_t begin = chunk * state->grainSize;
+            size_t end = std::min(begin + state->grainSize, state->count);
+            state->body(begin, end);
+
+            if (state->done.fetch_add(1) + 1 == state->chunkCount) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finished.notify_all();
+            }
+        }
+    }
+
+    void ThreadPool::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body) {
+        if (count == 0)
+            return;
+
+        if (grainSize == 0)
+            grainSize = 1;
+
+        size_t chunkCount = (count + grainSize - 1) / grainSize;
+        if (chunkCount == 1) {
+            body(0, count);
+            return;
+        }
+
+        auto state = std::make_shared<ParallelForState>();
+        state->chunkCount = chunkCount;
+        state->count = count;
+        state->grainSize = grainSize;
+        state->body = body;
+
+        size_t helpers = std::min(chunkCount - 1, m_Threads.size());
+        for (size_t i = 0 ; i < helpers ; i++) {
+            enqueue([state]() { runChunks(state); });
+        }
+        // calling thread participates, so progress never depends on free workers
+        runChunks(state);
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&state]() { return state->done.load() == state->chunkCount; });
+    }
+
+}
@@ -0,0 +1,86 @@
+#include <Timeline.h>
+
+#include <vector>
+
+namespace rdk {
+
+    void Timeline::create(VkDevice device) {
+        m_Device = device;
+        m_Submitted = 0;
+        m_Completed = 0;
+
+        VkSemaphoreTypeCreateInfo typeInfo{};
+        typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &typeInfo;
+
+        auto status = vkCreateSemaphore(device, &semaphoreInfo, nullptr, &m_Handle);
+        rect_assert(status == VK_SUCCESS, "Failed to create Vulkan timeline semaphore")
+    }
+
+    void Timeline::destroy() {
+        vkDestroySemaphore(m_Device, m_Handle, nullptr);
+        m_Handle = VK_NULL_HANDLE;
+    }
+
+    u64 Timeline::submit(VkQueue queue, const VkSubmitInfo& submitInfo, VkFence fence) {
+        u64 value = m_Submitted + 1;
+
+        // values of binary semaphores are ignored, but arrays must cover all of them
+        std::vector<VkSemaphore> signalSemaphores(
+                submitInfo.pSignalSemaphores,
+                submitInfo.pSignalSemaphores + submitInfo.signalSemaphoreCount
+        );
+        signalSemaphores.emplace_back(m_Handle);
+        std::vector<u64> signalValues(signalSemaphores.size(), 0);
+        signalValues.back() = value;
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.signalSemaphoreValueCount = static_cast<u32>(signalValues.size());
+        timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+        VkSubmitInfo timelineSubmitInfo = submitInfo;
+        timelineSubmitInfo.pNext = &timelineInfo;
+        timelineSubmitInfo.signalSemaphoreCount = static_cast<u32>(signalSemaphores.size());
+        timelineSubmitInfo.pSignalSemaphores = signalSemaphores.data();
+
+        auto status = vkQueueSubmit(queue, 1, &timelineSubmitInfo, fence);
+        rect_assert(status == VK_SUCCESS, "Failed to submit Vulkan queue")
+
+        m_Submitted = value;
+        return value;
+    }
+
+    u64 Timeline::poll() {
+        u64 value;
+        if (vkGetSemaphoreCounterValue(m_Device, m_Handle, &value) == VK_SUCCESS) {
+            m_Completed = value;
+        }
+        return m_Completed;
+    }
+
+    bool Timeline::isComplete(u64 value) {
+        return value <= m_Completed || value <= poll();
+    }
+
+    void Timeline::wait(u64 value) {
+        if (value <= m_Completed)
+            return;
+
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_Handle;
+        waitInfo.pValues = &value;
+        auto status = vkWaitSemaphores(m_Device, &waitInfo, UINT64_MAX);
+        rect_assert(status == VK_SUCCESS, "Failed to wait for Vulkan timeline semaphore")
+
+        m_Completed = value;
+    }
+
+}
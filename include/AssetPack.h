@@ -0,0 +1,198 @@
+#pragma once
+
+#include <ThreadPool.h>
+
+#include <vector>
+#include <string>
+#include <mutex>
+
+namespace rdk {
+
+    enum class PackCompression : u32 {
+        NONE = 0,
+        // entry is split into chunks of PackHeader::chunkSize raw bytes, each LZ4 block decodes independently
+        LZ4 = 1
+    };
+
+    // on disk layout: header, entries, chunks, hash slots, names, then entry data aligned to PackHeader::alignment
+    struct PackHeader final {
+        u8 magic[4];
+        u32 version;
+        u32 entryCount;
+        // power of two, open addressing table of entry indices
+        u32 slotCount;
+        u64 entriesOffset;
+        u64 slotsOffset;
+        u64 namesOffset;
+        u64 namesSize;
+        u64 dataOffset;
+        u32 alignment;
+        u32 chunkSize;
+        u64 chunksOffset;
+        u32 chunkCount;
+        u32 reserved;
+    };
+
+    struct PackChunk final {
+        // relative to PackEntry::offset
+        u64 offset;
+        u32 size;
+        // chunks which don't shrink are stored raw inside compressed entry
+        u32 compression;
+    };
+
+    struct PackEntry final {
+        u64 hash;
+        // absolute file offset of stored bytes
+        u64 offset;
+        u64 size;
+        u64 rawSize;
+        u32 nameOffset;
+        u32 nameSize;
+        u32 compression;
+        u32 firstChunk;
+        u32 chunkCount;
+        u32 reserved;
+    };
+
+    // asset type is the name extension, seconds are spent decompressing (loading) or compressing (packing)
+    struct AssetTypeStats final {
+        std::string type;
+        u32 count = 0;
+        u64 storedBytes = 0;
+        u64 rawBytes = 0;
+        double seconds = 0;
+    };
+
+    // bytes of an asset: points straight into mapped pack when stored uncompressed, owns a copy otherwise
+    class AssetBlob final {
+
+    public:
+        AssetBlob() = default;
+        AssetBlob(const u8* data, size_t size) : m_Data(data), m_Size(size) {}
+        explicit AssetBlob(std::vector<u8>&& storage) : m_Storage(std::move(storage)) {
+            m_Size = m_Storage.size();
+        }
+
+    public:
+        [[nodiscard]] inline const u8* data() const { return m_Storage.empty() ? m_Data : m_Storage.data(); }
+        [[nodiscard]] inline size_t size() const { return m_Size; }
+        [[nodiscard]] inline bool isMapped() const { return m_Storage.empty() && m_Data != nullptr; }
+
+    private:
+        const u8* m_Data = nullptr;
+        size_t m_Size = 0;
+        std::vector<u8> m_Storage;
+    };
+
+    class MappedFile final {
+
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+    public:
+        bool open(const char* filepath);
+        void close();
+
+        [[nodiscard]] inline const u8* getData() const { return m_Data; }
+        [[nodiscard]] inline size_t getSize() const { return m_Size; }
+        [[nodiscard]] inline bool isOpen() const { return m_Data != nullptr; }
+
+    private:
+        const u8* m_Data = nullptr;
+        size_t m_Size = 0;
+#ifdef _WIN32
+        void* m_File = nullptr;
+        void* m_Mapping = nullptr;
+#endif
+    };
+
+    // read only archive mapped once, lookups go through hashed table of contents without any file opens
+    class AssetPack final {
+
+    public:
+        static const u32 VERSION = 2;
+        // matches LZ4 window, so chunking costs little ratio while giving enough chunks to spread across workers
+        static const u32 DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+        void open(const char* filepath);
+        void close();
+
+        [[nodiscard]] inline bool isOpen() const { return m_File.isOpen(); }
+        [[nodiscard]] inline u32 getEntryCount() const { return m_Header ? m_Header->entryCount : 0; }
+        [[nodiscard]] inline const PackEntry& getEntry(u32 index) const { return m_Entries[index]; }
+
+        // names are relative asset paths with forward slashes, e.g. "shaders/shader.vert"
+        [[nodiscard]] const PackEntry* find(const char* name) const;
+        [[nodiscard]] inline bool contains(const char* name) const { return find(name) != nullptr; }
+        [[nodiscard]] std::string getName(const PackEntry& entry) const;
+
+        // stored bytes, zero copy view into mapping
+        [[nodiscard]] const u8* getStored(const PackEntry& entry) const;
+
+        // zero copy for uncompressed entries, decompressed copy otherwise
+        [[nodiscard]] AssetBlob load(const PackEntry& entry, ThreadPool* threadPool = nullptr) const;
+        // writes entry.rawSize bytes into dst, e.g. mapped stage memory.
+        // Chunks are decoded on workers of threadPool when it's given, safe to call from inside a worker.
+        void read(const PackEntry& entry, void* dst, ThreadPool* threadPool = nullptr) const;
+        // first min(size, entry.rawSize) bytes, decodes only the chunks covering them
+        [[nodiscard]] std::vector<u8> readHead(const PackEntry& entry, size_t size) const;
+
+        // takes asset from pack when it's open and has it, otherwise reads loose file from disk
+        static AssetBlob loadAsset(const char* filepath, const AssetPack* assetPack = nullptr, ThreadPool* threadPool = nullptr);
+
+        static u64 hashName(const char* name, size_t size);
+        static std::string getType(const std::string& name);
+
+        // loads since open(), sorted by type
+        [[nodiscard]] std::vector<AssetTypeStats> getStats() const;
+        static void logStats(const char* title, const std::vector<AssetTypeStats>& stats);
+
+    private:
+        void record(const PackEntry& entry, double seconds) const;
+
+    private:
+        MappedFile m_File;
+        const PackHeader* m_Header = nullptr;
+        const PackEntry* m_Entries = nullptr;
+        const PackChunk* m_Chunks = nullptr;
+        const u32* m_Slots = nullptr;
+        const char* m_Names = nullptr;
+        mutable std::mutex m_StatsMutex;
+        mutable std::vector<AssetTypeStats> m_Stats;
+    };
+
+    class AssetPackWriter final {
+
+    public:
+        explicit AssetPackWriter(u32 chunkSize = AssetPack::DEFAULT_CHUNK_SIZE) : m_ChunkSize(chunkSize) {}
+
+    public:
+        void add(const std::string& name, const void* data, size_t size, PackCompression compression = PackCompression::NONE);
+        void addFile(const std::string& name, const char* filepath, PackCompression compression = PackCompression::NONE);
+
+        // alignment of entry data, use page size to let entries be mapped or read directly by DMA friendly I/O
+        void save(const char* filepath, u32 alignment = 16) const;
+
+        // entries added so far, sorted by type
+        [[nodiscard]] std::vector<AssetTypeStats> getStats() const;
+
+    private:
+        struct PendingEntry final {
+            std::string name;
+            std::vector<u8> data;
+            std::vector<PackChunk> chunks;
+            u64 rawSize;
+            PackCompression compression;
+            double seconds;
+        };
+
+        u32 m_ChunkSize;
+        std::vector<PendingEntry> m_Entries;
+    };
+
+}
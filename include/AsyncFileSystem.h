@@ -0,0 +1,75 @@
+#pragma once
+
+#include <ThreadPool.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+
+namespace rdk {
+
+    struct ReadRequest final {
+        std::string filepath;
+        u64 offset = 0;
+        // 0 reads until the end of file
+        u64 size = 0;
+        // caller provided buffer of at least size bytes, e.g. mapped stage memory.
+        // When null, file is read into ReadResult::data.
+        void* dst = nullptr;
+    };
+
+    struct ReadResult final {
+        std::string filepath;
+        bool success = false;
+        std::string error;
+        // bytes read, either into the caller buffer or into data
+        u64 size = 0;
+        std::vector<u8> data;
+    };
+
+    // runs on I/O thread (io_uring) or on a worker (fallback), must not block for long
+    typedef std::function<void(ReadResult&&)> ReadCallback;
+
+    struct PendingRead;
+    struct IoUring;
+
+    // asynchronous reads batched into as few kernel submissions as possible.
+    // Linux uses io_uring driven by a single I/O thread, other platforms
+    // and kernels without io_uring fall back to blocking reads on thread pool workers.
+    class AsyncFileSystem final {
+
+    public:
+        AsyncFileSystem();
+        ~AsyncFileSystem();
+
+    public:
+        void create(ThreadPool* threadPool, u32 queueDepth = 64);
+        // completes every queued read before returning
+        void destroy();
+
+        [[nodiscard]] inline bool isUring() const { return m_Uring != nullptr; }
+
+        void read(const ReadRequest& request, ReadCallback callback);
+        std::future<ReadResult> read(const ReadRequest& request);
+        // queued under one lock, so the I/O thread submits them together
+        std::vector<std::future<ReadResult>> readBatch(const std::vector<ReadRequest>& requests);
+
+        // blocking read on the calling thread, used by fallback path
+        static ReadResult readNow(const ReadRequest& request);
+
+    private:
+        void enqueue(std::vector<std::unique_ptr<PendingRead>>&& reads);
+        void run();
+
+    private:
+        ThreadPool* m_ThreadPool = nullptr;
+        std::unique_ptr<IoUring> m_Uring;
+        std::thread m_Thread;
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        std::deque<std::unique_ptr<PendingRead>> m_Queue;
+        bool m_Running = false;
+    };
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <ThreadPool.h>
+
+#include <vector>
+
+namespace rdk {
+
+    enum class BlockFormat : u8 {
+        BC1,    // RGB, 4 bits per texel
+        BC3,    // RGBA, 8 bits per texel
+        BC4,    // R, 4 bits per texel
+        BC5,    // RG, 8 bits per texel
+        BC7     // RGBA, 8 bits per texel, mode 6 only
+    };
+
+    class BlockCompressor final {
+
+    public:
+        static u32 blockSize(BlockFormat format);
+        static size_t compressedSize(u32 width, u32 height, BlockFormat format);
+        static VkFormat toVkFormat(BlockFormat format, bool srgb);
+
+        // compresses 4x4 blocks of tightly packed RGBA8 pixels, edges are padded by clamping.
+        // Rows of blocks are distributed on threadPool if provided.
+        static void compress(
+                const u8* rgba, u32 width, u32 height,
+                BlockFormat format, u8* dst,
+                ThreadPool* threadPool = nullptr
+        );
+
+        static void compressBlockBC1(const u8* block, u8* dst);
+        static void compressBlockBC3(const u8* block, u8* dst);
+        static void compressBlockBC4(const u8* block, u32 channel, u8* dst);
+        static void compressBlockBC5(const u8* block, u8* dst);
+        static void compressBlockBC7(const u8* block, u8* dst);
+    };
+
+}
@@ -15,7 +15,9 @@ namespace rdk {
                 VkDevice device,
                 VkPhysicalDevice physicalDevice,
                 VkBufferUsageFlags usage,
-                VkMemoryPropertyFlags props
+                VkMemoryPropertyFlags props,
+                // buffer is shared concurrently when it's used by more than one queue family
+                const std::vector<u32>& queueFamilies = {}
         );
         void destroy();
 
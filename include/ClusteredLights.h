@@ -0,0 +1,108 @@
+#pragma once
+
+#include <ComputePipeline.h>
+#include <DescriptorPool.h>
+#include <DeletionQueue.h>
+#include <Device.h>
+#include <AssetPack.h>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace rdk {
+
+    // point light in the space of model matrix output, std430 layout of shaders/cluster.comp and shaders/shader.frag
+    struct PointLight final {
+        // xyz - position, w - radius, light has no effect beyond it
+        glm::vec4 position = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        // rgb - color, w - intensity
+        glm::vec4 color = glm::vec4(1.0f);
+    };
+
+    // bins lights into view space froxel grid every frame with shaders/cluster.comp: screen tiles along x and y,
+    // slices with exponentially growing depth along z. Fragment shader loops only over lights of its cluster,
+    // so its cost depends on local light density instead of total light count.
+    // Camera is read from MVP uniform buffer of the frame slot when the dispatch executes,
+    // so matrices written during RenderListener::onRender() are used by the same frame.
+    class ClusteredLights final {
+
+    public:
+        static const u32 GRID_X = 16;
+        static const u32 GRID_Y = 9;
+        static const u32 GRID_Z = 24;
+        static const u32 CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+        // lights over these limits are dropped, from the whole scene and from single cluster respectively
+        static const u32 MAX_LIGHTS = 16384;
+        static const u32 MAX_CLUSTER_LIGHTS = 128;
+
+        // buffers are created even when shader fails, fragment shader then sees no lights
+        void create(Device* device, const AssetPack* assetPack, u32 framesInFlight, const char* shaderFilepath = "shaders/cluster.comp");
+        // device must be idle
+        void destroy();
+
+        [[nodiscard]] inline bool isActive() const { return m_Active; }
+        [[nodiscard]] inline const std::string& getShaderFilepath() const { return m_ShaderFilepath; }
+        [[nodiscard]] inline size_t getLightCount() const { return m_Lights.size(); }
+
+        // lights set up to RenderListener::onCompute() are shaded in the same frame
+        void setLights(const PointLight* lights, size_t count);
+        // unlit share of base color, 1 keeps scene unlit when there are no lights
+        inline void setAmbient(float ambient) { m_Ambient = ambient; }
+        // view space distances of camera clip planes, slices are spread between them.
+        // Passed explicitly, because depth convention of projection matrix is not known to shaders.
+        inline void setDepthRange(float zNear, float zFar) { m_ZNear = zNear; m_ZFar = zFar; }
+
+        // MVP uniform buffer of frame slot, read by clustering dispatch
+        void writeCameraBuffer(u32 frame, VkBuffer uniformBuffer, VkDeviceSize size);
+        // lights, clusters and parameters of frame slot into graphics set bindings [firstBinding, firstBinding + 3)
+        void writeDescriptors(VkDescriptorSet descriptorSet, u32 frame, u32 firstBinding);
+
+        // uploads lights of frame slot and bins them, outside of render pass.
+        // Extent is render area of scene pass, which fragment coordinates span.
+        void cmdBuild(VkCommandBuffer commandBuffer, u32 frame, const VkExtent2D& extent);
+
+        // after shader file changed, keeps previous pipeline on failure
+        void reload(DeletionQueue& deletionQueue);
+
+    private:
+        struct ClusterParams final {
+            u32 gridX;
+            u32 gridY;
+            u32 gridZ;
+            u32 lightCount;
+            float screenWidth;
+            float screenHeight;
+            float ambient;
+            u32 padding;
+            float zNear;
+            float zFar;
+            u32 depthPadding[2];
+        };
+
+        struct FrameResources final {
+            Buffer params;
+            void* paramsBlock = nullptr;
+            Buffer lights;
+            void* lightsBlock = nullptr;
+            // light counts of all clusters, followed by MAX_CLUSTER_LIGHTS light indices per cluster
+            Buffer clusters;
+            VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        };
+
+    private:
+        Device* m_Device = nullptr;
+        bool m_Created = false;
+        bool m_Active = false;
+        std::string m_ShaderFilepath;
+        ComputePipeline m_Pipeline;
+        DescriptorPool m_DescriptorPool;
+        std::vector<FrameResources> m_Frames;
+        std::vector<PointLight> m_Lights;
+        float m_Ambient = 1.0f;
+        float m_ZNear = 0.1f;
+        float m_ZFar = 10.0f;
+    };
+
+}
@@ -1,11 +1,17 @@
 #pragma once
 
 #include <Pipeline.h>
+#include <ComputePipeline.h>
 #include <Queues.h>
 #include <Device.h>
 #include <DescriptorPool.h>
+#include <DeletionQueue.h>
+#include <Timeline.h>
+#include <DynamicResolution.h>
 #include <Window.h>
 
+#include <chrono>
+
 #ifdef IMGUI
 #include <imgui.h>
 #include <imgui_internal.h>
@@ -45,6 +51,9 @@ namespace rdk {
 
     class CommandPool final {
 
+    public:
+        static constexpr std::chrono::milliseconds RESIZE_DEBOUNCE{100};
+
     public:
         CommandPool() = default;
         CommandPool(
@@ -63,14 +72,22 @@ namespace rdk {
             m_MaxFramesInFlight = maxFramesInFlight;
         }
 
+        // swap chain is recreated once window size hasn't changed for RESIZE_DEBOUNCE,
+        // so resize storms don't recreate it on every frame
         inline void setFrameBufferResized(bool resized) {
             m_FrameBufferResized = resized;
+            m_ResizeTime = std::chrono::steady_clock::now();
         }
 
         [[nodiscard]] inline VkCommandBuffer getCurrentBuffer() {
             return m_Buffers[m_CurrentFrame].getHandle();
         }
 
+        // async compute buffer between beginAsyncCompute() and submitAsyncCompute(), graphics buffer otherwise
+        [[nodiscard]] inline VkCommandBuffer getRecordingBuffer() {
+            return m_AsyncRecording ? m_ComputeBuffers[m_CurrentFrame].getHandle() : getCurrentBuffer();
+        }
+
         [[nodiscard]] inline u32 getMaxFramesInFlight() const {
             return m_MaxFramesInFlight;
         }
@@ -79,34 +96,113 @@ namespace rdk {
             return m_CurrentFrame;
         }
 
+        // resources released here are destroyed once frames in flight which may use them are done
+        inline DeletionQueue& getDeletionQueue() {
+            return m_DeletionQueue;
+        }
+
+        // signaled by every graphics queue submission, other systems submitting to it share the same timeline
+        inline Timeline& getTimeline() {
+            return m_Timeline;
+        }
+
+        [[nodiscard]] inline const DynamicResolution& getDynamicResolution() const {
+            return m_DynamicResolution;
+        }
+
+        // waits for device idle, as scene target is recreated
+        void setDynamicResolution(const DynamicResolutionSettings& settings);
+        // scene depth is stored and sampleable only when it's read after scene pass, e.g. by occlusion culling,
+        // otherwise depth attachments are transient. Waits for device idle, as depth images are recreated.
+        void setSceneDepthStored(bool stored);
+
         void create();
         void destroy();
 
-        void beginFrame();
+        // blocks until GPU has finished with resources of current frame slot, beginFrame() waits for it as well
+        void waitFrame();
+        // acquires swap chain image and begins command buffer, compute work is recorded before beginRenderPass().
+        // Returns false when swap chain is out of date or window is minimized, the frame is skipped then.
+        // Never blocks on window events or device idle.
+        bool beginFrame();
+        // work recorded in between runs on compute queue, graphics submission of the frame waits for it
+        void beginAsyncCompute();
+        void submitAsyncCompute();
+        // scene goes into offscreen target when dynamic resolution is active, it's upscaled in endFrame()
+        void beginRenderPass();
+        // ends scene pass mid-frame, so its depth can be read by compute work recorded in between,
+        // resumeRenderPass() continues it with the same attachments and rebinds default pipeline state
+        void suspendRenderPass();
+        void resumeRenderPass();
         void endFrame();
 
         void drawVertices(u32 vertexCount, u32 instanceCount);
-        void drawIndices(u32 indexCount, u32 instanceCount);
+        void drawIndices(u32 indexCount, u32 instanceCount, u32 firstIndex = 0);
+
+        // must be recorded outside of render pass
+        void dispatch(const ComputePipeline& pipeline, VkDescriptorSet descriptorSet, u32 groupCountX, u32 groupCountY = 1, u32 groupCountZ = 1);
+        void dispatchIndirect(const ComputePipeline& pipeline, VkDescriptorSet descriptorSet, VkBuffer buffer, VkDeviceSize offset = 0);
 
         void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
         void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, u32 mipLevels = 1);
         void copyBufferImage(VkBuffer srcBuffer, VkImage dstImage, u32 width, u32 height);
+        void copyBufferImage(VkBuffer srcBuffer, VkImage dstImage, const std::vector<VkBufferImageCopy>& regions);
         void CommandPool::generateMipmaps(VkImage image, int width, int height, u32 mipLevels);
 
+        // record into caller command buffer, so many uploads can share one submission
+        static void cmdTransitionImageLayout(
+                VkCommandBuffer commandBuffer,
+                VkImage image, VkFormat format,
+                VkImageLayout oldLayout, VkImageLayout newLayout,
+                u32 mipLevels = 1
+        );
+        static void cmdCopyBufferImage(
+                VkCommandBuffer commandBuffer,
+                VkBuffer srcBuffer, VkImage dstImage,
+                const std::vector<VkBufferImageCopy>& regions
+        );
+        static void cmdGenerateMipmaps(VkCommandBuffer commandBuffer, VkImage image, int width, int height, u32 mipLevels);
+        // image barrier over mip range [baseMipLevel, baseMipLevel + mipLevels)
+        static void cmdImageBarrier(
+                VkCommandBuffer commandBuffer, VkImage image,
+                u32 baseMipLevel, u32 mipLevels,
+                VkImageLayout oldLayout, VkImageLayout newLayout,
+                VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                VkPipelineStageFlags dstStage, VkAccessFlags dstAccess,
+                VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT
+        );
+
+        // global memory barrier, e.g. compute writes -> vertex input or indirect reads
+        static void cmdMemoryBarrier(
+                VkCommandBuffer commandBuffer,
+                VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                VkPipelineStageFlags dstStage, VkAccessFlags dstAccess
+        );
+        static void cmdBufferBarrier(
+                VkCommandBuffer commandBuffer,
+                VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+                VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                VkPipelineStageFlags dstStage, VkAccessFlags dstAccess
+        );
+
         VkCommandBuffer& beginTempCommand();
         void endTempCommand();
 
         void beginUI();
 
     private:
-        void createBuffers();
-        void destroyBuffers();
+        void createBuffers(VkCommandPool commandPool, std::vector<CommandBuffer>& buffers);
+        void destroyBuffers(VkCommandPool commandPool, std::vector<CommandBuffer>& buffers);
         void createSyncObjects();
         void destroySyncObjects();
 
+        // binds default pipeline, descriptor set and buffers and sets viewport of scene pass
+        void bindSceneState(VkCommandBuffer commandBuffer, const VkExtent2D& extent);
+
         void renderUIDrawData(ImDrawData* drawData = ImGui::GetDrawData());
 
-        void recreateSwapChain();
+        // returns false while window is minimized, recreation is retried by the next frame
+        bool recreateSwapChain();
 
     private:
         VkInstance m_Instance;
@@ -115,6 +211,11 @@ namespace rdk {
         Window* m_Window;
         VkSurfaceKHR m_Surface;
         std::vector<CommandBuffer> m_Buffers;
+        // compute queue family may differ from graphics one, so it has its own pool
+        VkCommandPool m_ComputeHandle;
+        std::vector<CommandBuffer> m_ComputeBuffers;
+        bool m_AsyncRecording = false;
+        bool m_AsyncSubmitted = false;
 
         Pipeline* m_Pipeline = nullptr;
 
@@ -122,9 +223,18 @@ namespace rdk {
         u32 m_MaxFramesInFlight = 2;
         u32 m_CurrentFrame = 0;
         bool m_FrameBufferResized = false;
+        // acquire or present reported that swap chain no longer matches surface
+        bool m_SwapChainOutOfDate = false;
+        std::chrono::steady_clock::time_point m_ResizeTime;
         std::vector<VkSemaphore> m_ImageAvailableSemaphore;
         std::vector<VkSemaphore> m_RenderFinishedSemaphore;
-        std::vector<VkFence> m_FlightFence;
+        std::vector<VkSemaphore> m_ComputeFinishedSemaphore;
+        // timeline value of the last submission of each frame slot
+        std::vector<u64> m_FrameValues;
+        Timeline m_Timeline;
+        DeletionQueue m_DeletionQueue;
+        DynamicResolutionSettings m_DynamicResolutionSettings;
+        DynamicResolution m_DynamicResolution;
         Queue* m_Queue;
 
         u32 currentImageIndex;
@@ -133,9 +243,6 @@ namespace rdk {
 
         VkCommandBuffer m_TempCommand;
 
-#ifdef IMGUI
-        ImGui_ImplVulkanH_Window m_ImGuiData;
-#endif
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Pipeline.h>
+
+namespace rdk {
+
+    // single compute stage with one descriptor set and optional push constant block
+    class ComputePipeline final {
+
+    public:
+        ComputePipeline() = default;
+
+        ComputePipeline(const ComputePipeline&) = delete;
+        ComputePipeline& operator=(const ComputePipeline&) = delete;
+        ComputePipeline(ComputePipeline&&) = default;
+        ComputePipeline& operator=(ComputePipeline&&) = default;
+
+    public:
+        [[nodiscard]] inline VkPipeline getHandle() const { return m_Handle; }
+        [[nodiscard]] inline VkPipelineLayout getLayout() const { return m_Layout; }
+        [[nodiscard]] inline VkDescriptorSetLayout getDescriptorLayout() const { return m_DescriptorSetLayout; }
+        inline ComputeShader& getShader() { return m_Shader; }
+
+        void create(
+                VkDevice device,
+                ComputeShader&& shader,
+                const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+                u32 pushConstantSize = 0
+        );
+        // layouts and pipeline are destroyed right away, use DeletionQueue while frames are in flight
+        void destroy();
+
+        // rebuilds pipeline from reloaded shader, returns old handle for deferred destruction
+        [[nodiscard]] VkPipeline recreate();
+
+        void bind(VkCommandBuffer commandBuffer, VkDescriptorSet descriptorSet) const;
+        void pushConstants(VkCommandBuffer commandBuffer, const void* data, u32 size) const;
+        void dispatch(VkCommandBuffer commandBuffer, u32 groupCountX, u32 groupCountY = 1, u32 groupCountZ = 1) const;
+        // VkDispatchIndirectCommand is read from buffer at offset, buffer needs VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+        void dispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset = 0) const;
+
+        // work groups needed to cover threads with groups of groupSize
+        static u32 groupCount(u32 threads, u32 groupSize);
+
+    private:
+        VkResult build(VkPipeline* handle);
+
+    private:
+        VkDevice m_LogicalDevice = VK_NULL_HANDLE;
+        VkPipeline m_Handle = VK_NULL_HANDLE;
+        VkPipelineLayout m_Layout = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_DescriptorSetLayout = VK_NULL_HANDLE;
+        ComputeShader m_Shader;
+    };
+
+}
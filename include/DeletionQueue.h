@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Image.h>
+#include <FrameBuffer.h>
+
+#include <vector>
+#include <deque>
+#include <utility>
+
+namespace rdk {
+
+    struct DeletionFrame final {
+        std::vector<std::pair<VkDescriptorPool, VkDescriptorSet>> descriptorSets;
+        std::vector<VkPipeline> pipelines;
+        std::vector<VkPipelineLayout> pipelineLayouts;
+        std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
+        std::vector<VkSwapchainKHR> swapChains;
+        std::vector<FrameBuffer> frameBuffers;
+        std::vector<ImageSampler> samplers;
+        std::vector<ImageView> views;
+        std::vector<Image> images;
+        std::vector<Buffer> buffers;
+    };
+
+    // defers destruction of GPU resources until the GPU can no longer use them, without waiting for device idle.
+    // Resources released since last submit(value) belong to the submission which signals that timeline value
+    // and are destroyed by collect() once GPU has reached it. Timeline signal also covers every earlier submission
+    // on the same queue, so resources used by other frames in flight are safe as well.
+    class DeletionQueue final {
+
+    public:
+        void create(VkDevice device);
+        // destroys everything right away, device must be idle
+        void destroy();
+
+        void release(VkPipeline pipeline);
+        void release(VkPipelineLayout layout);
+        void release(VkDescriptorSetLayout layout);
+        // pool must be created with VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
+        void release(VkDescriptorPool pool, VkDescriptorSet descriptorSet);
+        // retired swap chain, its images are gone once frames which presented them have completed
+        void release(VkSwapchainKHR swapChain);
+        void release(FrameBuffer&& frameBuffer);
+        void release(ImageSampler&& sampler);
+        void release(ImageView&& view);
+        void release(Image&& image);
+        void release(const Buffer& buffer);
+
+        // called right after submission, with timeline value it signals
+        void submit(u64 value);
+        // destroys everything submitted with value up to completedValue, e.g. Timeline::poll()
+        void collect(u64 completedValue);
+
+    private:
+        void clear(DeletionFrame& frame);
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        // released but not yet submitted
+        DeletionFrame m_Pending;
+        // ordered by timeline value
+        std::deque<std::pair<u64, DeletionFrame>> m_Submitted;
+    };
+
+}
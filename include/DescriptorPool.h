@@ -9,13 +9,36 @@ namespace rdk {
     class DescriptorPool final {
 
     public:
-        void create(VkDevice device, VkDescriptorPoolSize* poolSizes, u32 poolSizeCount, u32 maxSets);
+        // VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT allows single sets to be released through DeletionQueue
+        void create(
+                VkDevice device,
+                VkDescriptorPoolSize* poolSizes, u32 poolSizeCount,
+                u32 maxSets,
+                VkDescriptorPoolCreateFlags flags = 0
+        );
         void destroy();
 
         void createSets(u32 count, const VkDescriptorSetLayout& layout);
+        // single set which is not tracked by pool, caller frees it through DeletionQueue
+        VkDescriptorSet allocateSet(VkDescriptorSetLayout layout);
+
+        static void writeBuffer(
+                VkDevice device,
+                VkDescriptorSet descriptorSet, u32 binding,
+                VkDescriptorType type,
+                VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range
+        );
+        static void writeImage(
+                VkDevice device,
+                VkDescriptorSet descriptorSet, u32 binding,
+                VkDescriptorType type,
+                VkImageView view, VkSampler sampler, VkImageLayout layout
+        );
 
         inline VkDescriptorSet& operator [](u32 i) { return m_Sets[i]; }
 
+        [[nodiscard]] inline VkDescriptorPool getHandle() const { return m_Handle; }
+
     private:
         VkDevice m_Device;
         VkDescriptorPool m_Handle;
@@ -48,8 +48,27 @@ namespace rdk {
             return m_Features;
         }
 
+        // render pass objects are used when disabled before create() or unsupported by device
+        inline void setDynamicRenderingEnabled(bool enabled) {
+            m_DynamicRenderingEnabled = enabled;
+        }
+
+        // passes begin on image views directly and pipelines are built against attachment formats
+        [[nodiscard]] inline bool isDynamicRendering() const {
+            return m_DynamicRendering;
+        }
+
+        // shared by every pipeline build, so variants of one shader reuse each other's compiled stages
+        [[nodiscard]] inline VkPipelineCache getPipelineCache() const {
+            return m_PipelineCache;
+        }
+
+        void cmdBeginRendering(VkCommandBuffer commandBuffer, const VkRenderingInfoKHR& renderingInfo) const;
+        void cmdEndRendering(VkCommandBuffer commandBuffer) const;
+
         bool isLayerValidationSupported();
 
+        bool isFormatSupported(VkFormat format, VkImageTiling tiling, VkFormatFeatureFlags features);
         VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
         VkFormat findDepthFormat();
 
@@ -60,6 +79,7 @@ namespace rdk {
 
     private:
         bool isExtensionSupported(VkPhysicalDevice physicalDevice);
+        static bool isExtensionSupported(VkPhysicalDevice physicalDevice, const char* extension);
         bool isSuitable(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface);
         QueueFamilyIndices findQueueFamily(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface);
 
@@ -74,6 +94,13 @@ namespace rdk {
 
         VkPhysicalDeviceProperties m_Props;
         VkPhysicalDeviceFeatures m_Features;
+
+        bool m_DynamicRenderingEnabled = true;
+        bool m_DynamicRendering = false;
+        PFN_vkCmdBeginRenderingKHR m_CmdBeginRendering = nullptr;
+        PFN_vkCmdEndRenderingKHR m_CmdEndRendering = nullptr;
+
+        VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <ThreadPool.h>
+
+#include <vector>
+
+namespace rdk {
+
+    // 64-bit sort key, most significant field first:
+    // pass (4 bits) | pipeline (12 bits) | material (16 bits) | depth (32 bits).
+    // Draws of one pass are grouped by pipeline, then by material, so binds change as rarely as possible.
+    struct DrawKey final {
+        static const u32 PASS_BITS = 4;
+        static const u32 PIPELINE_BITS = 12;
+        static const u32 MATERIAL_BITS = 16;
+
+        // opaque draws go front to back for early depth rejection, transparent ones back to front
+        static u64 make(u32 pass, u32 pipeline, u32 material, float depth, bool backToFront = false);
+    };
+
+    // null handles are replaced by state bound at frame begin, see DrawList::submit()
+    struct DrawState final {
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkPipelineLayout layout = VK_NULL_HANDLE;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        VkBuffer vertexBuffer = VK_NULL_HANDLE;
+        VkBuffer indexBuffer = VK_NULL_HANDLE;
+    };
+
+    struct DrawItem final {
+        u64 key = 0;
+        DrawState state;
+        u32 indexCount = 0;
+        u32 instanceCount = 1;
+        u32 firstIndex = 0;
+        int vertexOffset = 0;
+    };
+
+    struct DrawStats final {
+        u32 draws = 0;
+        u32 pipelineBinds = 0;
+        u32 descriptorBinds = 0;
+        u32 vertexBinds = 0;
+        u32 indexBinds = 0;
+    };
+
+    // collects draws of a frame, sorts them by key with LSD radix sort and records them,
+    // binding pipeline, descriptor set and buffers only when they differ from the previous draw
+    class DrawList final {
+
+    public:
+        // lists shorter than this are sorted on calling thread
+        static const size_t PARALLEL_THRESHOLD = 4096;
+
+        inline void add(const DrawItem& draw) { m_Draws.emplace_back(draw); }
+        void clear();
+
+        [[nodiscard]] inline size_t size() const { return m_Draws.size(); }
+        [[nodiscard]] inline bool empty() const { return m_Draws.empty(); }
+        // counts of the last submit()
+        [[nodiscard]] inline const DrawStats& getStats() const { return m_Stats; }
+
+        // stable, so draws with equal keys keep submission order. Thread pool may be null.
+        void sort(ThreadPool* threadPool);
+        // bound is state already recorded into command buffer, it also fills null handles of draws
+        void submit(VkCommandBuffer commandBuffer, const DrawState& bound);
+
+    private:
+        struct SortEntry final {
+            u64 key;
+            u32 draw;
+        };
+
+        static const u32 RADIX_BITS = 8;
+        static const u32 RADIX = 1 << RADIX_BITS;
+
+    private:
+        std::vector<DrawItem> m_Draws;
+        std::vector<SortEntry> m_Entries;
+        std::vector<SortEntry> m_Scratch;
+        // RADIX counters per chunk, reused as scatter offsets
+        std::vector<u32> m_Histograms;
+        DrawStats m_Stats;
+    };
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <SwapChain.h>
+
+#include <memory>
+#include <vector>
+
+namespace rdk {
+
+    struct DynamicResolutionSettings final {
+        bool enabled = false;
+        // GPU time of scene pass to stay under, in milliseconds. UI and upscale run on top of it.
+        float frameBudget = 14.0f;
+        // bounds of render scale per axis, relative to swap chain extent
+        float minScale = 0.5f;
+        float maxScale = 1.0f;
+        // fraction of the gap to target scale closed per frame while GPU has headroom,
+        // scale drops at once when scene goes over budget
+        float recovery = 0.05f;
+    };
+
+    // renders scene into offscreen target at a fraction of swap chain extent and upscales it with linear blit,
+    // before UI is composed at native resolution. Target is allocated at maxScale once per swap chain,
+    // lower scales only shrink render area, so scale changes don't reallocate anything.
+    // Scale follows scene GPU time measured with timestamp queries of each frame slot.
+    class DynamicResolution final {
+
+    public:
+        // stays inactive when disabled or when swap chain images can't be blitted into
+        void create(Device* device, SwapChain* swapChain, u32 graphicsFamily, u32 framesInFlight, const DynamicResolutionSettings& settings);
+        // device must be idle
+        void destroy();
+        // called after swap chain recreation, old target is retired through deletion queue
+        void resize(DeletionQueue& deletionQueue);
+
+        // depth of scene target is stored only while something reads it after scene pass,
+        // otherwise it's transient attachment. Takes effect with the next create().
+        inline void setDepthStored(bool stored) { m_DepthStored = stored; }
+
+        [[nodiscard]] inline bool isActive() const { return m_Active; }
+        [[nodiscard]] inline float getScale() const { return m_Scale; }
+        [[nodiscard]] inline const VkExtent2D& getRenderExtent() const { return m_RenderExtent; }
+        // extent of scene target, render extent covers its top left part
+        [[nodiscard]] inline const VkExtent2D& getTargetExtent() const { return m_TargetExtent; }
+        [[nodiscard]] inline VkImage getDepthImage() const { return m_DepthImage->getHandle(); }
+        [[nodiscard]] inline VkImageView getDepthView() const { return m_DepthView->getHandle(); }
+        // scene pass time of the latest measured frame in milliseconds, stays 0 without timestamp support
+        [[nodiscard]] inline float getGpuTime() const { return m_GpuTime; }
+        [[nodiscard]] inline const DynamicResolutionSettings& getSettings() const { return m_Settings; }
+
+        // reads timestamps of frame slot and picks scale of the next frame, frame slot must be waited
+        void update(u32 frame);
+
+        void cmdBeginScene(VkCommandBuffer commandBuffer, u32 frame);
+        // continues scene pass suspended between cmdBeginScene() and cmdEndScene(), keeping its color and depth
+        void cmdResumeScene(VkCommandBuffer commandBuffer);
+        void cmdEndScene(VkCommandBuffer commandBuffer, u32 frame);
+        // render area of scene target -> whole swap chain image, which is left in color attachment layout.
+        // Blit is the first access of swap chain image, so image available semaphore is waited at transfer stage.
+        void cmdUpscale(VkCommandBuffer commandBuffer, VkImage swapChainImage);
+        // swap chain pass which loads upscaled scene instead of clearing it, compatible with swap chain render pass.
+        // With dynamic rendering it has no depth attachment.
+        void cmdBeginComposition(VkCommandBuffer commandBuffer, u32 imageIndex);
+
+    private:
+        bool isSupported() const;
+        void createTarget();
+        void destroyTarget();
+        void releaseTarget(DeletionQueue& deletionQueue);
+        RenderingTarget getRenderingTarget() const;
+        void updateRenderExtent();
+
+    private:
+        Device* m_Device = nullptr;
+        SwapChain* m_SwapChain = nullptr;
+        DynamicResolutionSettings m_Settings;
+        bool m_Active = false;
+        bool m_DepthStored = true;
+
+        std::unique_ptr<RenderPass> m_SceneRenderPass;
+        std::unique_ptr<RenderPass> m_ResumeRenderPass;
+        std::unique_ptr<RenderPass> m_CompositionRenderPass;
+        VkExtent2D m_TargetExtent{};
+        std::unique_ptr<Image> m_ColorImage;
+        std::unique_ptr<ImageView> m_ColorView;
+        std::unique_ptr<Image> m_DepthImage;
+        std::unique_ptr<ImageView> m_DepthView;
+        // render pass backend only
+        std::unique_ptr<FrameBuffer> m_FrameBuffer;
+
+        float m_Scale = 1.0f;
+        VkExtent2D m_RenderExtent{};
+
+        // two timestamps per frame slot, none when graphics queue doesn't support them
+        VkQueryPool m_QueryPool = VK_NULL_HANDLE;
+        float m_TimestampPeriod = 0.0f;
+        u64 m_TimestampMask = 0;
+        std::vector<float> m_FrameScales;
+        std::vector<bool> m_FrameQueried;
+        float m_GpuTime = 0.0f;
+    };
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Core.h>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+
+namespace rdk {
+
+    // reports modified files without blocking. Linux uses inotify on parent directories, so atomic
+    // rename saves of editors are seen too. Other platforms poll file stamps once per poll interval.
+    class FileWatcher final {
+
+    public:
+        FileWatcher() = default;
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+    public:
+        void create(u32 pollIntervalMs = 250);
+        void destroy();
+
+        [[nodiscard]] inline bool isActive() const { return m_Active; }
+        [[nodiscard]] inline bool isNotified() const { return m_Fd >= 0; }
+
+        // no-op until create()
+        void watch(const std::string& filepath);
+        // watched files changed since last call, each reported once
+        std::vector<std::string> poll();
+
+    private:
+        struct FileStamp final {
+            bool exists = false;
+            u64 modifiedTime = 0;
+            u64 size = 0;
+        };
+
+        static FileStamp stamp(const std::string& filepath);
+
+        std::vector<std::string> pollStamps();
+        std::vector<std::string> pollNotify();
+
+    private:
+        bool m_Active = false;
+        int m_Fd = -1;
+        std::unordered_map<std::string, FileStamp> m_Files;
+        // inotify watch descriptor -> directory
+        std::unordered_map<int, std::string> m_Directories;
+        std::chrono::milliseconds m_PollInterval { 250 };
+        std::chrono::steady_clock::time_point m_LastPoll;
+    };
+
+}
@@ -17,14 +17,23 @@ namespace rdk {
                 const VkExtent2D& extent);
         ~FrameBuffer();
 
+        // owns Vulkan handle, so it's move only
+        FrameBuffer(const FrameBuffer&) = delete;
+        FrameBuffer& operator=(const FrameBuffer&) = delete;
+        FrameBuffer(FrameBuffer&& other) noexcept;
+        FrameBuffer& operator=(FrameBuffer&& other) noexcept;
+
     public:
         inline VkFramebuffer getHandle() {
             return m_Handle;
         }
 
     private:
-        VkFramebuffer m_Handle;
-        VkDevice m_Device;
+        void release();
+
+    private:
+        VkFramebuffer m_Handle = VK_NULL_HANDLE;
+        VkDevice m_Device = VK_NULL_HANDLE;
     };
 
 }
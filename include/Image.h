@@ -17,6 +17,17 @@ namespace rdk {
 
     public:
         static ImageData load(const char* filepath, VkDevice device, VkPhysicalDevice physicalDevice);
+        // same as above, but decodes encoded file bytes, e.g. entry of mapped asset pack
+        static ImageData load(const u8* data, size_t size, VkDevice device, VkPhysicalDevice physicalDevice);
+
+        // reads only image header, returns false if format is not recognized
+        static bool info(const char* filepath, u32* width, u32* height);
+        static bool info(const u8* data, size_t size, u32* width, u32* height);
+        // decodes RGBA8 pixels into dst, which must hold width * height * 4 bytes. Thread safe.
+        static bool decode(const char* filepath, void* dst, VkDeviceSize size);
+        static bool decode(const u8* data, size_t size, void* dst, VkDeviceSize dstSize);
+
+        static u32 mipLevels(u32 width, u32 height);
     };
 
     struct ImageInfo final {
@@ -27,6 +38,7 @@ namespace rdk {
         VkImageUsageFlags usage;
         VkMemoryPropertyFlags properties;
         u32 mipLevels = 1;
+        VkImageCreateFlags flags = 0;
     };
 
     class Image final {
@@ -42,17 +54,24 @@ namespace rdk {
 
         ~Image();
 
+        // owns Vulkan handles, so it's move only
+        Image(const Image&) = delete;
+        Image& operator=(const Image&) = delete;
+        Image(Image&& other) noexcept;
+        Image& operator=(Image&& other) noexcept;
+
     public:
         [[nodiscard]] inline VkImage getHandle() const { return m_Handle; }
         [[nodiscard]] inline VkDevice getDevice() const { return m_Device; }
 
     private:
         void freeMemory();
+        void release();
 
     private:
-        VkImage m_Handle;
-        VkDeviceMemory m_Memory;
-        VkDevice m_Device;
+        VkImage m_Handle = VK_NULL_HANDLE;
+        VkDeviceMemory m_Memory = VK_NULL_HANDLE;
+        VkDevice m_Device = VK_NULL_HANDLE;
     };
 
     struct ImageViewInfo final {
@@ -62,6 +81,9 @@ namespace rdk {
         u32 baseArrayLayer = 0;
         u32 mipLevels = 1;
         u32 layerCount = 1;
+        // subset of image usage the view is used for, whole image usage when 0.
+        // Needed for views of images created with VK_IMAGE_CREATE_EXTENDED_USAGE_BIT.
+        VkImageUsageFlags usage = 0;
     };
 
     class ImageView final {
@@ -77,12 +99,20 @@ namespace rdk {
 
         ~ImageView();
 
+        ImageView(const ImageView&) = delete;
+        ImageView& operator=(const ImageView&) = delete;
+        ImageView(ImageView&& other) noexcept;
+        ImageView& operator=(ImageView&& other) noexcept;
+
     public:
         [[nodiscard]] inline VkImageView getHandle() const { return m_Handle; }
 
     private:
-        VkImageView m_Handle;
-        VkDevice m_Device;
+        void release();
+
+    private:
+        VkImageView m_Handle = VK_NULL_HANDLE;
+        VkDevice m_Device = VK_NULL_HANDLE;
     };
 
     struct ImageSamplerInfo final {
@@ -110,12 +140,20 @@ namespace rdk {
 
         ~ImageSampler();
 
+        ImageSampler(const ImageSampler&) = delete;
+        ImageSampler& operator=(const ImageSampler&) = delete;
+        ImageSampler(ImageSampler&& other) noexcept;
+        ImageSampler& operator=(ImageSampler&& other) noexcept;
+
     public:
         [[nodiscard]] inline VkSampler getHandle() const { return m_Handle; }
 
     private:
-        VkSampler m_Handle;
-        VkDevice m_Device;
+        void release();
+
+    private:
+        VkSampler m_Handle = VK_NULL_HANDLE;
+        VkDevice m_Device = VK_NULL_HANDLE;
     };
 
 }
\ No newline at end of file
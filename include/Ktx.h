@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Core.h>
+
+#include <vector>
+#include <string>
+
+namespace rdk {
+
+    struct KtxLevel final {
+        // offset into KtxTexture::data, or into container bytes for textures from KtxFile::parseIndex
+        u64 offset = 0;
+        u64 size = 0;
+        u32 width = 0;
+        u32 height = 0;
+    };
+
+    // 2D texture with every mip level precomputed, level 0 is the largest one
+    struct KtxTexture final {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        u32 width = 0;
+        u32 height = 0;
+        std::vector<KtxLevel> levels;
+        std::vector<u8> data;
+    };
+
+    // subset of KTX2: single layer, single face, no supercompression
+    class KtxFile final {
+
+    public:
+        static bool isKtx2(const u8* data, size_t size);
+        static bool hasKtx2Extension(const char* filepath);
+
+        static KtxTexture load(const char* filepath);
+        static KtxTexture parse(const u8* data, size_t size);
+        // reads header and level index only, data stays empty and levels point into the container.
+        // data may hold just the beginning of container of containerSize bytes, KTX2_INDEX_SIZE is always enough.
+        static KtxTexture parseIndex(const u8* data, size_t size, size_t containerSize);
+
+        static const size_t KTX2_INDEX_SIZE = 1024;
+
+        static std::vector<u8> serialize(const KtxTexture& texture);
+        static void save(const char* filepath, const KtxTexture& texture);
+    };
+
+}
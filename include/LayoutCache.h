@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Core.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace rdk {
+
+    // descriptor set and pipeline layouts shared by every pipeline that declares the same resources.
+    // Pipelines with compatible layouts keep descriptor sets bound across pipeline changes.
+    class LayoutCache final {
+
+    public:
+        void create(VkDevice device);
+        // device must be idle, every layout handed out is destroyed
+        void destroy();
+
+        // bindings must be sorted by binding, as ShaderLayout keeps them
+        VkDescriptorSetLayout getDescriptorLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+        VkPipelineLayout getPipelineLayout(
+                const std::vector<VkDescriptorSetLayout>& setLayouts,
+                const std::vector<VkPushConstantRange>& pushConstants
+        );
+
+        [[nodiscard]] inline size_t getDescriptorLayoutCount() const { return m_DescriptorLayouts.size(); }
+        [[nodiscard]] inline size_t getPipelineLayoutCount() const { return m_PipelineLayouts.size(); }
+
+    private:
+        // create info serialized into words, equal keys give compatible layouts
+        using Key = std::vector<u32>;
+
+        struct KeyHash final {
+            size_t operator()(const Key& key) const;
+        };
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        std::unordered_map<Key, VkDescriptorSetLayout, KeyHash> m_DescriptorLayouts;
+        std::unordered_map<Key, VkPipelineLayout, KeyHash> m_PipelineLayouts;
+    };
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <Core.h>
+
+#include <cstddef>
+
+namespace rdk {
+
+    // LZ4 block format codec (no frame format), compatible with reference lz4 block API
+    class Lz4 final {
+
+    public:
+        static size_t compressBound(size_t srcSize);
+
+        // returns compressed size, 0 if dst is smaller than compressBound(srcSize)
+        static size_t compress(const u8* src, size_t srcSize, u8* dst, size_t dstCapacity);
+
+        // dstSize must be the exact decompressed size, returns false on malformed input
+        static bool decompress(const u8* src, size_t srcSize, u8* dst, size_t dstSize);
+    };
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <ThreadPool.h>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace rdk {
+
+    struct LodLevel final {
+        u32 firstIndex = 0;
+        u32 indexCount = 0;
+        // object space geometric deviation from the source mesh
+        float error = 0;
+    };
+
+    // all levels index into the same vertex buffer, their index ranges are stored back to back
+    struct LodChain final {
+        std::vector<u32> indices;
+        std::vector<LodLevel> levels;
+    };
+
+    struct LodSettings final {
+        u32 maxLevels = 5;
+        // target index count of each level relative to the previous one
+        float reduction = 0.5f;
+        // stop generating levels once collapse error exceeds this value (object space units)
+        float maxError = 1.0f;
+        u32 minIndexCount = 36;
+    };
+
+    class MeshSimplifier final {
+
+    public:
+        // quadric error metric edge collapse, vertices are never moved or created,
+        // so the result can be drawn with the source vertex buffer.
+        // positions point to the first vec3 of the vertex, stride is the vertex size in bytes.
+        static std::vector<u32> simplify(
+                const float* positions, u32 vertexCount, u32 stride,
+                const u32* indices, u32 indexCount,
+                u32 targetIndexCount, float maxError,
+                float* resultError = nullptr
+        );
+
+        static LodChain buildLodChain(
+                const float* positions, u32 vertexCount, u32 stride,
+                const u32* indices, u32 indexCount,
+                const LodSettings& settings = {}
+        );
+    };
+
+    struct LodObject final {
+        glm::vec3 center = glm::vec3(0);
+        float radius = 1.0f;
+        // largest scale factor of the object transform, scales chain error into world space
+        float scale = 1.0f;
+        const LodChain* chain = nullptr;
+        u32 level = 0;
+    };
+
+    struct LodView final {
+        glm::vec3 position = glm::vec3(0);
+        float fovY = glm::radians(45.0f);
+        float viewportHeight = 600.0f;
+        // max allowed projected error in pixels
+        float pixelError = 1.0f;
+    };
+
+    class LodSelector final {
+
+    public:
+        // picks the coarsest level whose projected screen space error stays below view.pixelError
+        static u32 select(const LodObject& object, const LodView& view);
+        static void select(LodObject* objects, size_t count, const LodView& view, ThreadPool* threadPool = nullptr);
+    };
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <ComputePipeline.h>
+#include <DescriptorPool.h>
+#include <DeletionQueue.h>
+#include <Device.h>
+#include <AssetPack.h>
+
+namespace rdk {
+
+    enum class MipFilter : u32 {
+        BOX = 0,
+        // 4x4 windowed sinc on the first reduction of each pass, box below it
+        KAISER = 1
+    };
+
+    // generates whole mip chain of RGBA8 image with single compute dispatch, see shaders/downsample.comp.
+    // Needs neither linear blit support nor per level barriers. sRGB images are filtered in linear space
+    // through UNORM storage views, so they must be created with imageFlags() and sampled through views
+    // restricted to VK_IMAGE_USAGE_SAMPLED_BIT.
+    class MipGenerator final {
+
+    public:
+        // mip 0 plus 12 generated levels, enough for 4096x4096
+        static const u32 MAX_LEVELS = 13;
+        static const u32 MAX_SIZE = 4096;
+
+        // falls back to inactive state when shader can't be built, callers use blits then
+        void create(Device* device, const AssetPack* assetPack, const char* shaderFilepath = "shaders/downsample.comp");
+        void destroy();
+
+        [[nodiscard]] inline bool isActive() const { return m_Active; }
+        [[nodiscard]] inline const std::string& getShaderFilepath() const { return m_ShaderFilepath; }
+
+        bool supports(VkFormat format, u32 width, u32 height, u32 mipLevels) const;
+
+        static VkImageUsageFlags imageUsage() { return VK_IMAGE_USAGE_STORAGE_BIT; }
+        static VkImageCreateFlags imageFlags(VkFormat format);
+
+        // mip 0 must be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL after transfer writes, every mip ends up in
+        // VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL. Returns false and records nothing when descriptor pool is exhausted.
+        bool cmdGenerate(
+                VkCommandBuffer commandBuffer,
+                VkImage image, VkFormat format,
+                u32 width, u32 height, u32 mipLevels,
+                MipFilter filter = MipFilter::BOX
+        );
+        // views and sets of recorded dispatches go to deletion queue, for commands submitted with frame
+        void release(DeletionQueue& deletionQueue);
+        // destroys them right away, recorded commands must have completed
+        void flush();
+
+        // after shader file changed, keeps previous pipeline on failure
+        void reload(DeletionQueue& deletionQueue);
+
+    private:
+        struct MipParams final {
+            u32 width;
+            u32 height;
+            u32 levels;
+            u32 groups;
+            u32 srgb;
+            u32 filter;
+        };
+
+    private:
+        Device* m_Device = nullptr;
+        bool m_Active = false;
+        bool m_StorageSupported = false;
+        std::string m_ShaderFilepath;
+        ComputePipeline m_Pipeline;
+        DescriptorPool m_DescriptorPool;
+        // completion counter of groups, last group resets it
+        Buffer m_Counter;
+        std::vector<ImageView> m_PendingViews;
+        std::vector<VkDescriptorSet> m_PendingSets;
+    };
+
+}
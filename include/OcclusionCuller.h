@@ -0,0 +1,145 @@
+#pragma once
+
+#include <ComputePipeline.h>
+#include <DescriptorPool.h>
+#include <DeletionQueue.h>
+#include <Device.h>
+#include <AssetPack.h>
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace rdk {
+
+    // bounding sphere and index range of single object, all objects are drawn from default mesh buffers
+    struct CullObject final {
+        // xyz - center, w - radius, in space transformed by cull matrix
+        glm::vec4 sphere = glm::vec4(0.0f);
+        u32 indexCount = 0;
+        u32 firstIndex = 0;
+        int vertexOffset = 0;
+        u32 padding = 0;
+    };
+
+    enum class CullPhase : u32 {
+        // objects visible in previous frame, tested against frustum only
+        EARLY = 0,
+        // every object, tested against frustum and pyramid built from early phase depth
+        LATE = 1
+    };
+
+    // depth attachment of scene pass, whose top left renderExtent part is rendered
+    struct DepthTarget final {
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkExtent2D extent{};
+        VkExtent2D renderExtent{};
+    };
+
+    // two phase GPU occlusion culling against hierarchical depth, see shaders/hiz.comp and shaders/cull.comp.
+    // Objects visible in previous frame are drawn first, their depth is reduced into max depth pyramid,
+    // then every object is tested against it and those which became visible are drawn on top.
+    // Culled objects get indirect commands with zero instances, so they never reach the rasterizer.
+    class OcclusionCuller final {
+
+    public:
+        static const u32 MAX_LEVELS = 16;
+
+        // stays inactive when pyramid format can't be stored to, depth format can't be sampled or shaders fail
+        void create(
+                Device* device,
+                DeletionQueue* deletionQueue,
+                const AssetPack* assetPack,
+                VkFormat depthFormat,
+                const char* hizFilepath = "shaders/hiz.comp",
+                const char* cullFilepath = "shaders/cull.comp"
+        );
+        // device must be idle
+        void destroy();
+
+        [[nodiscard]] inline bool isSupported() const { return m_Active; }
+        // supported and has objects to cull
+        [[nodiscard]] inline bool isActive() const { return m_Active && m_ObjectCount > 0; }
+        [[nodiscard]] inline const std::string& getHizFilepath() const { return m_HizFilepath; }
+        [[nodiscard]] inline const std::string& getCullFilepath() const { return m_CullFilepath; }
+
+        // every object counts as visible in the frame after the change
+        void setObjects(const std::vector<CullObject>& objects);
+
+        // (re)allocates pyramid and rewrites descriptor sets when depth target has changed, outside of command recording
+        void prepare(const DepthTarget& depth);
+
+        // records culling of the given phase, outside of render pass
+        void cmdCull(VkCommandBuffer commandBuffer, CullPhase phase, const glm::mat4& viewProj);
+        // reduces depth written so far into pyramid, outside of render pass.
+        // Depth is left in VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL.
+        void cmdBuildPyramid(VkCommandBuffer commandBuffer, const DepthTarget& depth);
+        // draws of the given phase, pipeline and mesh buffers must be bound
+        void cmdDraw(VkCommandBuffer commandBuffer, CullPhase phase);
+
+        // after shader file changed, keeps previous pipeline on failure
+        void reload(const std::string& filepath);
+
+    private:
+        struct HizParams final {
+            u32 srcWidth;
+            u32 srcHeight;
+            u32 dstWidth;
+            u32 dstHeight;
+        };
+
+        struct CullParams final {
+            glm::mat4 viewProj;
+            u32 pyramidWidth;
+            u32 pyramidHeight;
+            u32 objectCount;
+            u32 phase;
+            u32 levels;
+        };
+
+    private:
+        void createPyramid(const VkExtent2D& extent);
+        void releasePyramid();
+        void releaseObjects();
+        void releaseSets();
+        void writeSets(const DepthTarget& depth);
+
+    private:
+        Device* m_Device = nullptr;
+        DeletionQueue* m_DeletionQueue = nullptr;
+        bool m_Active = false;
+        std::string m_HizFilepath;
+        std::string m_CullFilepath;
+        ComputePipeline m_HizPipeline;
+        ComputePipeline m_CullPipeline;
+        DescriptorPool m_DescriptorPool;
+        ImageSampler m_Sampler;
+
+        // host visible CullObject array
+        Buffer m_Objects;
+        // flags per object, visibility of previous frame and early phase draw, see shaders/cull.comp
+        Buffer m_Visibility;
+        // VkDrawIndexedIndirectCommand per object, early phase draws followed by late phase ones
+        Buffer m_Draws;
+        u32 m_ObjectCount = 0;
+        bool m_VisibilityReset = false;
+
+        // R32 max depth pyramid, power of two not larger than depth target
+        Image m_Pyramid;
+        ImageView m_PyramidView;
+        std::vector<ImageView> m_LevelViews;
+        VkExtent2D m_PyramidExtent{};
+        u32 m_Levels = 0;
+
+        // level i is built from level i - 1, level 0 from depth
+        std::vector<VkDescriptorSet> m_LevelSets;
+        VkDescriptorSet m_CullSet = VK_NULL_HANDLE;
+        bool m_SetsDirty = true;
+        VkImageView m_DepthView = VK_NULL_HANDLE;
+        VkExtent2D m_DepthExtent{};
+    };
+
+}
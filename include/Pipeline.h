@@ -2,6 +2,7 @@
 
 #include <Shader.h>
 #include <SwapChain.h>
+#include <LayoutCache.h>
 
 #include <memory>
 
@@ -11,7 +12,13 @@ namespace rdk {
         VERTEX_UNIFORM_BUFFER,
         FRAG_UNIFORM_BUFFER,
         VERTEX_SAMPLER,
-        FRAG_SAMPLER
+        FRAG_SAMPLER,
+        VERTEX_STORAGE_BUFFER,
+        FRAG_STORAGE_BUFFER,
+        COMPUTE_UNIFORM_BUFFER,
+        COMPUTE_STORAGE_BUFFER,
+        COMPUTE_STORAGE_IMAGE,
+        COMPUTE_SAMPLER
     };
 
     class Pipeline final {
@@ -22,6 +29,9 @@ namespace rdk {
 
     public:
         [[nodiscard]] inline VkPipeline getHandle() const { return m_Handle; }
+        [[nodiscard]] inline VkPipelineLayout getLayout() const { return m_Layout; }
+        // layout of set 0
+        [[nodiscard]] inline VkDescriptorSetLayout getDescriptorLayout() const { return m_DescriptorSetLayout; }
 
         inline SwapChain& getSwapChain() {
             return *m_SwapChain;
@@ -36,12 +46,20 @@ namespace rdk {
         void setViewport(const VkExtent2D& extent);
         void setScissor(const VkExtent2D& extent);
         void setShader(const Shader& shader);
+        // constant values applied to every stage, kept for rebuilds with reloaded shader
+        void setSpecialization(const std::vector<VkSpecializationMapEntry>& entries, const std::vector<VkBool32>& data);
+        // formats the pipeline is rendered into with dynamic rendering, swap chain formats by default.
+        // Pipeline is then compatible with any target of these formats, not with single render pass.
+        void setAttachmentFormats(VkFormat colorFormat, VkFormat depthFormat);
         void setRasterizer();
         void setMultisampling();
         void setColorBlendAttachment();
         void setColorBlending();
         void setLayout();
         void createLayout();
+        // descriptor set and pipeline layouts from cache, shared with other pipelines of the same layout.
+        // Replaces setLayout(), createLayout() and createDescriptorLayout(), cache keeps ownership of layouts.
+        void setLayout(LayoutCache& layoutCache, const ShaderLayout& layout);
         void setVertexBuffer(Buffer* vertexBuffer);
         void setIndexBuffer(Buffer* indexBuffer);
         void setDepthStencil(
@@ -58,22 +76,39 @@ namespace rdk {
 
         VkDescriptorSetLayout createDescriptorLayout(VkDescriptorSetLayoutBinding* bindings, size_t count);
 
-        VkDescriptorSetLayoutBinding createBinding(u32 binding, LayoutBinding bindingType);
+        static VkDescriptorSetLayoutBinding createBinding(u32 binding, LayoutBinding bindingType);
 
         void create();
+        // rebuilds pipeline with new shader stages and the same state, returns old handle.
+        // Old handle may still be used by frames in flight, so caller destroys it once they retire.
+        [[nodiscard]] VkPipeline recreate(const Shader& shader);
         void destroy();
         void destroyDescriptorLayout();
 
         void beginRenderPass(VkCommandBuffer commandBuffer, u32 imageIndex);
-        void endRenderPass(VkCommandBuffer commandBuffer);
+        // ends current pass mid-frame, swap chain or offscreen one, attachments are left in the layouts resume passes expect
+        void suspendRenderPass(VkCommandBuffer commandBuffer);
+        // continues swap chain pass ended mid-frame, loading its color and depth instead of clearing them
+        void resumeRenderPass(VkCommandBuffer commandBuffer, u32 imageIndex);
+        // continues suspended swap chain pass with color only, for pipelines built without depth format.
+        // Dynamic rendering only, render pass backend keeps drawing them into the pass with depth.
+        void beginOverlayPass(VkCommandBuffer commandBuffer, u32 imageIndex);
+        // swap chain image is left ready for presentation
+        void endRenderPass(VkCommandBuffer commandBuffer, u32 imageIndex);
 
         void bind(VkCommandBuffer commandBuffer, VkDescriptorSet* descriptorSet);
 
         void setViewPort(VkCommandBuffer commandBuffer);
         void setScissor(VkCommandBuffer commandBuffer);
+        // render area of offscreen pass may be smaller than swap chain extent
+        void setViewPort(VkCommandBuffer commandBuffer, const VkExtent2D& extent);
+        void setScissor(VkCommandBuffer commandBuffer, const VkExtent2D& extent);
 
         void drawVertices(VkCommandBuffer commandBuffer, u32 vertexCount, u32 instanceCount);
-        void drawIndices(VkCommandBuffer commandBuffer, u32 indexCount, u32 instanceCount);
+        void drawIndices(VkCommandBuffer commandBuffer, u32 indexCount, u32 instanceCount, u32 firstIndex = 0);
+
+    private:
+        VkResult build(VkPipeline* handle);
 
     private:
         VkPipeline m_Handle;
@@ -92,6 +127,9 @@ namespace rdk {
         };
         VkPipelineInputAssemblyStateCreateInfo m_InputAssembly{};
         VkPipelineVertexInputStateCreateInfo m_VertexInputState{};
+        // owned copies, so pipeline can be rebuilt after caller's descriptions are gone
+        std::vector<VkVertexInputBindingDescription> m_VertexBindings;
+        std::vector<VkVertexInputAttributeDescription> m_VertexAttributes;
         VkViewport m_Viewport{};
         VkRect2D m_Scissor{};
         VkPipelineViewportStateCreateInfo m_ViewportState{};
@@ -101,12 +139,19 @@ namespace rdk {
         VkPipelineColorBlendAttachmentState m_ColorBlendAttachment{};
         VkPipelineColorBlendStateCreateInfo m_ColorBlending{};
         std::vector<VkPipelineShaderStageCreateInfo> m_ShaderStages;
+        std::vector<VkSpecializationMapEntry> m_SpecializationEntries;
+        std::vector<VkBool32> m_SpecializationData;
+        VkSpecializationInfo m_SpecializationInfo{};
+        VkFormat m_ColorFormat = VK_FORMAT_UNDEFINED;
+        VkFormat m_DepthFormat = VK_FORMAT_UNDEFINED;
+        VkPipelineRenderingCreateInfoKHR m_RenderingInfo{};
 
         VkPipelineLayout m_Layout;
         VkPipelineLayoutCreateInfo m_LayoutInfo{};
 
         VkDescriptorSetLayout m_DescriptorSetLayout;
         VkDescriptorSetLayoutCreateInfo m_DescriptorSetLayoutInfo{};
+        bool m_LayoutCached = false;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Core.h>
+
+#include <cstddef>
+
+namespace rdk {
+
+    enum class SimdLevel : u8 {
+        SCALAR,
+        SSE2,
+        AVX2,
+        NEON
+    };
+
+    // pixel format conversion kernels, each dispatched to the best instruction set of the running CPU.
+    // All kernels accept unaligned pointers and any pixel count, the remainder is processed by scalar code.
+    class PixelConvert final {
+
+    public:
+        [[nodiscard]] static SimdLevel getSupportedLevel();
+        [[nodiscard]] static SimdLevel getSimdLevel();
+        // overrides dispatch, e.g. to compare kernels in benchmarks. Clamped to supported level.
+        static void setSimdLevel(SimdLevel level);
+        static const char* getName(SimdLevel level);
+
+        // RGB8 -> RGBA8 with constant alpha
+        static void expandRGBToRGBA(const u8* src, u8* dst, size_t pixelCount, u8 alpha = 255);
+        // RGBA8 -> RGB8, alpha is dropped
+        static void packRGBAToRGB(const u8* src, u8* dst, size_t pixelCount);
+        // dst channel i = src channel order[i], e.g. { 2, 1, 0, 3 } for RGBA <-> BGRA. src may alias dst.
+        static void swizzleRGBA(const u8* src, u8* dst, size_t pixelCount, const u8 order[4]);
+        // RGB multiplied by alpha with exact rounding, works on stored values. src may alias dst.
+        static void premultiplyAlpha(const u8* src, u8* dst, size_t pixelCount);
+
+        // sRGB encoded RGBA8 -> linear RGBA32F, alpha is treated as linear
+        static void srgbToLinear(const u8* src, float* dst, size_t pixelCount);
+        // sRGB encoded RGBA8 -> linear RGBA16F, suitable for VK_FORMAT_R16G16B16A16_SFLOAT uploads
+        static void srgbToLinearHalf(const u8* src, u16* dst, size_t pixelCount);
+
+        // IEEE binary16 <-> binary32, round to nearest even, NaN and Inf preserved
+        static void floatToHalf(const float* src, u16* dst, size_t count);
+        static void halfToFloat(const u16* src, float* dst, size_t count);
+    };
+
+}
@@ -9,10 +9,16 @@ namespace rdk {
 
         int graphicsFamily = NONE_FAMILY;
         int presentationFamily = NONE_FAMILY;
+        // family without graphics support if device has one, graphics family otherwise
+        int computeFamily = NONE_FAMILY;
 
         inline bool completed() const {
             return graphicsFamily != NONE_FAMILY && presentationFamily != NONE_FAMILY;
         }
+
+        inline bool hasAsyncCompute() const {
+            return computeFamily != NONE_FAMILY && computeFamily != graphicsFamily;
+        }
     };
 
     class Queue final {
@@ -28,6 +34,11 @@ namespace rdk {
             return m_PresentationHandle;
         }
 
+        // same as graphics queue on devices without separate compute family
+        inline VkQueue getComputeHandle() {
+            return m_ComputeHandle;
+        }
+
         inline QueueFamilyIndices& getFamilyIndices() {
             return m_FamilyIndices;
         }
@@ -35,6 +46,7 @@ namespace rdk {
     private:
         VkQueue m_GraphicsHandle;
         VkQueue m_PresentationHandle;
+        VkQueue m_ComputeHandle;
         QueueFamilyIndices m_FamilyIndices;
     };
 
@@ -1,15 +1,52 @@
 #pragma once
 
-#include <Core.h>
+#include <Device.h>
 
 namespace rdk {
 
+    // defaults describe swap chain pass, which clears both attachments and leaves color ready for presentation.
+    // Depth is stored, so it can be read back between passes, e.g. by occlusion culling.
+    struct RenderPassInfo final {
+        VkAttachmentLoadOp colorLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        VkImageLayout colorInitialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImageLayout colorFinalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        VkAttachmentLoadOp depthLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        VkAttachmentStoreOp depthStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+        VkImageLayout depthInitialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    };
+
+    // image views of a pass begun with dynamic rendering, depth is omitted when its view is null
+    struct RenderingTarget final {
+        VkImage colorImage = VK_NULL_HANDLE;
+        VkImageView colorView = VK_NULL_HANDLE;
+        VkImage depthImage = VK_NULL_HANDLE;
+        VkImageView depthView = VK_NULL_HANDLE;
+        VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+    };
+
+    // dynamic rendering counterpart of RenderPass, described by the same RenderPassInfo.
+    // Layout transitions done by render pass are recorded as barriers instead:
+    // initial layouts before the pass begins, color final layout after it ends.
+    void cmdBeginRendering(
+            const Device& device,
+            VkCommandBuffer commandBuffer,
+            const RenderingTarget& target,
+            const VkExtent2D& renderArea,
+            const RenderPassInfo& info = {}
+    );
+    void cmdEndRendering(
+            const Device& device,
+            VkCommandBuffer commandBuffer,
+            const RenderingTarget& target,
+            const RenderPassInfo& info = {}
+    );
+
     class RenderPass final {
 
     public:
         RenderPass() = default;
 
-        RenderPass(VkDevice device, VkFormat colorFormat, VkFormat depthFormat);
+        RenderPass(VkDevice device, VkFormat colorFormat, VkFormat depthFormat, const RenderPassInfo& info = {});
 
         ~RenderPass();
 
@@ -5,6 +5,18 @@
 #include <Device.h>
 #include <CommandPool.h>
 #include <Image.h>
+#include <MeshLod.h>
+#include <TextureCooker.h>
+#include <TextureStreamer.h>
+#include <AssetPack.h>
+#include <AsyncFileSystem.h>
+#include <FileWatcher.h>
+#include <SlotMap.h>
+#include <MipGenerator.h>
+#include <DrawList.h>
+#include <OcclusionCuller.h>
+#include <ClusteredLights.h>
+#include <ShaderVariants.h>
 
 #define GLM_FORCE_RADIANS
 #include <glm/glm.hpp>
@@ -18,6 +30,27 @@
 
 namespace rdk {
 
+    typedef std::function<void(StreamedTextureId)> StreamedTextureCallback;
+
+    struct DecodedTexture final {
+        std::string filepath;
+        KtxTexture source;
+        // set when decoded file replaces contents of already streamed texture
+        StreamedTextureId replaceId = NONE_STREAMED_TEXTURE;
+        StreamedTextureCallback onReady;
+    };
+
+    struct Texture2D final {
+        Image image;
+        ImageView view;
+        ImageSampler sampler;
+        // source file, used for hot reload
+        std::string filepath;
+    };
+
+    typedef Handle<Texture2D> TextureHandle;
+    typedef Handle<ComputePipeline> ComputePipelineHandle;
+
     struct Vertex final {
         glm::vec3 position;
         glm::vec3 color;
@@ -75,6 +108,12 @@ namespace rdk {
 
     class RenderListener {
     public:
+        // recorded into frame command buffer before render pass begins, so dispatches may feed draws of the frame
+        virtual void onCompute(float dt) {}
+        // recorded into compute queue buffer and submitted before graphics work of the frame is recorded.
+        // Runs alongside rendering of previous frames, graphics of this frame waits for it.
+        // Images used here must be owned by compute family, storage buffers from createStorageBuffer() are shared.
+        virtual void onAsyncCompute(float dt) {}
         virtual void onRender(float dt) = 0;
         virtual void onRenderUI(float dt) = 0;
     };
@@ -91,7 +130,26 @@ namespace rdk {
         void update();
 
         void drawVertices(u32 vertexCount, u32 instanceCount);
-        void drawIndices(u32 indexCount, u32 instanceCount);
+        void drawIndices(u32 indexCount, u32 instanceCount, u32 firstIndex = 0);
+        void drawLod(const LodObject& object, u32 instanceCount = 1);
+        // deferred until onRender() returns, then sorted by key, see DrawKey. Null handles of state
+        // stand for default pipeline, frame descriptor set and mesh buffers.
+        void drawSorted(u64 key, u32 indexCount, u32 instanceCount = 1, u32 firstIndex = 0, const DrawState& state = {});
+        void drawLodSorted(u64 key, const LodObject& object, u32 instanceCount = 1, const DrawState& state = {});
+        // bind and draw counts of the last frame's sorted draws
+        [[nodiscard]] inline const DrawStats& getDrawStats() const { return m_DrawList.getStats(); }
+        // objects drawn every frame after onRender() with default pipeline and mesh buffers, those hidden behind
+        // depth of objects visible in previous frame are culled on GPU. Spheres are transformed by
+        // proj * view * model of the latest updateMVP(). Replaces previous objects.
+        void setCullObjects(const std::vector<CullObject>& objects);
+
+        // lights are binned into view space clusters on GPU every frame, fragments shade only lights of their cluster.
+        // Lights set up to RenderListener::onCompute() are used by the same frame. Replaces previous lights.
+        inline void setLights(const std::vector<PointLight>& lights) { m_ClusteredLights.setLights(lights.data(), lights.size()); }
+        // share of base color kept without lights, 1 by default
+        inline void setAmbientLight(float ambient) { m_ClusteredLights.setAmbient(ambient); }
+        // near and far planes of projection written into MVP, when it differs from updateMVP() one
+        inline void setLightDepthRange(float zNear, float zFar) { m_ClusteredLights.setDepthRange(zNear, zFar); }
 
         void onFrameBufferResized(int width, int height);
 
@@ -101,14 +159,79 @@ namespace rdk {
         void createIndexBuffer(const IndexData& indexData);
         void createUniformBuffers(VkDeviceSize size);
 
-        void addShader(const std::string& vertFilepath, const std::string& fragFilepath);
+        // maps pack once, shaders and textures present in it are read from mapping instead of loose files
+        void mountAssetPack(const char* filepath);
+        // features are toggled by bits of setShaderFeatures() mask, in declaration order
+        void addShader(const std::string& vertFilepath, const std::string& fragFilepath, const std::vector<ShaderFeature>& features = {});
+        // rebuilds default pipeline from variant of its shader, previous pipeline is kept when variant fails.
+        // Variant modules and pipeline stages are cached, so switching back and forth doesn't recompile.
+        void setShaderFeatures(u32 features);
+        [[nodiscard]] inline u32 getShaderFeatures() const { return m_ShaderFeatures; }
 
         void createRect();
 
+        // builds LOD chain of the mesh, all levels share uploaded vertex buffer and single index buffer
+        const LodChain& createLodMesh(const VertexData& vertexData, const IndexData& indexData, const LodSettings& settings = {});
+        void selectLods(LodObject* objects, size_t count, const LodView& view);
+
         MVP createMVP(float aspect);
         void updateMVP(MVP& mvp);
 
-        void createTexture2D(const char* filepath);
+        // .ktx2 files are uploaded as is with their precomputed mips, other images are decoded with stb
+        TextureHandle createTexture2D(const char* filepath);
+        // decodes files concurrently straight into one mapped stage buffer and uploads them with single submission
+        std::vector<TextureHandle> createTextures2D(const std::vector<const char*>& filepaths);
+        // throws on stale handle. Memory is released once frames in flight are done with it
+        void destroyTexture2D(TextureHandle handle);
+        // first created texture is bound by default
+        void bindTexture2D(TextureHandle handle);
+        // compresses image into KTX2 using the best block format supported by device
+        void cookTexture2D(const char* srcFilepath, const char* dstFilepath, bool srgb = true);
+        // filter of mips generated on GPU for textures created afterwards
+        inline void setMipFilter(MipFilter filter) { m_MipFilter = filter; }
+
+        // scene resolution follows GPU time of scene pass within settings bounds, UI stays at native resolution.
+        // Waits for device idle, so it's meant for settings changes, not per frame calls.
+        inline void setDynamicResolution(const DynamicResolutionSettings& settings) { m_CommandPool.setDynamicResolution(settings); }
+        [[nodiscard]] inline const DynamicResolution& getDynamicResolution() const { return m_CommandPool.getDynamicResolution(); }
+
+        // only the mip tail is uploaded right away, higher mips stream in within per frame upload budget
+        StreamedTextureId streamTexture2D(const char* filepath);
+        // file is read with async I/O and decoded on workers, so the render thread never waits for it.
+        // onReady runs inside update() once the texture is registered with streamer.
+        void streamTexture2DAsync(const char* filepath, StreamedTextureCallback onReady);
+        void requestTextureMip(StreamedTextureId id, u32 mipLevel);
+        // makes fragment sampler binding follow residency changes of streamed texture
+        void bindStreamedTexture2D(StreamedTextureId id);
+
+        // bindings are created with Pipeline::createBinding() and COMPUTE_* binding types
+        ComputePipelineHandle createComputePipeline(
+                const std::string& filepath,
+                const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+                u32 pushConstantSize = 0
+        );
+        // throws on stale handle, sets allocated for pipeline must be destroyed as well
+        void destroyComputePipeline(ComputePipelineHandle handle);
+        VkDescriptorSet createComputeSet(ComputePipelineHandle handle);
+        void destroyComputeSet(VkDescriptorSet descriptorSet);
+        void writeStorageBuffer(VkDescriptorSet descriptorSet, u32 binding, VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+        void writeUniformBuffer(VkDescriptorSet descriptorSet, u32 binding, VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+        // image must be in VK_IMAGE_LAYOUT_GENERAL while dispatch accesses it
+        void writeStorageImage(VkDescriptorSet descriptorSet, u32 binding, VkImageView view);
+        // device local, usage adds to VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, e.g. vertex, indirect or transfer usage
+        Buffer createStorageBuffer(VkDeviceSize size, VkBufferUsageFlags usage = 0);
+        // memory is released once frames in flight are done with it
+        void destroyStorageBuffer(const Buffer& buffer);
+
+        // valid only inside RenderListener::onCompute() and RenderListener::onAsyncCompute()
+        void pushComputeConstants(ComputePipelineHandle handle, const void* data, u32 size);
+        void dispatch(ComputePipelineHandle handle, VkDescriptorSet descriptorSet, u32 groupCountX, u32 groupCountY = 1, u32 groupCountZ = 1);
+        void dispatchIndirect(ComputePipelineHandle handle, VkDescriptorSet descriptorSet, VkBuffer buffer, VkDeviceSize offset = 0);
+        // makes compute writes visible to later dispatches or to draws of the frame
+        void computeBarrier(
+                VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VkAccessFlags dstAccess = VK_ACCESS_SHADER_READ_BIT
+        );
 
     private:
         void createSurface();
@@ -117,6 +240,43 @@ namespace rdk {
         void createUI();
         void destroyUI();
 
+        void watchAsset(const std::string& filepath);
+
+        Texture2D loadTexture2D(const char* filepath);
+        Texture2D createTexture2DKtx(const KtxTexture& texture);
+        void createTextureViewSampler(Texture2D& texture, VkFormat format, u32 mipLevels);
+        TextureHandle addTexture2D(Texture2D&& texture);
+
+        void writeSamplerDescriptor(VkDescriptorSet descriptorSet, VkImageView imageView, VkSampler sampler);
+        void updateStreamedDescriptor();
+        void updateTextureDescriptor();
+
+        void readStreamedTexture(const std::string& filepath, StreamedTextureId replaceId, StreamedTextureCallback onReady);
+        void decodeStreamedTexture(
+                const std::string& filepath,
+                StreamedTextureId replaceId,
+                AssetBlob&& blob,
+                StreamedTextureCallback&& onReady
+        );
+        void finishAsyncLoad(DecodedTexture* texture);
+        void registerDecodedTextures();
+        void trackStreamedTexture(StreamedTextureId id, const std::string& filepath);
+
+        // picks up changed files at frame boundary, after the frame slot is waited
+        void hotReload();
+        void reloadShaders(const std::string& filepath);
+        void reloadComputeShaders(const std::string& filepath);
+        void reloadTexture2D(TextureHandle handle);
+        // texture may still be sampled by frames in flight, so it goes through deletion queue
+        void releaseTexture2D(Texture2D&& texture);
+
+        ComputePipeline& getComputePipeline(ComputePipelineHandle handle);
+
+        void submitDrawList();
+        DepthTarget getSceneDepth();
+        // early phase draws, Hi-Z pyramid build from their depth, late phase cull and draws
+        void drawCulled();
+
     public:
         RenderListener* listener = nullptr;
 
@@ -131,26 +291,57 @@ namespace rdk {
         // commands and pipeline
         CommandPool m_CommandPool;
         Pipeline m_Pipeline;
-        SwapChain* m_SwapChain;
+        LayoutCache m_LayoutCache;
+        SwapChain* m_SwapChain = nullptr;
         // descriptors
         DescriptorPool m_DescriptorPool;
         // buffer objects
         Buffer m_VertexBuffer;
         Buffer m_IndexBuffer;
+        LodChain m_LodChain;
+        DrawList m_DrawList;
+        OcclusionCuller m_OcclusionCuller;
+        ClusteredLights m_ClusteredLights;
+        glm::mat4 m_CullMatrix{1.0f};
         std::vector<Buffer> m_UniformBuffers;
         std::vector<void*> m_UniformBufferBlocks;
         // shaders
-        std::shared_ptr<std::vector<Shader>> m_Shaders;
+        std::shared_ptr<std::vector<ShaderVariants>> m_Shaders;
+        // shader which m_Pipeline is built from and features of its variant
+        u32 m_PipelineShader = 0;
+        u32 m_ShaderFeatures = 0;
+        // compute
+        SlotMap<ComputePipeline> m_ComputePipelines;
+        DescriptorPool m_ComputeDescriptorPool;
         // timing
         float m_DeltaTime = 0;
         std::chrono::time_point<std::chrono::steady_clock> m_BeginTime;
         // images
-        std::vector<Image> m_Images;
-        std::vector<ImageView> m_ImageViews;
-        std::vector<ImageSampler> m_ImageSamplers;
+        SlotMap<Texture2D> m_Textures;
+        MipGenerator m_MipGenerator;
+        MipFilter m_MipFilter = MipFilter::BOX;
+        TextureHandle m_BoundTexture;
+        std::vector<bool> m_TextureDescriptorDirty;
+        // streaming
+        TextureStreamer m_TextureStreamer;
+        StreamedTextureId m_BoundStreamedTexture = NONE_STREAMED_TEXTURE;
+        std::vector<u64> m_StreamedDescriptorVersions;
+        std::vector<std::string> m_StreamedFilepaths;
+        // hot reload
+        FileWatcher m_FileWatcher;
+        // assets
+        AssetPack m_AssetPack;
+        // workers
+        ThreadPool m_ThreadPool;
+        AsyncFileSystem m_FileSystem;
+        std::mutex m_AsyncMutex;
+        std::condition_variable m_AsyncFinished;
+        std::vector<DecodedTexture> m_DecodedTextures;
+        u32 m_AsyncLoads = 0;
         // queue
         Queue m_Queue;
-        RenderPass* m_RenderPass;
+        // null with dynamic rendering
+        RenderPass* m_RenderPass = nullptr;
         // IMGUI
 #ifdef IMGUI
         VkDescriptorPool m_ImguiPool;
@@ -1,19 +1,59 @@
 #pragma once
 
 #include <Buffer.h>
+#include <AssetPack.h>
+#include <ShaderReflection.h>
 
 #include <string>
+#include <vector>
 
 namespace rdk {
 
+    enum class ShaderOptimization {
+        NONE,
+        // favours smaller modules over faster ones
+        SIZE,
+        PERFORMANCE
+    };
+
+    // applied to every shader compiled afterwards, graphics and compute ones
+    struct ShaderCompileSettings final {
+        // spirv-opt recipe run by shaderc: dead code elimination, inlining, scalar replacement and the like
+        ShaderOptimization optimization = ShaderOptimization::PERFORMANCE;
+        // debugInfo - source and line info for graphics debuggers, stripped from module otherwise
+        // validate - spirv-val of every module, compile fails on invalid one
+        // logStats - bytes and instructions before and after optimization, costs one unoptimized compile
+#ifdef DEBUG
+        bool debugInfo = true;
+        bool validate = true;
+        bool logStats = true;
+#else
+        bool debugInfo = false;
+        bool validate = false;
+        bool logStats = false;
+#endif
+    };
+
     class Shader final {
 
     public:
         Shader() = default;
-        Shader(VkDevice logicalDevice, const std::string& vertFilepath, const std::string& fragFilepath);
+        // sources are taken from asset pack when it has them, loose files otherwise.
+        // Every define is passed to both stages as if declared with #define before their source.
+        Shader(VkDevice logicalDevice, const std::string& vertFilepath, const std::string& fragFilepath,
+               const AssetPack* assetPack = nullptr, const std::vector<std::string>& defines = {});
         ~Shader();
 
+        // owns shader modules, so it's move only
+        Shader(const Shader&) = delete;
+        Shader& operator=(const Shader&) = delete;
+        Shader(Shader&& other) noexcept;
+        Shader& operator=(Shader&& other) noexcept;
+
     public:
+        static void setCompileSettings(const ShaderCompileSettings& settings);
+        static const ShaderCompileSettings& getCompileSettings();
+
         inline const VkPipelineShaderStageCreateInfo& getVertStage() const {
             return m_VertStage;
         }
@@ -26,17 +66,71 @@ namespace rdk {
             return { m_VertStage, m_FragStage };
         }
 
+        [[nodiscard]] inline const std::string& getVertFilepath() const { return m_VertFilepath; }
+        [[nodiscard]] inline const std::string& getFragFilepath() const { return m_FragFilepath; }
+
+        // resources of both stages, reflected from their SPIR-V
+        [[nodiscard]] inline const ShaderLayout& getLayout() const { return m_Layout; }
+        // false when stages declare resources which can't be mapped into Vulkan layouts
+        [[nodiscard]] inline bool isReflected() const { return m_Reflected; }
+
+        // recompiles single stage from its source. On compile errors old module is kept and false is returned,
+        // the same when reflected layout has changed, because pipelines keep layout they were created with.
+        // Old module is destroyed right away, pipelines already created from it don't need it anymore.
+        bool reload(VkShaderStageFlagBits stage);
+
     private:
         void cleanup();
+        bool mergeLayouts(ShaderLayout* layout) const;
 
     private:
-        VkDevice m_LogicalDevice;
+        VkDevice m_LogicalDevice = VK_NULL_HANDLE;
+        const AssetPack* m_AssetPack = nullptr;
+        std::string m_VertFilepath;
+        std::string m_FragFilepath;
+        std::vector<std::string> m_Defines;
+
+        ShaderLayout m_VertLayout;
+        ShaderLayout m_FragLayout;
+        ShaderLayout m_Layout;
+        bool m_Reflected = false;
 
         VkPipelineShaderStageCreateInfo m_VertStage{};
-        VkShaderModule m_VertModule;
+        VkShaderModule m_VertModule = VK_NULL_HANDLE;
 
         VkPipelineShaderStageCreateInfo m_FragStage{};
-        VkShaderModule m_FragModule;
+        VkShaderModule m_FragModule = VK_NULL_HANDLE;
+    };
+
+    class ComputeShader final {
+
+    public:
+        ComputeShader() = default;
+        ComputeShader(VkDevice logicalDevice, const std::string& filepath, const AssetPack* assetPack = nullptr);
+        ~ComputeShader();
+
+        ComputeShader(const ComputeShader&) = delete;
+        ComputeShader& operator=(const ComputeShader&) = delete;
+        ComputeShader(ComputeShader&& other) noexcept;
+        ComputeShader& operator=(ComputeShader&& other) noexcept;
+
+    public:
+        [[nodiscard]] inline const VkPipelineShaderStageCreateInfo& getStage() const { return m_Stage; }
+        [[nodiscard]] inline const std::string& getFilepath() const { return m_Filepath; }
+
+        // same as Shader::reload()
+        bool reload();
+
+    private:
+        void cleanup();
+
+    private:
+        VkDevice m_LogicalDevice = VK_NULL_HANDLE;
+        const AssetPack* m_AssetPack = nullptr;
+        std::string m_Filepath;
+
+        VkPipelineShaderStageCreateInfo m_Stage{};
+        VkShaderModule m_Module = VK_NULL_HANDLE;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Core.h>
+
+#include <vector>
+
+namespace rdk {
+
+    // resource interface of shader stages, as declared in their SPIR-V
+    struct ShaderLayout final {
+        // bindings of every descriptor set, set index is position in outer vector. Sorted by binding,
+        // resource used by several stages is single binding with their stage flags combined.
+        std::vector<std::vector<VkDescriptorSetLayoutBinding>> sets;
+        std::vector<VkPushConstantRange> pushConstants;
+        // vertex stage inputs, tightly packed into binding 0 in location order
+        std::vector<VkVertexInputAttributeDescription> vertexAttributes;
+        u32 vertexStride = 0;
+
+        // adds resources of other stages, same binding must have the same type in both
+        bool merge(const ShaderLayout& other);
+
+        // pool sizes for maxSets copies of the given set
+        [[nodiscard]] std::vector<VkDescriptorPoolSize> getPoolSizes(u32 set, u32 maxSets) const;
+
+        bool operator==(const ShaderLayout& other) const;
+        inline bool operator!=(const ShaderLayout& other) const { return !(*this == other); }
+    };
+
+    class ShaderReflection final {
+
+    public:
+        // layout of single stage, false with message in std::cerr when SPIR-V has resources without Vulkan mapping
+        static bool reflect(const std::vector<u32>& spirv, VkShaderStageFlagBits stage, ShaderLayout* layout);
+    };
+
+}
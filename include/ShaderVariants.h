@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Shader.h>
+
+#include <unordered_map>
+
+namespace rdk {
+
+    struct ShaderFeature final {
+        std::string name;
+        // compiled in with #define of the name, for features which change resources or stage interface.
+        // Otherwise feature is bool specialization constant with constant_id of its bit, which is cheap to toggle.
+        bool define = false;
+    };
+
+    // permutations of single vertex and fragment shader pair, bit i of feature mask toggles feature i.
+    // Variants which differ in specialization features only share modules and differ in pipeline specialization.
+    class ShaderVariants final {
+
+    public:
+        static const u32 MAX_FEATURES = 32;
+
+        ShaderVariants() = default;
+        // base variant without features is compiled right away
+        ShaderVariants(
+                VkDevice logicalDevice,
+                const std::string& vertFilepath,
+                const std::string& fragFilepath,
+                const std::vector<ShaderFeature>& features = {},
+                const AssetPack* assetPack = nullptr
+        );
+
+    public:
+        [[nodiscard]] inline const std::string& getVertFilepath() const { return m_VertFilepath; }
+        [[nodiscard]] inline const std::string& getFragFilepath() const { return m_FragFilepath; }
+        [[nodiscard]] inline const std::vector<ShaderFeature>& getFeatures() const { return m_Features; }
+        [[nodiscard]] inline size_t getVariantCount() const { return m_Variants.size(); }
+
+        // bits of features compiled as defines
+        [[nodiscard]] u32 getDefineMask() const;
+
+        // modules of variant, compiled on first request of its define features. Throws on compile errors.
+        Shader& get(u32 features);
+
+        // specialization constants of features, see ShaderFeature::define
+        void getSpecialization(u32 features, std::vector<VkSpecializationMapEntry>* entries, std::vector<VkBool32>* data) const;
+
+        // recompiles stage of every compiled variant, same as Shader::reload()
+        bool reload(VkShaderStageFlagBits stage);
+
+    private:
+        VkDevice m_LogicalDevice = VK_NULL_HANDLE;
+        const AssetPack* m_AssetPack = nullptr;
+        std::string m_VertFilepath;
+        std::string m_FragFilepath;
+        std::vector<ShaderFeature> m_Features;
+        // keyed by define bits only
+        std::unordered_map<u32, Shader> m_Variants;
+    };
+
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <Core.h>
+
+#include <vector>
+#include <stdexcept>
+#include <utility>
+
+namespace rdk {
+
+    // slot index plus generation of the slot at insertion time.
+    // Slot generation is bumped on removal, so stale handles never resolve to a newer value.
+    template<typename T>
+    struct Handle final {
+        u32 index = UINT32_MAX;
+        u32 generation = 0;
+
+        [[nodiscard]] inline bool isValid() const { return index != UINT32_MAX; }
+
+        inline bool operator==(const Handle& other) const {
+            return index == other.index && generation == other.generation;
+        }
+
+        inline bool operator!=(const Handle& other) const {
+            return !(*this == other);
+        }
+    };
+
+    // values live packed in one array, slots map handles to array positions.
+    // Insertion, lookup and removal are O(1), removal moves last value into the hole.
+    // Pointers and references to values are invalidated by insertion and removal, handles are not.
+    template<typename T>
+    class SlotMap final {
+
+    public:
+        template<typename... Args>
+        Handle<T> emplace(Args&&... args);
+        // moves value out, so caller decides when it's destroyed
+        T remove(Handle<T> handle);
+        void clear();
+
+        [[nodiscard]] bool contains(Handle<T> handle) const;
+        // nullptr for stale or invalid handle
+        T* get(Handle<T> handle);
+        const T* get(Handle<T> handle) const;
+
+        // handle of value at packed position, for iteration
+        [[nodiscard]] Handle<T> getHandle(size_t position) const;
+
+        [[nodiscard]] inline size_t size() const { return m_Values.size(); }
+        [[nodiscard]] inline bool empty() const { return m_Values.empty(); }
+
+        inline typename std::vector<T>::iterator begin() { return m_Values.begin(); }
+        inline typename std::vector<T>::iterator end() { return m_Values.end(); }
+        inline typename std::vector<T>::const_iterator begin() const { return m_Values.begin(); }
+        inline typename std::vector<T>::const_iterator end() const { return m_Values.end(); }
+
+    private:
+        struct Slot final {
+            // position in m_Values while used, next free slot while free
+            u32 value = UINT32_MAX;
+            u32 generation = 0;
+        };
+
+        void freeSlot(u32 index);
+
+    private:
+        std::vector<T> m_Values;
+        // position in m_Values -> slot
+        std::vector<u32> m_ValueSlots;
+        std::vector<Slot> m_Slots;
+        u32 m_FreeSlot = UINT32_MAX;
+    };
+
+    template<typename T>
+    template<typename... Args>
+    Handle<T> SlotMap<T>::emplace(Args&&... args) {
+        u32 index = m_FreeSlot;
+        if (index == UINT32_MAX) {
+            index = static_cast<u32>(m_Slots.size());
+            m_Slots.emplace_back();
+        } else {
+            m_FreeSlot = m_Slots[index].value;
+        }
+
+        Slot& slot = m_Slots[index];
+        slot.value = static_cast<u32>(m_Values.size());
+        m_Values.emplace_back(std::forward<Args>(args)...);
+        m_ValueSlots.emplace_back(index);
+
+        return { index, slot.generation };
+    }
+
+    template<typename T>
+    T SlotMap<T>::remove(Handle<T> handle) {
+        if (!contains(handle)) {
+            throw std::runtime_error("SlotMap::remove: stale handle!");
+        }
+
+        u32 position = m_Slots[handle.index].value;
+        u32 last = static_cast<u32>(m_Values.size() - 1);
+        T value = std::move(m_Values[position]);
+
+        if (position != last) {
+            m_Values[position] = std::move(m_Values[last]);
+            m_ValueSlots[position] = m_ValueSlots[last];
+            m_Slots[m_ValueSlots[position]].value = position;
+        }
+        m_Values.pop_back();
+        m_ValueSlots.pop_back();
+
+        freeSlot(handle.index);
+        return value;
+    }
+
+    template<typename T>
+    void SlotMap<T>::clear() {
+        for (u32 index : m_ValueSlots) {
+            freeSlot(index);
+        }
+        m_Values.clear();
+        m_ValueSlots.clear();
+    }
+
+    template<typename T>
+    void SlotMap<T>::freeSlot(u32 index) {
+        Slot& slot = m_Slots[index];
+        slot.generation++;
+        slot.value = m_FreeSlot;
+        m_FreeSlot = index;
+    }
+
+    template<typename T>
+    bool SlotMap<T>::contains(Handle<T> handle) const {
+        // freed slots always have newer generation than any handle issued for them
+        return handle.index < m_Slots.size() && m_Slots[handle.index].generation == handle.generation;
+    }
+
+    template<typename T>
+    T* SlotMap<T>::get(Handle<T> handle) {
+        return contains(handle) ? &m_Values[m_Slots[handle.index].value] : nullptr;
+    }
+
+    template<typename T>
+    const T* SlotMap<T>::get(Handle<T> handle) const {
+        return contains(handle) ? &m_Values[m_Slots[handle.index].value] : nullptr;
+    }
+
+    template<typename T>
+    Handle<T> SlotMap<T>::getHandle(size_t position) const {
+        u32 index = m_ValueSlots[position];
+        return { index, m_Slots[index].generation };
+    }
+
+}
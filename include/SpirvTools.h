@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Core.h>
+
+#include <vector>
+
+namespace rdk {
+
+    struct SpirvStats final {
+        size_t bytes = 0;
+        u32 instructions = 0;
+    };
+
+    // post-compile steps over SPIR-V words, validation comes from SPIRV-Tools
+    class SpirvTools final {
+
+    public:
+        static SpirvStats getStats(const std::vector<u32>& spirv);
+
+        // removes source text, names and line info, none of them affect the driver.
+        // Strings stay when module imports non-semantic instructions, which may reference them.
+        static void stripDebugInfo(std::vector<u32>& spirv);
+
+        // spirv-val against Vulkan 1.1 rules, errors go to std::cerr
+        static bool validate(const std::vector<u32>& spirv, const char* name);
+    };
+
+}
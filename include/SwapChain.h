@@ -4,6 +4,7 @@
 #include <FrameBuffer.h>
 #include <Queues.h>
 #include <Image.h>
+#include <DeletionQueue.h>
 
 #include <vector>
 
@@ -35,24 +36,76 @@ namespace rdk {
             return m_Extent;
         }
 
+        // with dynamic rendering there are no render passes and frame buffers,
+        // passes begin on image views and rebuilding swap chain recreates views only
+        [[nodiscard]] inline bool isDynamicRendering() const {
+            return m_Device->isDynamicRendering();
+        }
+
+        [[nodiscard]] inline const Device& getDevice() const {
+            return *m_Device;
+        }
+
         [[nodiscard]] inline RenderPass& getRenderPass() {
             return *m_RenderPass;
         }
 
+        // continues suspended swap chain pass with color and depth loaded, compatible with swap chain pass
+        [[nodiscard]] inline RenderPass& getResumeRenderPass() {
+            return *m_ResumeRenderPass;
+        }
+
         [[nodiscard]] inline VkFramebuffer getFrameBuffer(u32 imageIndex) {
             return m_FrameBuffers[imageIndex].getHandle();
         }
 
+        [[nodiscard]] inline VkImage getImage(u32 imageIndex) const {
+            return m_Images[imageIndex];
+        }
+
+        [[nodiscard]] inline VkImageView getImageView(u32 imageIndex) const {
+            return m_ImageViews[imageIndex].getHandle();
+        }
+
+        // swap chain color and depth attachments of the given image, for dynamic rendering
+        [[nodiscard]] RenderingTarget getRenderingTarget(u32 imageIndex) const;
+
+        [[nodiscard]] inline VkFormat getColorFormat() const {
+            return m_ColorFormat;
+        }
+
+        // color attachment, plus transfer destination when surface supports it
+        [[nodiscard]] inline VkImageUsageFlags getImageUsage() const {
+            return m_ImageUsage;
+        }
+
         [[nodiscard]] inline VkImage getDepthImage() const {
             return m_DepthImage->getHandle();
         }
 
+        [[nodiscard]] inline VkImageView getDepthView() const {
+            return m_DepthImageView->getHandle();
+        }
+
         [[nodiscard]] inline VkFormat getDepthFormat() const {
             return m_DepthFormat;
         }
 
-        void recreate(void* window, VkSurfaceKHR surface);
-        void recreate(void* window, VkSurfaceKHR surface, const QueueFamilyIndices& familyIndices);
+        // swap chain pass, depth is stored only while something reads it after the pass
+        [[nodiscard]] RenderPassInfo getRenderPassInfo() const;
+
+        [[nodiscard]] inline bool isDepthStored() const {
+            return m_DepthStored;
+        }
+
+        // depth that isn't stored is transient attachment, which may never be backed by memory.
+        // Recreates depth image, render passes and frame buffers, device must be idle.
+        void setDepthStored(bool stored);
+
+        // new swap chain is created from the old one, which may still be presenting.
+        // Old swap chain, its views, frame buffers and depth image are retired through deletion queue,
+        // so frames in flight keep them alive without device wait.
+        void recreate(void* window, VkSurfaceKHR surface, DeletionQueue& deletionQueue);
 
     public:
         static SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface);
@@ -65,22 +118,27 @@ namespace rdk {
         void create(void* window, VkSurfaceKHR surface);
         void createColorImages();
         void createDepthImage();
+        void createRenderPasses();
+        void destroyRenderPasses();
         void createFrameBuffers();
 
     private:
-        VkSwapchainKHR m_Handle;
+        VkSwapchainKHR m_Handle = VK_NULL_HANDLE;
         Device* m_Device;
         VkExtent2D m_Extent;
         // color images
         VkFormat m_ColorFormat;
+        VkImageUsageFlags m_ImageUsage;
         std::vector<VkImage> m_Images;
         std::vector<ImageView> m_ImageViews;
         // depth image
         VkFormat m_DepthFormat;
+        bool m_DepthStored = true;
         Image* m_DepthImage;
         ImageView* m_DepthImageView;
         // render pass and frame buffers
-        RenderPass* m_RenderPass;
+        RenderPass* m_RenderPass = nullptr;
+        RenderPass* m_ResumeRenderPass = nullptr;
         std::vector<FrameBuffer> m_FrameBuffers;
     };
 }
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Ktx.h>
+#include <BlockCompression.h>
+
+namespace rdk {
+
+    struct CookSettings final {
+        BlockFormat format = BlockFormat::BC7;
+        // color data, mips are filtered in linear space and the result is sampled as sRGB
+        bool srgb = true;
+        bool mipmaps = true;
+    };
+
+    // offline/cook time conversion of RGBA8 images into block compressed KTX2 textures
+    class TextureCooker final {
+
+    public:
+        static KtxTexture cook(
+                const u8* rgba, u32 width, u32 height,
+                const CookSettings& settings = {},
+                ThreadPool* threadPool = nullptr
+        );
+
+        static void cook(
+                const char* srcFilepath, const char* dstFilepath,
+                const CookSettings& settings = {},
+                ThreadPool* threadPool = nullptr
+        );
+
+        // full chain of uncompressed RGBA8 mips, used where block compression is not wanted at load time
+        static KtxTexture mipChain(const u8* rgba, u32 width, u32 height, bool srgb = true);
+
+        // 2x2 box filter, gamma correct when srgb is set. Alpha is always filtered linearly.
+        static std::vector<u8> downsample(const u8* rgba, u32 width, u32 height, bool srgb);
+    };
+
+}
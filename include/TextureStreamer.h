@@ -0,0 +1,118 @@
+#pragma once
+
+#include <Image.h>
+#include <DeletionQueue.h>
+#include <Timeline.h>
+#include <Queues.h>
+#include <Ktx.h>
+#include <AssetPack.h>
+
+#include <memory>
+#include <vector>
+
+namespace rdk {
+
+    typedef u32 StreamedTextureId;
+
+    static const StreamedTextureId NONE_STREAMED_TEXTURE = UINT32_MAX;
+
+    struct StreamingSettings final {
+        // bytes uploaded into textures per frame, a single level larger than budget is still uploaded alone
+        VkDeviceSize uploadBudget = 4 * 1024 * 1024;
+        // device memory all streamed textures may occupy, 0 means no limit
+        VkDeviceSize memoryBudget = 0;
+        // smallest mips uploaded on creation, so texture is usable from the first frame
+        u32 tailLevels = 4;
+        // frames without request() after which all levels above the tail become eviction candidates
+        u32 evictionDelay = 120;
+    };
+
+    // texture with CPU copy of every mip, of which only [allocatedLevel, levels) live on device
+    // and [residentLevel, levels) are uploaded. Sampler minLod hides allocated but not yet uploaded levels.
+    struct StreamedTexture final {
+        KtxTexture source;
+        std::unique_ptr<Image> image;
+        std::unique_ptr<ImageView> view;
+        u32 allocatedLevel = 0;
+        u32 residentLevel = 0;
+        u32 requestedLevel = 0;
+        u64 lastRequestFrame = 0;
+        // bumped on every view or sampler change, so descriptor sets know when to be rewritten
+        u64 version = 0;
+    };
+
+    struct StreamingFrame final {
+        VkCommandBuffer commandBuffer;
+        // timeline value of the last submission of this slot
+        u64 value = 0;
+        Buffer stageBuffer;
+        u8* stageMemory = nullptr;
+        VkDeviceSize stageCapacity = 0;
+        VkDeviceSize stageOffset = 0;
+        bool acquired = false;
+        bool recording = false;
+    };
+
+    class TextureStreamer final {
+
+    public:
+        void create(Device* device, Queue* queue, Timeline* timeline, u32 framesInFlight, const StreamingSettings& settings = {});
+        void destroy();
+
+        // .ktx2 files keep their precomputed mips, other images get RGBA8 mips generated on CPU
+        StreamedTextureId createTexture2D(const char* filepath, const AssetPack* assetPack = nullptr);
+        // registers texture decoded with decodeTexture2D, e.g. on a worker
+        StreamedTextureId addTexture2D(KtxTexture&& source);
+        // swaps contents of existing texture, e.g. on hot reload. Id stays valid, version changes.
+        void replaceTexture2D(StreamedTextureId id, KtxTexture&& source);
+        // encoded file bytes -> mip chain, filepath only selects the decoder. Thread safe.
+        static KtxTexture decodeTexture2D(const char* filepath, const u8* data, size_t size);
+        // mipLevel is the most detailed level caller needs, also marks texture as used in this frame
+        void request(StreamedTextureId id, u32 mipLevel = 0);
+
+        // must be called once per frame after the frame slot is waited,
+        // uploads are submitted to graphics queue ahead of the frame which samples them
+        void update();
+
+        [[nodiscard]] inline VkImageView getView(StreamedTextureId id) const { return m_Textures[id].view->getHandle(); }
+        [[nodiscard]] inline u64 getVersion(StreamedTextureId id) const { return m_Textures[id].version; }
+        [[nodiscard]] inline u32 getResidentLevel(StreamedTextureId id) const { return m_Textures[id].residentLevel; }
+        [[nodiscard]] inline VkDeviceSize getAllocatedBytes() const { return m_AllocatedBytes; }
+
+        VkSampler getSampler(StreamedTextureId id);
+
+    private:
+        void checkFormat(VkFormat format) const;
+
+        StreamingFrame& beginCommands();
+        u8* allocateStage(VkDeviceSize size, VkDeviceSize* offset);
+
+        void reallocate(StreamedTexture& texture, u32 level);
+        // previous frames may still sample texture image, it's released once timeline reaches streaming submission of this frame
+        void retire(StreamedTexture& texture);
+        void uploadLevels(StreamedTexture& texture, u32 firstLevel, u32 lastLevel);
+
+        void evict();
+        void stream();
+
+        VkSampler getClampSampler(u32 minLod);
+
+        static VkDeviceSize levelBytes(const StreamedTexture& texture, u32 firstLevel);
+
+    private:
+        Device* m_Device = nullptr;
+        Queue* m_Queue = nullptr;
+        // shared with frame rendering, both submit to graphics queue
+        Timeline* m_Timeline = nullptr;
+        VkCommandPool m_CommandPool;
+        StreamingSettings m_Settings;
+        std::vector<StreamingFrame> m_Frames;
+        DeletionQueue m_DeletionQueue;
+        std::vector<StreamedTexture> m_Textures;
+        // one sampler per minLod clamp, shared by all textures
+        std::vector<std::unique_ptr<ImageSampler>> m_Samplers;
+        VkDeviceSize m_AllocatedBytes = 0;
+        u64 m_Frame = 0;
+    };
+
+}
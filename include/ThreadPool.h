@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Core.h>
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace rdk {
+
+    class ThreadPool final {
+
+    public:
+        explicit ThreadPool(u32 threadCount = std::thread::hardware_concurrency());
+        ~ThreadPool();
+
+    public:
+        [[nodiscard]] inline u32 getThreadCount() const {
+            return static_cast<u32>(m_Threads.size());
+        }
+
+        template<typename F>
+        std::future<typename std::result_of<F()>::type> submit(F&& task);
+
+        // splits [0, count) into chunks of grainSize and runs body(begin, end) on workers.
+        // Calling thread takes chunks as well, so it's safe to call from inside a worker.
+        void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body);
+
+    private:
+        void enqueue(std::function<void()>&& task);
+        void run();
+
+    private:
+        std::vector<std::thread> m_Threads;
+        std::queue<std::function<void()>> m_Tasks;
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        bool m_Running = true;
+    };
+
+    template<typename F>
+    std::future<typename std::result_of<F()>::type> ThreadPool::submit(F&& task) {
+        using Result = typename std::result_of<F()>::type;
+        auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packagedTask->get_future();
+        enqueue([packagedTask]() { (*packagedTask)(); });
+        return future;
+    }
+
+}
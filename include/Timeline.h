@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Core.h>
+
+namespace rdk {
+
+    // timeline semaphore of a queue. Every submission through submit() signals the next value,
+    // so any system can wait for or poll completion of work it recorded, without fences or queue idles.
+    // Signal of a value also covers every earlier submission on the same queue.
+    class Timeline final {
+
+    public:
+        void create(VkDevice device);
+        // device must be idle
+        void destroy();
+
+        [[nodiscard]] inline VkSemaphore getHandle() const { return m_Handle; }
+        // value of the latest submission
+        [[nodiscard]] inline u64 getSubmitted() const { return m_Submitted; }
+
+        // appends timeline signal to batch, binary waits and signals of batch are kept. Returns signaled value.
+        u64 submit(VkQueue queue, const VkSubmitInfo& submitInfo, VkFence fence = VK_NULL_HANDLE);
+
+        // latest value reached by GPU, doesn't block
+        u64 poll();
+        bool isComplete(u64 value);
+        void wait(u64 value);
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VkSemaphore m_Handle = VK_NULL_HANDLE;
+        u64 m_Submitted = 0;
+        // cached, so isComplete() of old values doesn't query device
+        u64 m_Completed = 0;
+    };
+
+}
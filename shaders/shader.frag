@@ -2,12 +2,78 @@
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 fragUV;
+layout(location = 2) in vec3 fragViewPosition;
 
 layout(location = 0) out vec4 fragment;
 
+const uvec3 GRID = uvec3(16u, 9u, 24u);
+const uint CLUSTER_COUNT = GRID.x * GRID.y * GRID.z;
+const uint MAX_CLUSTER_LIGHTS = 128u;
+
+// feature bit 0 of Renderer::setShaderFeatures(), unlit variant compiles the light loop away
+layout(constant_id = 0) const bool UNLIT = false;
+
+layout(binding = 0) uniform MVP {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} mvp;
+
 layout(binding = 1) uniform sampler2D textureSampler;
 
+struct PointLight {
+    vec4 position;
+    vec4 color;
+};
+
+layout(std430, binding = 2) readonly buffer Lights {
+    PointLight lights[];
+};
+
+// binned by shaders/cluster.comp
+layout(std430, binding = 3) readonly buffer Clusters {
+    uint lightCounts[CLUSTER_COUNT];
+    uint lightIndices[];
+};
+
+layout(binding = 4) uniform ClusterParams {
+    uvec4 gridLightCount;
+    vec4 screenAmbient;
+    vec4 depthRange;
+} clusterParams;
+
+vec3 shadeLights() {
+    if (UNLIT || clusterParams.gridLightCount.w == 0u)
+        return vec3(0.0);
+
+    float zNear = clusterParams.depthRange.x;
+    float zFar = clusterParams.depthRange.y;
+    float depth = -fragViewPosition.z;
+
+    uvec2 tile = uvec2(gl_FragCoord.xy / clusterParams.screenAmbient.xy * vec2(GRID.xy));
+    uint slice = uint(max(log(depth / zNear) / log(zFar / zNear) * float(GRID.z), 0.0));
+    uvec3 cell = min(uvec3(tile, slice), GRID - 1u);
+    uint cluster = cell.x + GRID.x * (cell.y + GRID.y * cell.z);
+
+    // vertices carry no normals, faceted normal comes from screen space derivatives
+    vec3 normal = normalize(cross(dFdx(fragViewPosition), dFdy(fragViewPosition)));
+
+    vec3 radiance = vec3(0.0);
+    uint count = lightCounts[cluster];
+    uint base = cluster * MAX_CLUSTER_LIGHTS;
+    for (uint i = 0u ; i < count ; i++) {
+        PointLight light = lights[lightIndices[base + i]];
+        vec3 toLight = (mvp.view * vec4(light.position.xyz, 1.0)).xyz - fragViewPosition;
+        float lightDistance = length(toLight);
+        float falloff = clamp(1.0 - (lightDistance * lightDistance) / (light.position.w * light.position.w), 0.0, 1.0);
+        // winding of derived normal depends on projection, so both sides are lit
+        float diffuse = abs(dot(normal, toLight / max(lightDistance, 1e-4)));
+        radiance += light.color.rgb * light.color.w * diffuse * falloff * falloff;
+    }
+    return radiance;
+}
+
 void main() {
     vec3 baseColor = fragColor * texture(textureSampler, fragUV).rgb;
-    fragment = vec4(baseColor, 1.0);
+    fragment = vec4(baseColor * (clusterParams.screenAmbient.w + shadeLights()), 1.0);
 }
\ No newline at end of file
@@ -6,6 +6,7 @@ layout(location = 2) in vec2 uv;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragUV;
+layout(location = 2) out vec3 fragViewPosition;
 
 layout(binding = 0) uniform MVP {
     mat4 model;
@@ -14,7 +15,9 @@ layout(binding = 0) uniform MVP {
 } mvp;
 
 void main() {
-    gl_Position = mvp.proj * mvp.view * mvp.model * vec4(position, 1.0);
+    vec4 viewPosition = mvp.view * mvp.model * vec4(position, 1.0);
+    gl_Position = mvp.proj * viewPosition;
     fragColor = color;
     fragUV = uv;
+    fragViewPosition = viewPosition.xyz;
 }
\ No newline at end of file
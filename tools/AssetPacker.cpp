@@ -0,0 +1,61 @@
+#include <AssetPack.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+
+using namespace rdk;
+
+// packs asset files into single archive, entry names are paths relative to root directory.
+// usage: AssetPacker [--raw] [--align N] [--chunk N] <output.pack> <rootDir> <relative files...>
+int main(int argc, char** argv) {
+    PackCompression compression = PackCompression::LZ4;
+    u32 alignment = 16;
+    u32 chunkSize = AssetPack::DEFAULT_CHUNK_SIZE;
+
+    int arg = 1;
+    for ( ; arg < argc && strncmp(argv[arg], "--", 2) == 0 ; arg++) {
+        if (strcmp(argv[arg], "--raw") == 0) {
+            compression = PackCompression::NONE;
+        } else if (strcmp(argv[arg], "--align") == 0 && arg + 1 < argc) {
+            alignment = static_cast<u32>(strtoul(argv[++arg], nullptr, 10));
+        } else if (strcmp(argv[arg], "--chunk") == 0 && arg + 1 < argc) {
+            chunkSize = static_cast<u32>(strtoul(argv[++arg], nullptr, 10));
+        } else {
+            fprintf(stderr, "AssetPacker: unknown option %s\n", argv[arg]);
+            return 1;
+        }
+    }
+
+    if (argc - arg < 2) {
+        fprintf(stderr, "usage: AssetPacker [--raw] [--align N] [--chunk N] <output.pack> <rootDir> <relative files...>\n");
+        return 1;
+    }
+
+    const char* output = argv[arg++];
+    std::string root = argv[arg++];
+    if (!root.empty() && root.back() != '/' && root.back() != '\\') {
+        root += '/';
+    }
+
+    if (chunkSize == 0) {
+        fprintf(stderr, "AssetPacker: chunk size must be positive\n");
+        return 1;
+    }
+
+    try {
+        AssetPackWriter writer(chunkSize);
+        for ( ; arg < argc ; arg++) {
+            writer.addFile(argv[arg], (root + argv[arg]).c_str(), compression);
+        }
+        writer.save(output, alignment);
+        AssetPack::logStats("AssetPacker: compression per asset type", writer.getStats());
+    } catch (const std::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}